@@ -0,0 +1,68 @@
+/*
+
+ The edge dictionary as a balanced tree against the plain list, on N tall
+ rectangles side by side, so that 2N edges are active at once.
+
+ g++ -std=c++11 -O2 -DNDEBUG -I.. dict.cpp -o dict && ./dict [maxN]
+
+*/
+#include "../tesselator/tesselator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libtess;
+
+typedef TessConfig<Float, 2, LIBTESS_PAGE_SIZE, true, Float, true> TreeConfig;
+typedef TessConfig<Float, 2, LIBTESS_PAGE_SIZE, true, Float, false> ListConfig;
+
+static double Now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Milliseconds of one tesselate() of the rectangles, -1 if it fails.
+ */
+template<typename Config>
+static double Run(const std::vector<Float>& points, size_t& triangles)
+{
+    BasicTesselator<Config> tess;
+    double t0;
+
+    tess.engine = TESS_ENGINE_SWEEP;
+    for (size_t i = 0; i < points.size(); i += 8) {
+        tess.add_contour(2, &points[i], sizeof(Float) * 2, 4);
+    }
+    t0 = Now();
+    if (tess.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES) != LIBTESS_OK) {
+        return -1;
+    }
+    triangles = tess.elements.size() / 3;
+    return Now() - t0;
+}
+
+int main(int argc, char** argv)
+{
+    int maxN = argc > 1 ? atoi(argv[1]) : 16000;
+
+    printf("%8s %12s %12s\n", "N", "list", "tree");
+    for (int n = 1000; n <= maxN; n *= 4) {
+        std::vector<Float> points;
+        for (int i = 0; i < n; ++i) {
+            /* staggered, so the events do not line up */
+            Float d = Float(i * 7919 % 1000) * Float(0.01);
+            Float rect[8] = {
+                Float(2 * i), d, Float(2 * i + 1), d + Float(0.3),
+                Float(2 * i + 1), 100 + d, Float(2 * i), 100 + d + Float(0.7)
+            };
+            points.insert(points.end(), rect, rect + 8);
+        }
+
+        size_t listTriangles = 0, treeTriangles = 0;
+        double list = Run<ListConfig>(points, listTriangles);
+        double tree = Run<TreeConfig>(points, treeTriangles);
+        printf("%8d %9.1f ms %9.1f ms%s\n", n, list, tree, listTriangles == treeTriangles ? "" : "  (outputs differ)");
+    }
+    return 0;
+}
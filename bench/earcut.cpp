@@ -0,0 +1,112 @@
+/*
+
+ Ear clipping against the sweep, on a convex-ish outline with a grid of
+ small convex holes, from a footprint without holes to thousands of holes.
+
+ g++ -std=c++11 -O2 -DNDEBUG -I.. earcut.cpp -o earcut && ./earcut
+
+*/
+#include "../tesselator/tesselator.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libtess;
+
+typedef std::vector<Float> Ring;   /* x, y of each point */
+
+static double Now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* An outline of n points around the origin and a side x side grid of holes
+ * inside it, a third of them left out.
+ */
+static std::vector<Ring> Shape(int n, int side)
+{
+    std::vector<Ring> rings(1);
+    srand(unsigned(n + side));
+    for (int i = 0; i < n; ++i) {
+        double a = 6.283185307179586 * i / n;
+        double r = 1000 + rand() % 300;
+        rings[0].push_back(Float(floor(r * cos(a))));
+        rings[0].push_back(Float(floor(r * sin(a))));
+    }
+
+    double step = 1400.0 / std::max(side, 1);
+    for (int gx = 0; gx < side; ++gx) {
+        for (int gy = 0; gy < side; ++gy) {
+            if (rand() % 3 == 0) {
+                continue;
+            }
+            double cx = -700 + (gx + 0.5) * step;
+            double cy = -700 + (gy + 0.5) * step;
+            int m = 3 + rand() % 12;
+            Ring hole;
+            for (int i = 0; i < m; ++i) {
+                double a = 6.283185307179586 * i / m;
+                double r = step * (0.2 + (rand() % 100) / 400.0);
+                hole.push_back(Float(floor(cx + r * cos(a))));
+                hole.push_back(Float(floor(cy + r * sin(a))));
+            }
+            rings.push_back(hole);
+        }
+    }
+    return rings;
+}
+
+/* Microseconds per tesselate() of the engine, and twice the covered area.
+ */
+static double Run(Tesselator& tess, TessEngine engine, const std::vector<Ring>& rings, int reps, double& area2)
+{
+    double t0 = Now();
+
+    tess.engine = engine;
+    for (int r = 0; r < reps; ++r) {
+        tess.init();
+        for (size_t i = 0; i < rings.size(); ++i) {
+            tess.add_contour(2, &rings[i][0], sizeof(Float) * 2, rings[i].size() / 2);
+        }
+        tess.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES);
+    }
+    double us = (Now() - t0) * 1000 / reps;
+
+    area2 = 0;
+    for (size_t i = 0; i + 2 < tess.elements.size(); i += 3) {
+        const Tesselator::vertex_type& a = tess.vertices[tess.elements[i]];
+        const Tesselator::vertex_type& b = tess.vertices[tess.elements[i + 1]];
+        const Tesselator::vertex_type& c = tess.vertices[tess.elements[i + 2]];
+        area2 += fabs((double(b.x) - a.x) * (double(c.y) - a.y) - (double(b.y) - a.y) * (double(c.x) - a.x));
+    }
+    return us;
+}
+
+int main()
+{
+    const int outlines[] = { 24, 200, 2000, 2000, 2000, 2000 };
+    const int sides[] = { 0, 3, 9, 20, 40, 60 };
+    Tesselator tess;
+
+    tess.retainCapacity = true;
+    printf("%6s %6s %12s %12s %12s\n", "points", "holes", "sweep", "earcut", "auto");
+    for (int k = 0; k < 6; ++k) {
+        std::vector<Ring> rings = Shape(outlines[k], sides[k]);
+        size_t points = 0;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            points += rings[i].size() / 2;
+        }
+        int reps = int(std::max<size_t>(2, 2000000 / (points * points / 16 + points * 20)));
+
+        double sweepArea, earcutArea, autoArea;
+        double sweep = Run(tess, TESS_ENGINE_SWEEP, rings, reps, sweepArea);
+        double earcut = Run(tess, TESS_ENGINE_EARCUT, rings, reps, earcutArea);
+        double automatic = Run(tess, TESS_ENGINE_AUTO, rings, reps, autoArea);
+        bool same = fabs(sweepArea - earcutArea) <= 1e-6 * sweepArea && fabs(sweepArea - autoArea) <= 1e-6 * sweepArea;
+        printf("%6zu %6zu %9.1f us %9.1f us %9.1f us%s\n", points, rings.size() - 1, sweep, earcut, automatic,
+            same ? "" : "  (areas differ)");
+    }
+    return 0;
+}
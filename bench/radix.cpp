@@ -0,0 +1,87 @@
+/*
+
+ The radix presort of the sweep events against std::sort, on N random
+ vertices, for float and double coordinates.
+
+ g++ -std=c++11 -O2 -DNDEBUG -I.. radix.cpp -o radix && ./radix [maxN]
+
+*/
+#include "../tesselator/tesselator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libtess;
+
+static double Now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename Config>
+struct VertexLess
+{
+    bool operator()(const BasicVertex<Config>* u, const BasicVertex<Config>* v) const
+    {
+        return u->s < v->s || (u->s == v->s && u->t < v->t);
+    }
+};
+
+/* Average milliseconds of both sorts over reps runs. Returns false if
+ * the orders differ.
+ */
+template<typename Config>
+static bool Run(size_t n, int reps, double& radix, double& standard)
+{
+    typedef BasicVertex<Config> Vertex;
+    typedef typename Config::Coord Coord;
+
+    std::vector<Vertex> vertices(n);
+    VertexRadixSort<Config> sorter;
+
+    srand(1);
+    for (size_t i = 0; i < n; ++i) {
+        vertices[i].s = Coord(rand() / double(RAND_MAX) * 1000);
+        vertices[i].t = Coord(rand() / double(RAND_MAX) * 1000);
+    }
+
+    radix = standard = 0;
+    for (int r = 0; r < reps; ++r) {
+        std::vector<Vertex*> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = b[i] = &vertices[i];
+        }
+
+        double t0 = Now();
+        sorter.sort(&a[0], &a[0] + n);
+        double t1 = Now();
+        std::sort(b.begin(), b.end(), VertexLess<Config>());
+        double t2 = Now();
+
+        radix += t1 - t0;
+        standard += t2 - t1;
+        for (size_t i = 0; i < n; ++i) {
+            if (a[i]->s != b[i]->s || a[i]->t != b[i]->t) {
+                return false;
+            }
+        }
+    }
+    radix /= reps;
+    standard /= reps;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxN = argc > 1 ? size_t(atol(argv[1])) : 1000000;
+
+    printf("%8s %12s %12s %12s %12s\n", "N", "std float", "radix float", "std double", "radix double");
+    for (size_t n = 10000; n <= maxN; n *= 10) {
+        double rf, sf, rd, sd;
+        bool same = Run<TessConfig<float, 2> >(n, 5, rf, sf);
+        same = Run<TessConfig<double, 2> >(n, 5, rd, sd) && same;
+        printf("%8zu %9.1f ms %9.1f ms %9.1f ms %9.1f ms%s\n", n, sf, rf, sd, rd, same ? "" : "  (orders differ)");
+    }
+    return 0;
+}
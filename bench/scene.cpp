@@ -0,0 +1,121 @@
+/*
+
+ TessScene against a full tesselate() after every edit, for the two layouts
+ it sees: scattered shapes and one shape with many nested contours.
+
+ g++ -std=c++11 -O2 -DNDEBUG -I.. scene.cpp -o scene && ./scene [side] [edits]
+
+ scattered: side x side stars with a hole each, 2 contours per group.
+ nested:    one square with side x side holes, all contours in one group,
+            so every edit tesselates the whole shape again.
+
+*/
+#include "../tesselator/scene.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libtess;
+
+typedef std::vector<Float> Ring;   /* x, y of each point */
+
+static double Now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static Ring Star(double cx, double cy, double r, double inner, int n)
+{
+    Ring ring;
+    for (int i = 0; i < n; ++i) {
+        double a = 6.283185307179586 * i / n;
+        double s = (i & 1) ? r * inner : r;
+        ring.push_back(Float(cx + s * cos(a)));
+        ring.push_back(Float(cy + s * sin(a)));
+    }
+    return ring;
+}
+
+static Ring Square(double x, double y, double size, bool hole)
+{
+    Ring ring;
+    double px[4] = { x, x + size, x + size, x };
+    double py[4] = { y, y, y + size, y + size };
+    for (int i = 0; i < 4; ++i) {
+        int k = hole ? 3 - i : i;
+        ring.push_back(Float(px[k]));
+        ring.push_back(Float(py[k]));
+    }
+    return ring;
+}
+
+/* Moves one point of a random contour other than the first one by up to
+ * a quarter unit, and times update_contour() against a tesselate() that
+ * splits the components the same way.
+ */
+static void Run(const char* name, std::vector<Ring>& rings, int edits)
+{
+    TessScene scene;
+    Tesselator full;
+    double t0, update = 0, whole = 0;
+    size_t swept = 0;
+
+    full.splitComponents = true;
+    for (size_t i = 0; i < rings.size(); ++i) {
+        scene.add_contour(2, &rings[i][0], sizeof(Float) * 2, rings[i].size() / 2);
+    }
+    t0 = Now();
+    scene.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES);
+    printf("%-10s %zu contours, first tesselate %.2f ms\n", name, rings.size(), Now() - t0);
+
+    srand(3);
+    for (int edit = 0; edit < edits; ++edit) {
+        size_t id = 1 + size_t(rand()) % (rings.size() - 1);
+        Ring& ring = rings[id];
+        size_t k = size_t(rand()) % (ring.size() / 2) * 2;
+        ring[k] += Float((rand() % 100 - 50) / 200.0);
+        ring[k + 1] += Float((rand() % 100 - 50) / 200.0);
+
+        t0 = Now();
+        scene.update_contour(Index(id), 2, &ring[0], sizeof(Float) * 2, ring.size() / 2);
+        update += Now() - t0;
+        swept += scene.sweptContours;
+
+        t0 = Now();
+        full.init();
+        for (size_t i = 0; i < rings.size(); ++i) {
+            full.add_contour(2, &rings[i][0], sizeof(Float) * 2, rings[i].size() / 2);
+        }
+        full.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES);
+        whole += Now() - t0;
+    }
+    printf("%-10s update_contour %.3f ms, %.1f contours swept; full tesselate %.3f ms\n",
+        name, update / edits, double(swept) / edits, whole / edits);
+}
+
+int main(int argc, char** argv)
+{
+    int side = argc > 1 ? atoi(argv[1]) : 30;
+    int edits = argc > 2 ? atoi(argv[2]) : 50;
+    std::vector<Ring> rings;
+
+    for (int i = 0; i < side; ++i) {
+        for (int j = 0; j < side; ++j) {
+            rings.push_back(Star(i * 10 + 5, j * 10 + 5, 4.5, 0.66, 24));
+            rings.push_back(Square(i * 10 + 4, j * 10 + 4, 1, true));
+        }
+    }
+    Run("scattered", rings, edits);
+
+    rings.clear();
+    rings.push_back(Square(0, 0, side * 4 + 1, false));
+    for (int i = 0; i < side; ++i) {
+        for (int j = 0; j < side; ++j) {
+            rings.push_back(Square(i * 4 + 1, j * 4 + 1, 2, true));
+        }
+    }
+    Run("nested", rings, edits);
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+
+ The sweep under each winding rule, on one self-intersecting contour of n
+ random points, tens of thousands of crossings. The rule is a template
+ argument of the sweep, so there is nothing to switch at run time: build
+ this file on two trees to compare them. The hash tells if the outputs
+ are the same.
+
+ g++ -std=c++11 -O2 -DNDEBUG -I.. winding.cpp -o winding && ./winding [n] [reps]
+
+*/
+#include "../tesselator/tesselator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libtess;
+
+static double Now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 600;
+    int reps = argc > 2 ? atoi(argv[2]) : 4;
+    const char* names[] = { "ODD", "NONZERO", "POSITIVE", "NEGATIVE", "ABS_GEQ_TWO" };
+    std::vector<Float> points;
+    Tesselator tess;
+    unsigned long hash = 0;
+    double total = 0;
+
+    srand(7);
+    for (int i = 0; i < n; ++i) {
+        points.push_back(Float(rand() % 100000));
+        points.push_back(Float(rand() % 100000));
+    }
+
+    tess.retainCapacity = true;
+    tess.engine = TESS_ENGINE_SWEEP;
+    for (int rule = 0; rule < 5; ++rule) {
+        double best = 1e30;
+        size_t triangles = 0;
+        for (int r = 0; r < reps; ++r) {
+            tess.init();
+            tess.add_contour(2, &points[0], sizeof(Float) * 2, n);
+            double t0 = Now();
+            int status = tess.tesselate(TessWindingRule(rule), TESS_TRIANGLES);
+            best = std::min(best, Now() - t0);
+            triangles = status == LIBTESS_OK ? tess.elements.size() / 3 : 0;
+        }
+        for (size_t i = 0; i < tess.elements.size(); ++i) {
+            hash = hash * 31 + unsigned(tess.elements[i]);
+        }
+        total += best;
+        printf("%-12s %7zu triangles %9.1f ms\n", names[rule], triangles, best);
+    }
+    printf("%-12s %17s %9.1f ms, hash %lu\n", "all", "", total, hash);
+    return 0;
+}
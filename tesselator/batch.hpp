@@ -0,0 +1,756 @@
+/*
+
+ Batch tessellation of independent polygons on a thread pool (C++11).
+
+//
+// Exsample:
+//
+
+libtess::TessContour contours[] = {
+    { 2, outline, sizeof(float) * 2, outlineCount },
+    { 2, hole, sizeof(float) * 2, holeCount },
+    { 2, star, sizeof(float) * 2, starCount }
+};
+
+libtess::TessJob jobs[] = {
+    { contours, 2, TESS_WINDING_ODD, TESS_TRIANGLES, 3 },
+    { contours + 2, 1, TESS_WINDING_NONZERO, TESS_BOUNDARY_CONTOURS, 3 }
+};
+
+libtess::TessBatch batch;
+batch.tesselate(jobs, 2);
+
+// job i wrote batch.vertices[ranges[i].vertexOffset, + vertexCount) and
+// batch.elements[ranges[i].elementOffset, + elementCount), the elements
+// index batch.vertices directly. The elements of a TESS_TRIANGLE_STRIPS
+// job start with the restart INVALID_INDEX, so the strips of all jobs
+// draw as one buffer. The polygons of TESS_POLYGONS and
+// TESS_CONNECTED_POLYGONS jobs are numbered in job order, the neighbours
+// of job i count from ranges[i].polygonOffset.
+
+*/
+#ifndef LIBTESS_BATCH_HPP
+#define LIBTESS_BATCH_HPP
+
+#include "tesselator.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace libtess {
+
+/* One contour of a job, see Tesselator::add_contour().
+ */
+struct TessContour
+{
+    size_t dimension;
+    const void* pointer;
+    size_t stride;
+    size_t count;
+};
+
+struct TessJob
+{
+    const TessContour* contours;
+    size_t contourCount;
+    TessWindingRule windingRule;
+    TessElementType elementType;
+    int polySize;
+};
+
+/* Where the output of a job is in the batch buffers.
+ */
+struct TessRange
+{
+    int status;             /* result of Tesselator::tesselate() */
+    size_t vertexOffset;
+    size_t vertexCount;
+    size_t elementOffset;
+    size_t elementCount;
+    size_t polygonOffset;   /* polygons of the jobs before, see TessJob::polySize */
+};
+
+/* Runs independent jobs on a work-stealing thread pool with one reusable
+ * Tesselator per worker, the calling thread being worker 0. The outputs
+ * are concatenated in job order, so they do not depend on the number of
+ * threads or on which worker ran a job.
+ */
+template<typename Config>
+class BasicTessBatch
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+    typedef typename Tesselator::vertex_type vertex_type;
+
+    // options of every job, see Tesselator
+    bool processCDT;
+    bool reverseContours;
+    TessEngine engine;
+
+    // outputs
+    std::vector<vertex_type, allocator<vertex_type> > vertices;
+    std::vector<Index, allocator<Index> > elements;   /* indices into vertices */
+    std::vector<TessRange, allocator<TessRange> > ranges; /* one per job */
+
+public:
+    /* threadCount 0 uses one worker per hardware thread. The outputs and
+     * the Tesselator and buffers of every worker take their memory from
+     * allocator. The workers share it, so with more than one thread it
+     * must be thread safe, which an Arena is not.
+     */
+    explicit BasicTessBatch(size_t threadCount = 0, Allocator* allocator = NULL);
+    ~BasicTessBatch();
+
+    size_t thread_count()const { return workers.size(); }
+
+    /* Returns LIBTESS_OK if every job succeeded, the status of each job
+     * is in ranges.
+     */
+    int tesselate(const TessJob* jobs, size_t count);
+
+    /* Triangulates one big polygon in parallel. The contours are cut into
+     * slabCount slabs along the sweep axis (y), at quantiles of the vertex
+     * y coordinates, and every slab is swept as a job of its own. The
+     * slabs are stitched into one mesh without cracks or T-junctions.
+     * ranges holds one range per slab, the shared vertices on a cut belong
+     * to the slab below it. slabCount 0 uses one slab per worker.
+     * Not available with integer coordinates, the cuts are off the grid.
+     */
+    int tesselate_slabs(const TessContour* contours, size_t count, TessWindingRule windingRule, size_t slabCount = 0);
+
+private:
+    enum Phase { PHASE_TESSELATE, PHASE_GATHER, PHASE_QUIT };
+
+    struct Worker
+    {
+        Tesselator tess;
+        std::vector<vertex_type, allocator<vertex_type> > vertices; /* outputs of the jobs run by this worker */
+        std::vector<Index, allocator<Index> > elements;
+        std::mutex lock;                    /* guards next and end */
+        size_t next, end;                   /* job queue, taken from the front, stolen from the back */
+        std::thread thread;
+
+        explicit Worker(Allocator* a) : tess(a),
+            vertices(allocator<vertex_type>(a)),
+            elements(allocator<Index>(a)),
+            next(), end()
+        {
+        }
+    };
+
+    struct Output
+    {
+        size_t worker;
+        size_t vertexOffset;                /* in the worker buffers */
+        size_t elementOffset;
+    };
+
+    struct Slab
+    {
+        std::vector<Vec3> points;           /* the contours clipped to the slab */
+        std::vector<size_t> rings;          /* begin and end of each contour */
+        size_t start;                       /* first point of the contour being clipped */
+    };
+
+    std::vector<Worker*> workers;
+    std::vector<Output> outputs;
+
+    std::vector<Slab> slabs;
+    std::vector<Float> cuts;                /* y of the cut between slab i and i + 1 */
+    std::vector<TessContour> slabContours;
+    std::vector<TessJob> slabJobs;
+    std::vector<Index> remap;               /* vertex to its copy in the slab below, then to its final index */
+    std::vector<Index> seams[2];
+
+    std::mutex poolLock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    size_t generation;
+    size_t running;
+    Phase phase;
+
+    const TessJob* jobs;
+    size_t jobCount;
+
+    BasicTessBatch(const BasicTessBatch&);
+    BasicTessBatch& operator=(const BasicTessBatch&);
+
+    void Run(Phase value);
+    void Loop(size_t self);
+    void Work(size_t self);
+    bool Take(size_t self, size_t& job);
+    bool Steal(size_t self, size_t& job);
+    void TesselateJob(Worker& worker, size_t self, size_t job);
+    void GatherJob(size_t job);
+
+    void ComputeCuts(const TessContour* contours, size_t count, size_t slabCount);
+    void ClipContour(const TessContour& contour);
+    void AddSlabPoint(size_t slab, const Vec3& p);
+    void StitchSlabs();
+};
+
+typedef BasicTessBatch<DefaultConfig> TessBatch;
+
+//
+// source
+//
+
+template<typename Config>
+LIBTESS_INLINE BasicTessBatch<Config>::BasicTessBatch(size_t threadCount, Allocator* a) :
+    processCDT(false),
+    reverseContours(false),
+    engine(TESS_ENGINE_SWEEP),
+    vertices(allocator<vertex_type>(a)),
+    elements(allocator<Index>(a)),
+    ranges(allocator<TessRange>(a)),
+    generation(0),
+    running(0),
+    phase(PHASE_TESSELATE),
+    jobs(NULL),
+    jobCount(0)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) {
+            threadCount = 1;
+        }
+    }
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        Worker* worker = new Worker(a);
+        worker->tess.retainCapacity = true;
+        workers.push_back(worker);
+    }
+
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers[i]->thread = std::thread(&BasicTessBatch::Loop, this, i);
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE BasicTessBatch<Config>::~BasicTessBatch()
+{
+    {
+        std::lock_guard<std::mutex> guard(poolLock);
+        phase = PHASE_QUIT;
+        ++generation;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (workers[i]->thread.joinable()) {
+            workers[i]->thread.join();
+        }
+        delete workers[i];
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE int BasicTessBatch<Config>::tesselate(const TessJob* jobList, size_t count)
+{
+    int errCode = LIBTESS_OK;
+    size_t vertexCount = 0;
+    size_t elementCount = 0;
+    size_t polygonCount = 0;
+
+    jobs = jobList;
+    jobCount = count;
+    ranges.resize(count);
+    outputs.resize(count);
+
+    for (size_t i = 0; i < workers.size(); ++i) {
+        Worker& worker = *workers[i];
+        worker.tess.processCDT = processCDT;
+        worker.tess.reverseContours = reverseContours;
+        worker.tess.engine = engine;
+        worker.vertices.clear();
+        worker.elements.clear();
+    }
+
+    this->Run(PHASE_TESSELATE);
+
+    /* the offsets follow the job order */
+    for (size_t i = 0; i < count; ++i) {
+        ranges[i].vertexOffset = vertexCount;
+        ranges[i].elementOffset = elementCount;
+        ranges[i].polygonOffset = polygonCount;
+        vertexCount += ranges[i].vertexCount;
+        elementCount += ranges[i].elementCount;
+        if (jobs[i].elementType == TESS_POLYGONS) {
+            polygonCount += ranges[i].elementCount / size_t(jobs[i].polySize);
+        }
+        else if (jobs[i].elementType == TESS_CONNECTED_POLYGONS) {
+            polygonCount += ranges[i].elementCount / (size_t(jobs[i].polySize) * 2);
+        }
+        if (ranges[i].status != LIBTESS_OK) {
+            errCode = LIBTESS_ERROR;
+        }
+    }
+
+    vertices.resize(vertexCount);
+    elements.resize(elementCount);
+
+    this->Run(PHASE_GATHER);
+
+    jobs = NULL;
+    jobCount = 0;
+    return errCode;
+}
+
+/* Splits the jobs evenly over the workers and runs the phase on all of them.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::Run(Phase value)
+{
+    size_t n = workers.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        Worker& worker = *workers[i];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.next = jobCount * i / n;
+        worker.end = jobCount * (i + 1) / n;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(poolLock);
+        phase = value;
+        running = n - 1;
+        ++generation;
+    }
+    wake.notify_all();
+
+    this->Work(0);
+
+    std::unique_lock<std::mutex> guard(poolLock);
+    while (running) {
+        done.wait(guard);
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::Loop(size_t self)
+{
+    size_t seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(poolLock);
+            while (generation == seen) {
+                wake.wait(guard);
+            }
+            seen = generation;
+            if (phase == PHASE_QUIT) {
+                return;
+            }
+        }
+
+        this->Work(self);
+
+        {
+            std::lock_guard<std::mutex> guard(poolLock);
+            --running;
+        }
+        done.notify_one();
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::Work(size_t self)
+{
+    size_t job;
+
+    while (this->Take(self, job) || this->Steal(self, job)) {
+        if (phase == PHASE_TESSELATE) {
+            this->TesselateJob(*workers[self], self, job);
+        }
+        else {
+            this->GatherJob(job);
+        }
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE bool BasicTessBatch<Config>::Take(size_t self, size_t& job)
+{
+    Worker& worker = *workers[self];
+    std::lock_guard<std::mutex> guard(worker.lock);
+
+    if (worker.next < worker.end) {
+        job = worker.next++;
+        return true;
+    }
+    return false;
+}
+
+/* Takes the back half of the queue of another worker, and runs its first job.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicTessBatch<Config>::Steal(size_t self, size_t& job)
+{
+    size_t n = workers.size();
+
+    for (size_t i = 1; i < n; ++i) {
+        Worker& victim = *workers[(self + i) % n];
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            size_t left = victim.end - victim.next;
+            if (left == 0) {
+                continue;
+            }
+            begin = victim.end - (left + 1) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        Worker& worker = *workers[self];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        job = begin;
+        worker.next = begin + 1;
+        worker.end = end;
+        return true;
+    }
+    return false;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::TesselateJob(Worker& worker, size_t self, size_t job)
+{
+    const TessJob& info = jobs[job];
+    Tesselator& tess = worker.tess;
+    TessRange& range = ranges[job];
+    Output& output = outputs[job];
+    int errCode = LIBTESS_OK;
+
+    tess.init();
+    for (size_t i = 0; i < info.contourCount && errCode == LIBTESS_OK; ++i) {
+        const TessContour& c = info.contours[i];
+        errCode = tess.add_contour(c.dimension, c.pointer, c.stride, c.count);
+    }
+    if (errCode == LIBTESS_OK) {
+        errCode = tess.tesselate(info.windingRule, info.elementType, info.polySize);
+    }
+
+    output.worker = self;
+    output.vertexOffset = worker.vertices.size();
+    output.elementOffset = worker.elements.size();
+    range.status = errCode;
+    range.vertexCount = 0;
+    range.elementCount = 0;
+
+    if (errCode == LIBTESS_OK) {
+        /* the last strip of the job before must not go on */
+        if (info.elementType == TESS_TRIANGLE_STRIPS && !tess.elements.empty()) {
+            worker.elements.push_back(INVALID_INDEX);
+        }
+        worker.vertices.insert(worker.vertices.end(), tess.vertices.begin(), tess.vertices.end());
+        worker.elements.insert(worker.elements.end(), tess.elements.begin(), tess.elements.end());
+        range.vertexCount = tess.vertices.size();
+        range.elementCount = worker.elements.size() - output.elementOffset;
+    }
+}
+
+/* Copies the output of a job to its place in the batch buffers.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::GatherJob(size_t job)
+{
+    const TessJob& info = jobs[job];
+    const TessRange& range = ranges[job];
+    const Output& output = outputs[job];
+    const Worker& worker = *workers[output.worker];
+
+    std::copy(worker.vertices.begin() + output.vertexOffset,
+        worker.vertices.begin() + output.vertexOffset + range.vertexCount,
+        vertices.begin() + range.vertexOffset);
+
+    std::copy(worker.elements.begin() + output.elementOffset,
+        worker.elements.begin() + output.elementOffset + range.elementCount,
+        elements.begin() + range.elementOffset);
+    if (range.elementCount) {
+        RebaseElements(&elements[range.elementOffset], range.elementCount, info.elementType, info.polySize,
+            Index(range.vertexOffset), Index(range.polygonOffset));
+    }
+}
+
+//
+// slabs
+//
+
+template<typename Config>
+LIBTESS_INLINE typename Config::Vec3 ContourPoint(const TessContour& contour, size_t i)
+{
+    typedef typename Config::Float Float;
+    typedef typename Config::Vec3 Vec3;
+
+    const Float* coords = (const Float*) ((const unsigned char*) contour.pointer + contour.stride * i);
+    return Vec3(coords[0], coords[1], contour.dimension > 2 ? coords[2] : 0);
+}
+
+/* The point of a segment at y = c. It is computed from the lower end, so
+ * both slabs of a cut get exactly the same point.
+ */
+template<typename Vec3, typename T>
+LIBTESS_INLINE Vec3 CutSegment(Vec3 a, Vec3 b, T c)
+{
+    if (b.y < a.y) {
+        std::swap(a, b);
+    }
+    double t = (double(c) - a.y) / (double(b.y) - a.y);
+    return Vec3(T(a.x + t * (double(b.x) - a.x)), c, T(a.z + t * (double(b.z) - a.z)));
+}
+
+template<typename Config>
+LIBTESS_INLINE int BasicTessBatch<Config>::tesselate_slabs(const TessContour* contours, size_t count, TessWindingRule windingRule, size_t slabCount)
+{
+    if (Config::INTEGER_COORDS) {
+        LIBTESS_LOG("TessBatch.tesselate_slabs() : not available with integer coordinates.");
+        return LIBTESS_ERROR;
+    }
+    if (slabCount == 0) {
+        slabCount = workers.size();
+    }
+
+    this->ComputeCuts(contours, count, slabCount);
+
+    slabs.resize(cuts.size() + 1);
+    for (size_t i = 0; i < slabs.size(); ++i) {
+        slabs[i].points.clear();
+        slabs[i].rings.clear();
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        this->ClipContour(contours[i]);
+    }
+
+    slabContours.clear();
+    for (size_t i = 0; i < slabs.size(); ++i) {
+        const Slab& slab = slabs[i];
+        for (size_t j = 0; j < slab.rings.size(); j += 2) {
+            TessContour c = { 3, &slab.points[slab.rings[j]], sizeof(Vec3), slab.rings[j + 1] - slab.rings[j] };
+            slabContours.push_back(c);
+        }
+    }
+
+    slabJobs.resize(slabs.size());
+    for (size_t i = 0, first = 0; i < slabs.size(); ++i) {
+        TessJob job = { slabContours.empty() ? NULL : &slabContours[first], slabs[i].rings.size() / 2, windingRule, TESS_TRIANGLES, 3 };
+        slabJobs[i] = job;
+        first += job.contourCount;
+    }
+
+    this->tesselate(&slabJobs[0], slabJobs.size());
+
+    /* a slab without contours is empty, not an error */
+    for (size_t i = 0; i < slabJobs.size(); ++i) {
+        if (slabJobs[i].contourCount == 0) {
+            ranges[i].status = LIBTESS_OK;
+        }
+        else if (ranges[i].status != LIBTESS_OK) {
+            return LIBTESS_ERROR;
+        }
+    }
+
+    this->StitchSlabs();
+    return LIBTESS_OK;
+}
+
+/* Places the cuts near quantiles of the vertex y coordinates, in the
+ * middle of the widest gap between two vertices around the quantile, so
+ * that no vertex lies on or very close to a cut.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::ComputeCuts(const TessContour* contours, size_t count, size_t slabCount)
+{
+    std::vector<Float> values;
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < contours[i].count; ++j) {
+            values.push_back(ContourPoint<Config>(contours[i], j).y);
+        }
+    }
+
+    cuts.clear();
+    std::sort(values.begin(), values.end());
+
+    size_t n = values.size();
+    size_t window = n / (slabCount * 8) + 1;
+
+    for (size_t i = 1; i < slabCount && n > 1; ++i) {
+        size_t q = n * i / slabCount;
+        size_t first = q > window ? q - window : 0;
+        size_t last = std::min(q + window, n - 1);
+        size_t best = first;
+        for (size_t j = first; j < last; ++j) {
+            if (values[j + 1] - values[j] > values[best + 1] - values[best]) {
+                best = j;
+            }
+        }
+        Float c = (values[best] + values[best + 1]) / 2;
+        if (c > values[best] && c < values[best + 1] && (cuts.empty() || c > cuts.back())) {
+            cuts.push_back(c);
+        }
+    }
+}
+
+/* Clips a contour to every slab. The parts of the contour outside a slab
+ * are replaced by the segment along the cut between the points where it
+ * leaves and enters the slab, which keeps the winding number of every
+ * point inside the slab.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::ClipContour(const TessContour& contour)
+{
+    Vec3 prev, cur;
+
+    if (contour.count == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < slabs.size(); ++i) {
+        slabs[i].start = slabs[i].points.size();
+    }
+
+    prev = ContourPoint<Config>(contour, contour.count - 1);
+    for (size_t i = 0; i < contour.count; ++i, prev = cur) {
+        cur = ContourPoint<Config>(contour, i);
+
+        /* the cuts strictly between prev and cur, in the direction of the edge */
+        if (prev.y < cur.y) {
+            size_t j = std::upper_bound(cuts.begin(), cuts.end(), prev.y) - cuts.begin();
+            for (; j < cuts.size() && cuts[j] < cur.y; ++j) {
+                Vec3 p = CutSegment(prev, cur, cuts[j]);
+                this->AddSlabPoint(j, p);
+                this->AddSlabPoint(j + 1, p);
+            }
+        }
+        else if (cur.y < prev.y) {
+            size_t j = std::lower_bound(cuts.begin(), cuts.end(), prev.y) - cuts.begin();
+            for (; j > 0 && cuts[j - 1] > cur.y; --j) {
+                Vec3 p = CutSegment(prev, cur, cuts[j - 1]);
+                this->AddSlabPoint(j, p);
+                this->AddSlabPoint(j - 1, p);
+            }
+        }
+
+        /* a point on a cut belongs to both slabs */
+        size_t k = std::upper_bound(cuts.begin(), cuts.end(), cur.y) - cuts.begin();
+        if (k > 0 && cuts[k - 1] == cur.y) {
+            this->AddSlabPoint(k - 1, cur);
+        }
+        this->AddSlabPoint(k, cur);
+    }
+
+    for (size_t i = 0; i < slabs.size(); ++i) {
+        Slab& slab = slabs[i];
+        if (slab.points.size() - slab.start >= 3) {
+            slab.rings.push_back(slab.start);
+            slab.rings.push_back(slab.points.size());
+        }
+        else {
+            slab.points.resize(slab.start);
+        }
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::AddSlabPoint(size_t slab, const Vec3& p)
+{
+    std::vector<Vec3>& points = slabs[slab].points;
+
+    if (points.size() > slabs[slab].start) {
+        const Vec3& last = points.back();
+        if (last.x == p.x && last.y == p.y && last.z == p.z) {
+            return;
+        }
+    }
+    points.push_back(p);
+}
+
+template<typename V>
+struct SeamLess
+{
+    const V* v;
+
+    bool operator()(Index a, Index b)const
+    {
+        return v[a].x < v[b].x || (v[a].x == v[b].x && a < b);
+    }
+};
+
+/* Merges the vertices on each cut with their copies in the slab below,
+ * both slabs computed them from the same segments.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessBatch<Config>::StitchSlabs()
+{
+    size_t n = vertices.size();
+    size_t k = 0;
+
+    remap.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        remap[i] = Index(i);
+    }
+
+    for (size_t c = 0; c < cuts.size(); ++c) {
+        for (int side = 0; side < 2; ++side) {
+            const TessRange& range = ranges[c + side];
+            std::vector<Index>& seam = seams[side];
+            seam.clear();
+            for (size_t i = range.vertexOffset; i < range.vertexOffset + range.vertexCount; ++i) {
+                if (vertices[i].y == cuts[c]) {
+                    seam.push_back(Index(i));
+                }
+            }
+            SeamLess<vertex_type> less = { vertices.empty() ? NULL : &vertices[0] };
+            std::sort(seam.begin(), seam.end(), less);
+        }
+
+        /* both seams are sorted by x, match the equal vertices */
+        for (size_t i = 0, j = 0; i < seams[0].size() && j < seams[1].size(); ) {
+            const vertex_type& a = vertices[seams[0][i]];
+            const vertex_type& b = vertices[seams[1][j]];
+            if (a.x < b.x) {
+                ++i;
+            }
+            else if (b.x < a.x) {
+                ++j;
+            }
+            else {
+                if (memcmp(&a, &b, sizeof(vertex_type)) == 0) {
+                    remap[seams[1][j]] = remap[seams[0][i]];
+                }
+                ++i;
+                ++j;
+            }
+        }
+    }
+
+    /* drop the merged vertices, keeping the order */
+    for (size_t s = 0; s < ranges.size(); ++s) {
+        TessRange& range = ranges[s];
+        size_t first = k;
+        for (size_t i = range.vertexOffset; i < range.vertexOffset + range.vertexCount; ++i) {
+            if (remap[i] == Index(i)) {
+                vertices[k] = vertices[i];
+                remap[i] = Index(k++);
+            }
+            else {
+                remap[i] = remap[remap[i]];
+            }
+        }
+        range.vertexOffset = first;
+        range.vertexCount = k - first;
+    }
+    vertices.resize(k);
+
+    for (size_t i = 0; i < elements.size(); ++i) {
+        elements[i] = remap[elements[i]];
+    }
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_BATCH_HPP
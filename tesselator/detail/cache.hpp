@@ -0,0 +1,283 @@
+/*
+ * LRU cache of tessellation results, keyed by a hash of the input.
+ */
+
+#ifndef LIBTESS_CACHE_HPP
+#define LIBTESS_CACHE_HPP
+
+#include "public.h"
+
+#include <unordered_map>
+
+namespace libtess {
+
+/* One step of a 64-bit multiplicative hash, a bijection of h for every v.
+ */
+LIBTESS_INLINE uint64_t HashStep(uint64_t h, uint64_t v)
+{
+    h ^= v;
+    h *= 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 31);
+}
+
+/* Hashes size bytes, 8 at a time.
+ */
+LIBTESS_INLINE uint64_t HashBytes(uint64_t h, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*) data;
+    uint64_t v;
+
+    for (; size >= 8; size -= 8, p += 8) {
+        memcpy(&v, p, 8);
+        h = HashStep(h, v);
+    }
+    if (size) {
+        v = 0;
+        memcpy(&v, p, size);
+        h = HashStep(h, v ^ (uint64_t(size) << 56));
+    }
+    return h;
+}
+
+/* Keeps the outputs of the last tesselations within a memory budget,
+ * the least recently used result goes first. Results are found by a
+ * 64-bit hash of the contours and of the options that change the output.
+ * The contours themselves are not kept, except as the shape of a result
+ * that is looked up up to a tolerance: the key of such results is coarse
+ * and the shape tells apart the results under one key. A cache is not
+ * thread safe, the tesselators sharing it must run on one thread.
+ */
+template<typename Config>
+class BasicTessCache
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+    typedef typename select_type<Config::VERTEX_SIZE == 3, Vec3, Vec2>::type vertex_type;
+
+    struct Entry
+    {
+        uint64_t key;
+        std::vector<vertex_type> vertices;
+        std::vector<Index> indices;
+        std::vector<Index> elements;
+        std::vector<Float> shape;   /* the points of the contours, if compared */
+        TessEngine engine;          /* Tesselator::selectedEngine */
+        size_t bytes;
+        Index prev, next;           /* in the order of use, most recent first */
+    };
+
+    size_t hits;
+    size_t misses;
+
+public:
+    /* budget is the limit on the bytes of the kept outputs.
+     */
+    explicit BasicTessCache(size_t budget = size_t(16) << 20);
+
+    void clear();
+
+    size_t size()const { return map.size(); }
+    size_t bytes()const { return used; }
+    size_t budget()const { return limit; }
+    void set_budget(size_t budget);
+
+    /* Returns the result of key and makes it the most recent, or NULL.
+     * With a shape of size numbers, only a result whose shape has the same
+     * size and differs by at most tolerance in every number is taken.
+     */
+    const Entry* find(uint64_t key, const Float* shape = NULL, size_t size = 0, Float tolerance = 0);
+
+    /* Keeps a copy of a result, results bigger than the budget are not kept.
+     */
+    template<typename V, typename I>
+    void insert(uint64_t key, const V& vertices, const I& indices, const I& elements, TessEngine engine,
+        const Float* shape = NULL, size_t size = 0);
+
+private:
+    std::vector<Entry> entries;
+    std::vector<Index> unused;      /* free entries */
+    std::unordered_multimap<uint64_t, Index> map;
+    Index head, tail;
+    size_t used, limit;
+
+    BasicTessCache(const BasicTessCache&);
+    BasicTessCache& operator=(const BasicTessCache&);
+
+    void Unlink(Index i);
+    void LinkFront(Index i);
+    void Evict(size_t bytes);
+    Index Match(uint64_t key, const Float* shape, size_t size, Float tolerance)const;
+};
+
+typedef BasicTessCache<DefaultConfig> TessCache;
+
+//
+// source
+//
+
+template<typename Config>
+LIBTESS_INLINE BasicTessCache<Config>::BasicTessCache(size_t budget) :
+    hits(0),
+    misses(0),
+    head(INVALID_INDEX),
+    tail(INVALID_INDEX),
+    used(0),
+    limit(budget)
+{
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessCache<Config>::clear()
+{
+    entries.clear();
+    unused.clear();
+    map.clear();
+    head = tail = INVALID_INDEX;
+    used = 0;
+    hits = misses = 0;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessCache<Config>::set_budget(size_t budget)
+{
+    limit = budget;
+    this->Evict(0);
+}
+
+template<typename Config>
+LIBTESS_INLINE const typename BasicTessCache<Config>::Entry* BasicTessCache<Config>::find(uint64_t key, const Float* shape, size_t size, Float tolerance)
+{
+    Index i = this->Match(key, shape, size, tolerance);
+    if (i == INVALID_INDEX) {
+        ++misses;
+        return NULL;
+    }
+
+    ++hits;
+    if (i != head) {
+        this->Unlink(i);
+        this->LinkFront(i);
+    }
+    return &entries[i];
+}
+
+template<typename Config>
+LIBTESS_INLINE Index BasicTessCache<Config>::Match(uint64_t key, const Float* shape, size_t size, Float tolerance)const
+{
+    typedef typename std::unordered_multimap<uint64_t, Index>::const_iterator iterator;
+    std::pair<iterator, iterator> range = map.equal_range(key);
+
+    for (iterator itr = range.first; itr != range.second; ++itr) {
+        const std::vector<Float>& other = entries[itr->second].shape;
+        size_t i = 0;
+        if (other.size() != size) {
+            continue;
+        }
+        while (i < size && Abs(other[i] - shape[i]) <= tolerance) {
+            ++i;
+        }
+        if (i == size) {
+            return itr->second;
+        }
+    }
+    return INVALID_INDEX;
+}
+
+template<typename Config>
+template<typename V, typename I>
+LIBTESS_INLINE void BasicTessCache<Config>::insert(uint64_t key, const V& vertices, const I& indices, const I& elements, TessEngine engine,
+    const Float* shape, size_t size)
+{
+    size_t bytes = sizeof(Entry) + vertices.size() * sizeof(vertex_type) + (indices.size() + elements.size()) * sizeof(Index) + size * sizeof(Float);
+    Index i;
+
+    if (bytes > limit || this->Match(key, shape, size, 0) != INVALID_INDEX) {
+        return;
+    }
+    this->Evict(bytes);
+
+    if (unused.empty()) {
+        i = Index(entries.size());
+        entries.push_back(Entry());
+    }
+    else {
+        i = unused.back();
+        unused.pop_back();
+    }
+
+    Entry& entry = entries[i];
+    entry.key = key;
+    entry.vertices.assign(vertices.begin(), vertices.end());
+    entry.indices.assign(indices.begin(), indices.end());
+    entry.elements.assign(elements.begin(), elements.end());
+    entry.shape.assign(shape, shape + size);
+    entry.engine = engine;
+    entry.bytes = bytes;
+    this->LinkFront(i);
+    map.insert(std::make_pair(key, i));
+    used += bytes;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessCache<Config>::Unlink(Index i)
+{
+    Entry& entry = entries[i];
+    if (entry.prev != INVALID_INDEX) {
+        entries[entry.prev].next = entry.next;
+    }
+    else {
+        head = entry.next;
+    }
+    if (entry.next != INVALID_INDEX) {
+        entries[entry.next].prev = entry.prev;
+    }
+    else {
+        tail = entry.prev;
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessCache<Config>::LinkFront(Index i)
+{
+    entries[i].prev = INVALID_INDEX;
+    entries[i].next = head;
+    if (head != INVALID_INDEX) {
+        entries[head].prev = i;
+    }
+    else {
+        tail = i;
+    }
+    head = i;
+}
+
+/* Drops the least recently used results until bytes more fit the budget.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessCache<Config>::Evict(size_t bytes)
+{
+    while (tail != INVALID_INDEX && used + bytes > limit) {
+        Index i = tail;
+        Entry& entry = entries[i];
+        this->Unlink(i);
+        typedef typename std::unordered_multimap<uint64_t, Index>::iterator iterator;
+        std::pair<iterator, iterator> range = map.equal_range(entry.key);
+        for (iterator itr = range.first; itr != range.second; ++itr) {
+            if (itr->second == i) {
+                map.erase(itr);
+                break;
+            }
+        }
+        used -= entry.bytes;
+        /* the memory goes with the entry */
+        std::vector<vertex_type>().swap(entry.vertices);
+        std::vector<Index>().swap(entry.indices);
+        std::vector<Index>().swap(entry.elements);
+        std::vector<Float>().swap(entry.shape);
+        unused.push_back(i);
+    }
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_CACHE_HPP
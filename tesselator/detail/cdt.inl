@@ -8,7 +8,8 @@ namespace libtess {
 /* Starting with a valid triangulation, uses the Edge Flip algorithm to
  * refine the triangulation into a Constrained Delaunay Triangulation.
  */
-LIBTESS_INLINE void Tesselator::MeshRefineDelaunay(Mesh *mesh)
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::MeshRefineDelaunay(Mesh *mesh)
 {
     /* At this point, we have a valid, but not optimal, triangulation.
      * We refine the triangulation using the Edge Flip algorithm
@@ -19,16 +20,18 @@ LIBTESS_INLINE void Tesselator::MeshRefineDelaunay(Mesh *mesh)
      */
 
     Face *f;
-    std::stack<HalfEdge*> stack;
+    std::vector<HalfEdge*, allocator<HalfEdge*> >& stack = this->edgeStack;
     HalfEdge *e;
     int maxFaces = 0, maxIter = 0, iter = 0;
 
+    stack.clear();
+
     for (f = mesh->m_faceHead.next; f != &mesh->m_faceHead; f = f->next) {
         if (f->inside) {
             e = f->edge;
             do {
                 e->mark = EdgeIsInternal(e); // Mark internal edges
-                if (e->mark && !e->mirror->mark) stack.push(e); // Insert into queue
+                if (e->mark && !e->mirror->mark) stack.push_back(e); // Insert into queue
                 e = e->Lnext;
             } while (e != f->edge);
             maxFaces++;
@@ -45,8 +48,8 @@ LIBTESS_INLINE void Tesselator::MeshRefineDelaunay(Mesh *mesh)
      * which are internal and not already in the stack (!marked)
      */
     while (!stack.empty() && iter < maxIter) {
-        e = stack.top();
-        stack.pop();
+        e = stack.back();
+        stack.pop_back();
         e->mark = e->mirror->mark = 0;
         if (!EdgeIsLocallyDelaunay(e)) {
             HalfEdge *edges[4];
@@ -60,7 +63,7 @@ LIBTESS_INLINE void Tesselator::MeshRefineDelaunay(Mesh *mesh)
             for (i = 0; i < 4; i++) {
                 if (!edges[i]->mark && EdgeIsInternal(edges[i])) {
                     edges[i]->mark = edges[i]->mirror->mark = 1;
-                    stack.push(edges[i]);
+                    stack.push_back(edges[i]);
                 }
             }
         }
@@ -68,9 +71,10 @@ LIBTESS_INLINE void Tesselator::MeshRefineDelaunay(Mesh *mesh)
     }
 }
 
-#if 0
-
-Index Tesselator::GetNeighbourFace(HalfEdge* edge)
+/* The polygon on the other side of edge, INVALID_INDEX if it is outside.
+ */
+template<typename Config>
+LIBTESS_INLINE Index BasicTesselator<Config>::GetNeighbourFace(HalfEdge* edge)
 {
     if (!edge->mirror->Lface)
         return INVALID_INDEX;
@@ -79,15 +83,21 @@ Index Tesselator::GetNeighbourFace(HalfEdge* edge)
     return edge->mirror->Lface->n;
 }
 
-int Tesselator::OutputPolymesh(int elementType, int polySize)
+/* Writes the inside faces as polygons of up to polySize vertices, padded
+ * with INVALID_INDEX. TESS_CONNECTED_POLYGONS follows each polygon with
+ * the polygons across its edges, INVALID_INDEX for the outside.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::OutputPolymesh(TessElementType elementType, int polySize)
 {
     Vertex* v = 0;
     Face* f = 0;
     HalfEdge* edge = 0;
-    int maxFaceCount = 0;
-    int maxVertexCount = 0;
+    size_t maxFaceCount = 0;
+    size_t maxVertexCount = 0;
+    size_t stride = elementType == TESS_CONNECTED_POLYGONS ? size_t(polySize) * 2 : size_t(polySize);
+    size_t vertexBase, elementBase, faceBase;
     int faceVerts, i;
-    Index *elements = 0;
 
     /* Assume that the input data is triangles now.
      * Try to merge as many polygons as possible
@@ -112,7 +122,7 @@ int Tesselator::OutputPolymesh(int elementType, int polySize)
         do {
             v = edge->vertex;
             if (v->n == INVALID_INDEX) {
-                v->n = maxVertexCount;
+                v->n = Index(maxVertexCount);
                 maxVertexCount++;
             }
             faceVerts++;
@@ -121,44 +131,31 @@ int Tesselator::OutputPolymesh(int elementType, int polySize)
 
         assert(faceVerts <= polySize);
 
-        f->n = maxFaceCount;
+        f->n = Index(maxFaceCount);
         ++maxFaceCount;
     }
 
-    //int elementCount = maxFaceCount;
-    if (elementType == TESS_CONNECTED_POLYGONS)
-        maxFaceCount *= 2;
-    //tess->elements = (Index*)tess->alloc.memalloc( tess->alloc.userData,sizeof(Index) * maxFaceCount * polySize );
-    this->elements.resize(maxFaceCount * polySize);
-
-
-    int vertexCount = maxVertexCount;
-    //tess->vertices = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData, sizeof(TESSreal) * tess->vertexCount * vertexSize );
-    this->vertices.resize(vertexCount);
+    if (elementType == TESS_CONNECTED_POLYGONS && outputSink && outputSink->indexSize == 2 &&
+        maxFaceCount > LIBTESS_SHORT_RANGE_VERTICES) {
+        LIBTESS_LOG("Tesselator.Tesselate() : too many polygons for 16-bit indices.");
+        return LIBTESS_ERROR;
+    }
 
-    //tess->vertexIndices = (Index*)tess->alloc.memalloc( tess->alloc.userData, sizeof(Index) * tess->vertexCount );
-    this->indices.resize(vertexCount);
+    // Sized once, after the output of the previous components.
+    if (!this->OutputBegin(maxVertexCount, maxFaceCount * stride, vertexBase, elementBase)) {
+        return LIBTESS_ERROR;
+    }
+    faceBase = elementBase / stride;
 
     // Output vertices.
     for (v = mesh.m_vtxHead.next; v != &mesh.m_vtxHead; v = v->next) {
         if (v->n != INVALID_INDEX) {
-            // Store coordinate
-            #ifdef LIBTESS_USE_VEC3
-            this->vertices[v->n].x = v->coords.x;
-            this->vertices[v->n].y = v->coords.y;
-            this->vertices[v->n].z = v->coords.z;
-            #else
-            this->vertices[v->n].x = v->coords.x;
-            this->vertices[v->n].y = v->coords.y;
-            #endif
-
-            // Store vertex index.
-            this->indices[v->n] = v->idx;
+            v->n += Index(vertexBase);
+            this->WriteVertex(v->n, v->coords.x, v->coords.y, v->coords.z);
         }
     }
 
     // Output indices.
-    elements = &this->elements[0];
     for (f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
         if (!f->inside) continue;
 
@@ -167,26 +164,27 @@ int Tesselator::OutputPolymesh(int elementType, int polySize)
         faceVerts = 0;
         do {
             v = edge->vertex;
-            *elements++ = v->n;
+            this->WriteElement(elementBase++, v->n);
             faceVerts++;
             edge = edge->Lnext;
         } while (edge != f->edge);
 
         // Fill unused.
         for (i = faceVerts; i < polySize; ++i) {
-            *elements++ = INVALID_INDEX;
+            this->WriteElement(elementBase++, INVALID_INDEX);
         }
 
         // Store polygon connectivity
         if (elementType == TESS_CONNECTED_POLYGONS) {
             edge = f->edge;
             do {
-                *elements++ = GetNeighbourFace(edge);
+                Index n = GetNeighbourFace(edge);
+                this->WriteElement(elementBase++, n == INVALID_INDEX ? n : n + Index(faceBase));
                 edge = edge->Lnext;
             } while (edge != f->edge);
             // Fill unused.
             for (i = faceVerts; i < polySize; ++i) {
-                *elements++ = INVALID_INDEX;
+                this->WriteElement(elementBase++, INVALID_INDEX);
             }
         }
     }
@@ -194,8 +192,6 @@ int Tesselator::OutputPolymesh(int elementType, int polySize)
     return LIBTESS_OK;
 }
 
-#endif
-
 }// end namespace libtess
 
 #endif //LIBTESS_CDT_HPP
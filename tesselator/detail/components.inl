@@ -0,0 +1,135 @@
+#ifndef LIBTESS_COMPONENTS_INL
+#define LIBTESS_COMPONENTS_INL
+
+namespace libtess {
+
+template<typename T>
+struct BoundsLess
+{
+    const BasicAABB<T>* bounds;
+
+    bool operator()(Index a, Index b)const
+    {
+        return bounds[a].amin < bounds[b].amin || (bounds[a].amin == bounds[b].amin && a < b);
+    }
+};
+
+template<typename Config>
+LIBTESS_INLINE Index BasicTesselator<Config>::FindComponent(Index contour)
+{
+    Index root = contour;
+    while (componentOf[root] != root) {
+        root = componentOf[root];
+    }
+    while (componentOf[contour] != root) {
+        Index next = componentOf[contour];
+        componentOf[contour] = root;
+        contour = next;
+    }
+    return root;
+}
+
+/* Sweeps each group of contours with overlapping bounds on its own. A
+ * contour adds nothing to the winding numbers outside its bounds, so the
+ * groups do not change each other. The groups are found by sort and
+ * sweep along x, and are swept in the order of their first contour.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::TesselateComponents(TessWindingRule windingRule, TessElementType elementType, int polySize)
+{
+    Index n = Index(contourRings.size() / 2);
+    Index active = 0;
+    bool empty = true;
+
+    componentOf.resize(n);
+    componentOrder.resize(n);
+    for (Index i = 0; i < n; ++i) {
+        componentOf[i] = i;
+        componentOrder[i] = i;
+    }
+
+    /* componentOrder[0, active) are the contours whose x range contains
+     * the left end of the current one
+     */
+    BoundsLess<Float> less = { &contourBounds[0] };
+    std::sort(componentOrder.begin(), componentOrder.end(), less);
+
+    for (Index i = 0; i < n; ++i) {
+        Index c = componentOrder[i];
+        const AABB& b = contourBounds[c];
+        if (b.amin > b.amax) {
+            continue;   /* no points */
+        }
+
+        Index kept = 0;
+        for (Index j = 0; j < active; ++j) {
+            Index other = componentOrder[j];
+            const AABB& o = contourBounds[other];
+            if (o.amax < b.amin) {
+                continue;
+            }
+            componentOrder[kept++] = other;
+            if (b.bmin <= o.bmax && o.bmin <= b.bmax) {
+                Index r1 = this->FindComponent(c);
+                Index r2 = this->FindComponent(other);
+                componentOf[std::max(r1, r2)] = std::min(r1, r2);
+            }
+        }
+        componentOrder[kept++] = c;
+        active = kept;
+    }
+
+    /* the root of a group is its first contour, chain the contours of
+     * each group in componentOrder[0, n) with the tails in [n, 2n)
+     */
+    componentOrder.resize(n * 2);
+    for (Index i = 0; i < n; ++i) {
+        Index root = this->FindComponent(i);
+        componentOrder[i] = INVALID_INDEX;
+        if (root != i) {
+            componentOrder[componentOrder[n + root]] = i;
+        }
+        componentOrder[n + root] = i;
+    }
+
+    for (Index root = 0; root < n; ++root) {
+        if (componentOf[root] != root) {
+            continue;
+        }
+
+        mesh.clear();
+        sweep.clear();
+        for (Index c = root; c != INVALID_INDEX; c = componentOrder[c]) {
+            Index begin = contourRings[c * 2];
+            Index end = contourRings[c * 2 + 1];
+            if (begin < end) {
+                /* keep the vertex numbers of the input order */
+                vertexIndexCounter = begin;
+                if (this->AddMeshContour(3, &contourPoints[begin].x, sizeof(Vec3), end - begin) != LIBTESS_OK) {
+                    return LIBTESS_ERROR;
+                }
+            }
+        }
+
+        if (!mesh.empty()) {
+            empty = false;
+            if (this->SweepMesh(windingRule, elementType, polySize) != LIBTESS_OK) {
+                return LIBTESS_ERROR;
+            }
+        }
+    }
+
+    if (empty) {
+        LIBTESS_LOG("Tesselator.Tesselate() : mesh is empty.");
+        return LIBTESS_ERROR;
+    }
+
+    vertexIndexCounter = Index(contourPoints.size());
+    this->release();
+
+    return LIBTESS_OK;
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_COMPONENTS_INL
@@ -0,0 +1,252 @@
+#ifndef LIBTESS_CONVEX_HPP
+#define LIBTESS_CONVEX_HPP
+
+namespace libtess {
+
+template<typename T>
+LIBTESS_INLINE int Sign(T value)
+{
+    return (value > 0) - (value < 0);
+}
+
+/* Returns the orientation of a strictly convex contour in the x-y plane,
+ * 1 for CCW and -1 for CW, or 0 if the contour is not strictly convex.
+ *
+ * All turns must have the same sign, and the edge directions may change
+ * sign at most twice in x and in y, which rejects self-overlapping
+ * contours such as a pentagram. Repeated and collinear vertices are
+ * rejected, the sweep is left to deal with them.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::ClassifyConvex(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    const unsigned char *src = (const unsigned char*) pointer;
+    const Float *first, *last;
+    Float px, py, dx, dy, ex, ey;
+    int orientation = 0;
+    int xsign, ysign, xflips = 0, yflips = 0;
+
+    (void) dimension;
+    if (count < 3) {
+        return 0;
+    }
+
+    first = (const Float*) src;
+    last = (const Float*) (src + stride * (count - 1));
+    px = last[0];
+    py = last[1];
+    dx = first[0] - px;
+    dy = first[1] - py;
+    xsign = Sign(dx);
+    ysign = Sign(dy);
+
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        const Float* coords = (const Float*) src;
+        const Float* next = (i + 1 < count) ? (const Float*) (src + stride) : first;
+
+        ex = next[0] - coords[0];
+        ey = next[1] - coords[1];
+
+        int turn = Sign(dx * ey - dy * ex);
+        if (turn == 0 || turn == -orientation) {
+            return 0;
+        }
+        orientation = turn;
+
+        int sx = Sign(ex);
+        int sy = Sign(ey);
+        if (sx) {
+            xflips += (sx == -xsign);
+            xsign = sx;
+        }
+        if (sy) {
+            yflips += (sy == -ysign);
+            ysign = sy;
+        }
+        if (xflips > 2 || yflips > 2) {
+            return 0;
+        }
+
+        dx = ex;
+        dy = ey;
+    }
+
+    return orientation;
+}
+
+/* Decides if a contour can be kept out of the mesh. The first contour
+ * qualifies if it is strictly convex. With TESS_ENGINE_AUTO, the next ones
+ * qualify for ear clipping if they are strictly convex, strictly inside
+ * the first contour and their bounds do not touch the bounds of the
+ * other holes, so the polygon is simple and its holes are disjoint.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicTesselator<Config>::KeepContour(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    const unsigned char *src = (const unsigned char*) pointer;
+    AABB bounds;
+
+    if (contourRings.empty()) {
+        convexOrientation = this->ClassifyConvex(dimension, pointer, stride, count);
+        return convexOrientation != 0;
+    }
+
+    if (engine != TESS_ENGINE_AUTO || !convexOrientation) {
+        return false;
+    }
+
+    /* bridging the holes is quadratic, and every hole is tested against
+     * the others below
+     */
+    if (contourBounds.size() > LIBTESS_AUTO_EARCUT_HOLES) {
+        return false;
+    }
+
+    if (!this->ClassifyConvex(dimension, pointer, stride, count)) {
+        return false;
+    }
+
+    bounds.amin = bounds.bmin = FLT_MAX;
+    bounds.amax = bounds.bmax = -FLT_MAX;
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        const Float* coords = (const Float*) src;
+        if (!this->PointInOutline(coords[0], coords[1])) {
+            return false;
+        }
+        bounds.amin = std::min(bounds.amin, coords[0]);
+        bounds.amax = std::max(bounds.amax, coords[0]);
+        bounds.bmin = std::min(bounds.bmin, coords[1]);
+        bounds.bmax = std::max(bounds.bmax, coords[1]);
+    }
+
+    for (size_t i = 1; i < contourBounds.size(); ++i) {
+        const AABB& other = contourBounds[i];
+        if (bounds.amin <= other.amax && other.amin <= bounds.amax &&
+            bounds.bmin <= other.bmax && other.bmin <= bounds.bmax) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Tests if a point is strictly inside the first contour, which is
+ * strictly convex. Binary search over the fan of its first vertex.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicTesselator<Config>::PointInOutline(double x, double y)
+{
+    const Vec3* v = &contourPoints[contourRings[0]];
+    Index n = contourRings[1] - contourRings[0];
+    double o = convexOrientation;
+    double px = x - v[0].x;
+    double py = y - v[0].y;
+    Index lo = 1, hi = n - 1;
+
+    #define LIBTESS_FAN_SIDE(i) (o * ((v[i].x - v[0].x) * py - (v[i].y - v[0].y) * px))
+
+    if (LIBTESS_FAN_SIDE(1) <= 0 || LIBTESS_FAN_SIDE(n - 1) >= 0) {
+        return false;
+    }
+
+    /* find the wedge v[0], v[lo], v[lo + 1] that contains the point */
+    while (hi - lo > 1) {
+        Index mid = (lo + hi) / 2;
+        if (LIBTESS_FAN_SIDE(mid) > 0) {
+            lo = mid;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    #undef LIBTESS_FAN_SIDE
+
+    return o * ((double(v[hi].x) - v[lo].x) * (y - v[lo].y) - (double(v[hi].y) - v[lo].y) * (x - v[lo].x)) > 0;
+}
+
+/* Writes the lone convex contour as a triangle fan, or a zigzag strip for
+ * TESS_TRIANGLE_STRIPS, without building the mesh. The output is equivalent
+ * to the sweep's, not identical: it covers the same area with the same
+ * winding classification and CW triangles in the x-y plane, but the
+ * diagonals, the order of the triangles and the order of the vertices
+ * within them differ.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::RenderConvex(TessWindingRule windingRule, TessElementType elementType)
+{
+    /* s = y, t = x mirrors the plane, so a CCW contour has winding -1 in
+     * the sweep plane.
+     */
+    int winding = convexOrientation > 0 ? -1 : 1;
+    Index n = Index(contourPoints.size());
+
+    if (this->reverseContours) {
+        winding = -winding;
+    }
+
+    if (IsWindingInside(windingRule, winding) && elementType == TESS_TRIANGLE_STRIPS) {
+        /* one zigzag strip 0, 1, n-1, 2, n-2, ..., mirrored to 0, n-1, 1, ...
+         * for the orientation of the fan
+         */
+        size_t vertexBase, e, length = 0;
+        Index front = 1, back = n - 1;
+        stripElements.clear();
+        for (Index i = 0; i < n; ++i) {
+            bool takeFront = ((i & 1) != 0) == (convexOrientation < 0);
+            this->AppendStrip(i == 0 ? 0 : takeFront ? front++ : back--, length);
+        }
+
+        if (!this->OutputBegin(n, stripElements.size(), vertexBase, e)) {
+            this->release();
+            return LIBTESS_ERROR;
+        }
+        for (Index i = 0; i < n; ++i) {
+            const Vec3& v = contourPoints[i];
+            this->WriteVertex(i, v.x, v.y, v.z);
+        }
+        for (size_t i = 0; i < stripElements.size(); ++i) {
+            this->WriteElement(e + i, stripElements[i]);
+        }
+    }
+    else if (IsWindingInside(windingRule, winding)) {
+        size_t vertexBase, e;
+        if (!this->OutputBegin(n, n > 2 ? (n - 2) * 3 : 0, vertexBase, e)) {
+            this->release();
+            return LIBTESS_ERROR;
+        }
+
+        for (Index i = 0; i < n; ++i) {
+            const Vec3& v = contourPoints[i];
+            this->WriteVertex(i, v.x, v.y, v.z);
+        }
+
+        for (Index i = 1; i + 1 < n; ++i) {
+            this->WriteElement(e++, 0);
+            if (convexOrientation > 0) {
+                this->WriteElement(e++, i + 1);
+                this->WriteElement(e++, i);
+            }
+            else {
+                this->WriteElement(e++, i);
+                this->WriteElement(e++, i + 1);
+            }
+        }
+    }
+    else {
+        /* the contour is outside, the sink still gets an empty output */
+        size_t vertexBase, e;
+        if (!this->OutputBegin(0, 0, vertexBase, e)) {
+            this->release();
+            return LIBTESS_ERROR;
+        }
+    }
+
+    this->release();
+
+    return LIBTESS_OK;
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_CONVEX_HPP
@@ -47,16 +47,28 @@ typedef void *DictKey;
 
 typedef int (*PFN_DICTKEY_COMPARE)(void *frame, DictKey key1, DictKey key2);
 
+/* The nodes are always kept in a doubly-linked list, so the sweep can walk
+ * to the neighbour regions in O(1) (see RegionAbove/RegionBelow).
+ * With Config::DICT_TREE the same nodes are also linked into an intrusive
+ * red-black tree, which turns find() into an O(log n) search. The tree links
+ * are there either way, so the node is the same for every configuration.
+ */
 struct DictNode
 {
     DictKey    key;
     DictNode *next;
     DictNode *prev;
 
-    DictNode() : key(), next(), prev() {}
+    DictNode *parent;
+    DictNode *left;
+    DictNode *right;
+    Bool red;
+
+    DictNode() : key(), next(), prev(), parent(), left(), right(), red() {}
 };
 
-class Dict
+template<typename Config>
+class BasicDict
 {
 protected:
     //head.next == first node;
@@ -64,15 +76,18 @@ protected:
     DictNode head;
     void *frame;
     PFN_DICTKEY_COMPARE comp;
+    DictNode *root;    /* NULL without Config::DICT_TREE */
 
-    pool<DictNode, LIBTESS_PAGE_SIZE> poolbuf;
+    pool<DictNode, Config::PAGE_SIZE> poolbuf;
+    allocator<DictNode> nodealloc;    /* one node per allocation without the pool */
 
 public:
-    Dict();
-    ~Dict();
+    explicit BasicDict(Allocator* a = NULL);
+    ~BasicDict();
 
     void init(void *_frame, PFN_DICTKEY_COMPARE pfn);
     void dispose();
+    void clear();
 
     DictNode* insert(DictNode *node, DictKey key);
     DictNode* insert(DictKey key) { return this->insert(&head, key); }
@@ -82,22 +97,28 @@ public:
     DictNode* max();
 
 protected:
+    void tree_link(DictNode *node, DictNode *newNode);
+    void tree_unlink(DictNode *node);
+    void rotate_left(DictNode *x);
+    void rotate_right(DictNode *x);
+
     DictNode* allocate()
     {
-        #ifdef LIBTESS_USE_POOL
-        return poolbuf.allocate();
-        #else
-        return new DictNode;
-        #endif
+        if (Config::USE_POOL) {
+            return poolbuf.allocate();
+        }
+        return new (nodealloc.allocate(1)) DictNode();
     }
 
     void deallocate(DictNode* n)
     {
-        #ifdef LIBTESS_USE_POOL
-        poolbuf.deallocate(n);
-        #else
-        delete n;
-        #endif
+        if (Config::USE_POOL) {
+            poolbuf.deallocate(n);
+        }
+        else {
+            n->~DictNode();
+            nodealloc.deallocate(n, 1);
+        }
     }
 };
 
@@ -114,17 +135,20 @@ LIBTESS_INLINE DictKey dictKey(DictNode* n)
 
 // Dict
 
-LIBTESS_INLINE Dict::Dict() : head(), frame(), comp()
+template<typename Config>
+LIBTESS_INLINE BasicDict<Config>::BasicDict(Allocator* a) : head(), frame(), comp(), root(), poolbuf(a), nodealloc(a)
 {
 
 }
 
-LIBTESS_INLINE Dict::~Dict()
+template<typename Config>
+LIBTESS_INLINE BasicDict<Config>::~BasicDict()
 {
     this->dispose();
 }
 
-LIBTESS_INLINE void Dict::init(void *_frame, PFN_DICTKEY_COMPARE pfn)
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::init(void *_frame, PFN_DICTKEY_COMPARE pfn)
 {
     head.key = NULL;
     head.next = &head;
@@ -132,24 +156,49 @@ LIBTESS_INLINE void Dict::init(void *_frame, PFN_DICTKEY_COMPARE pfn)
 
     frame = _frame;
     comp = pfn;
+
+    root = NULL;
 }
 
-LIBTESS_INLINE void Dict::dispose()
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::dispose()
 {
-    #ifdef LIBTESS_USE_POOL
-    poolbuf.dispose();
-    #else
-    DictNode* node = head.next;
-    DictNode* next;
-    while (node && node != &head) {
-        next = node->next;
-        delete node;
-        node = next;
+    if (Config::USE_POOL) {
+        poolbuf.dispose();
     }
-    #endif
+    else {
+        DictNode* node = head.next;
+        DictNode* next;
+        while (node && node != &head) {
+            next = node->next;
+            this->deallocate(node);
+            node = next;
+        }
+    }
+
+    head.next = &head;
+    head.prev = &head;
+    root = NULL;
+}
+
+/* Removes all nodes, the pool pages are kept.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::clear()
+{
+    if (!Config::USE_POOL) {
+        this->dispose();
+        return;
+    }
+
+    poolbuf.clear();
+    head.next = &head;
+    head.prev = &head;
+    root = NULL;
 }
 
-LIBTESS_INLINE DictNode * Dict::insert(DictNode *node, DictKey key)
+template<typename Config>
+LIBTESS_INLINE DictNode * BasicDict<Config>::insert(DictNode *node, DictKey key)
 {
     DictNode *newNode;
 
@@ -161,6 +210,14 @@ LIBTESS_INLINE DictNode * Dict::insert(DictNode *node, DictKey key)
     if (newNode == NULL) return NULL;
 
     newNode->key = key;
+
+    if (Config::DICT_TREE) {
+        /* The position is already known, so the tree is linked without
+         * any further key comparisons.
+         */
+        tree_link(node, newNode);
+    }
+
     newNode->next = node->next;
     node->next->prev = newNode;
     newNode->prev = node;
@@ -169,15 +226,43 @@ LIBTESS_INLINE DictNode * Dict::insert(DictNode *node, DictKey key)
     return newNode;
 }
 
-LIBTESS_INLINE void Dict::erase(DictNode *node)
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::erase(DictNode *node)
 {
+    if (Config::DICT_TREE) {
+        tree_unlink(node);
+    }
+
     node->next->prev = node->prev;
     node->prev->next = node->next;
     this->deallocate(node);
 }
 
-LIBTESS_INLINE DictNode * Dict::find(DictKey key)
+/* Returns the first node (from the bottom) whose key is not below "key",
+ * or the head if there is none.  The dictionary invariants keep the
+ * comparison monotone along the list, so the tree search finds the
+ * same node as the linear walk does.
+ */
+template<typename Config>
+LIBTESS_INLINE DictNode * BasicDict<Config>::find(DictKey key)
 {
+    if (Config::DICT_TREE) {
+        DictNode *node = root;
+        DictNode *result = &head;
+
+        while (node) {
+            if ((*comp)(frame, key, node->key)) {
+                result = node;
+                node = node->left;
+            }
+            else {
+                node = node->right;
+            }
+        }
+
+        return result;
+    }
+
     DictNode *node = &head;
 
     do {
@@ -187,16 +272,244 @@ LIBTESS_INLINE DictNode * Dict::find(DictKey key)
     return node;
 }
 
-LIBTESS_INLINE DictNode* Dict::min()
+template<typename Config>
+LIBTESS_INLINE DictNode* BasicDict<Config>::min()
 {
     return head.next;
 }
 
-LIBTESS_INLINE DictNode* Dict::max()
+template<typename Config>
+LIBTESS_INLINE DictNode* BasicDict<Config>::max()
 {
     return head.prev;
 }
 
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::rotate_left(DictNode *x)
+{
+    DictNode *y = x->right;
+
+    x->right = y->left;
+    if (y->left) y->left->parent = x;
+    y->parent = x->parent;
+
+    if (x == root) root = y;
+    else if (x == x->parent->left) x->parent->left = y;
+    else x->parent->right = y;
+
+    y->left = x;
+    x->parent = y;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::rotate_right(DictNode *x)
+{
+    DictNode *y = x->left;
+
+    x->left = y->right;
+    if (y->right) y->right->parent = x;
+    y->parent = x->parent;
+
+    if (x == root) root = y;
+    else if (x == x->parent->right) x->parent->right = y;
+    else x->parent->left = y;
+
+    y->right = x;
+    x->parent = y;
+}
+
+/* Links newNode into the tree so that it directly follows "node" in the
+ * in-order sequence ("node" may be the head, ie. newNode becomes the
+ * minimum).  Must be called before newNode is linked into the list.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::tree_link(DictNode *node, DictNode *newNode)
+{
+    DictNode *x, *y;
+
+    newNode->left = newNode->right = NULL;
+    newNode->red = TRUE;
+
+    if (root == NULL) {
+        newNode->parent = NULL;
+        newNode->red = FALSE;
+        root = newNode;
+        return;
+    }
+
+    if (node != &head && node->right == NULL) {
+        node->right = newNode;
+        newNode->parent = node;
+    }
+    else {
+        /* The successor is the leftmost node of node->right (or the tree
+         * minimum), so its left link is always free.
+         */
+        y = node->next;
+        assert(y != &head && y->left == NULL);
+        y->left = newNode;
+        newNode->parent = y;
+    }
+
+    /* rebalance */
+    x = newNode;
+    while (x != root && x->parent->red) {
+        DictNode *xp = x->parent;
+        DictNode *xpp = xp->parent;
+        if (xp == xpp->left) {
+            y = xpp->right;
+            if (y && y->red) {
+                xp->red = FALSE;
+                y->red = FALSE;
+                xpp->red = TRUE;
+                x = xpp;
+            }
+            else {
+                if (x == xp->right) {
+                    x = xp;
+                    rotate_left(x);
+                    xp = x->parent;
+                }
+                xp->red = FALSE;
+                xpp->red = TRUE;
+                rotate_right(xpp);
+            }
+        }
+        else {
+            y = xpp->left;
+            if (y && y->red) {
+                xp->red = FALSE;
+                y->red = FALSE;
+                xpp->red = TRUE;
+                x = xpp;
+            }
+            else {
+                if (x == xp->left) {
+                    x = xp;
+                    rotate_right(x);
+                    xp = x->parent;
+                }
+                xp->red = FALSE;
+                xpp->red = TRUE;
+                rotate_left(xpp);
+            }
+        }
+    }
+    root->red = FALSE;
+}
+
+/* Removes z from the tree.  Must be called while z is still in the list
+ * (z->next is used as the in-order successor).
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicDict<Config>::tree_unlink(DictNode *z)
+{
+    DictNode *y = z;
+    DictNode *x, *xParent, *w;
+    Bool removedRed;
+
+    if (z->left && z->right) {
+        /* two children -- move the successor into z's place */
+        y = z->next;
+        x = y->right;
+
+        z->left->parent = y;
+        y->left = z->left;
+        if (y != z->right) {
+            xParent = y->parent;
+            if (x) x->parent = xParent;
+            xParent->left = x;
+            y->right = z->right;
+            z->right->parent = y;
+        }
+        else {
+            xParent = y;
+        }
+
+        if (z == root) root = y;
+        else if (z->parent->left == z) z->parent->left = y;
+        else z->parent->right = y;
+        y->parent = z->parent;
+
+        removedRed = y->red;
+        y->red = z->red;
+    }
+    else {
+        x = z->left ? z->left : z->right;
+        xParent = z->parent;
+        if (x) x->parent = xParent;
+
+        if (z == root) root = x;
+        else if (xParent->left == z) xParent->left = x;
+        else xParent->right = x;
+
+        removedRed = z->red;
+    }
+
+    if (removedRed) {
+        return;
+    }
+
+    /* rebalance */
+    while (x != root && (x == NULL || !x->red)) {
+        if (x == xParent->left) {
+            w = xParent->right;
+            if (w->red) {
+                w->red = FALSE;
+                xParent->red = TRUE;
+                rotate_left(xParent);
+                w = xParent->right;
+            }
+            if ((w->left == NULL || !w->left->red) && (w->right == NULL || !w->right->red)) {
+                w->red = TRUE;
+                x = xParent;
+                xParent = xParent->parent;
+            }
+            else {
+                if (w->right == NULL || !w->right->red) {
+                    w->left->red = FALSE;
+                    w->red = TRUE;
+                    rotate_right(w);
+                    w = xParent->right;
+                }
+                w->red = xParent->red;
+                xParent->red = FALSE;
+                if (w->right) w->right->red = FALSE;
+                rotate_left(xParent);
+                break;
+            }
+        }
+        else {
+            w = xParent->left;
+            if (w->red) {
+                w->red = FALSE;
+                xParent->red = TRUE;
+                rotate_right(xParent);
+                w = xParent->left;
+            }
+            if ((w->right == NULL || !w->right->red) && (w->left == NULL || !w->left->red)) {
+                w->red = TRUE;
+                x = xParent;
+                xParent = xParent->parent;
+            }
+            else {
+                if (w->left == NULL || !w->left->red) {
+                    w->right->red = FALSE;
+                    w->red = TRUE;
+                    rotate_left(w);
+                    w = xParent->left;
+                }
+                w->red = xParent->red;
+                xParent->red = FALSE;
+                if (w->left) w->left->red = FALSE;
+                rotate_right(xParent);
+                break;
+            }
+        }
+    }
+    if (x) x->red = FALSE;
+}
+
 }// end namespace libtess
 
 #endif// LIBTESS_DICT_HPP
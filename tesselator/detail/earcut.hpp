@@ -0,0 +1,851 @@
+/*
+ * Ear clipping triangulation of simple polygons with holes.
+ *
+ * The algorithm follows mapbox/earcut (ISC License, Copyright (c) 2016
+ * Mapbox): holes are bridged into the outer ring with David Eberly's
+ * method, and big polygons look up the points inside a candidate ear
+ * through a z-order curve. It does not handle self-intersections.
+ */
+
+#ifndef LIBTESS_EARCUT_HPP
+#define LIBTESS_EARCUT_HPP
+
+#include "public.h"
+
+namespace libtess {
+
+template<typename Config>
+class BasicEarcut
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+    /* Rings with more points than this are hashed with a z-order curve.
+     */
+    enum { HASH_MIN = 80 };
+
+private:
+    struct Node
+    {
+        Index i;            /* index of the point */
+        double x, y;
+        Node *prev, *next;  /* polygon ring */
+        int32_t z;          /* z-order curve value */
+        Node *prevZ, *nextZ;/* nodes in z-order */
+        bool steiner;       /* a hole of one point */
+
+        Node() : i(), x(), y(), prev(), next(), z(), prevZ(), nextZ(), steiner() {}
+    };
+
+    struct NodeLess
+    {
+        bool operator()(const Node* a, const Node* b)const
+        {
+            return a->x < b->x || (a->x == b->x && a->y < b->y);
+        }
+    };
+
+    pool<Node, Config::PAGE_SIZE> nodebuf;
+    std::vector<Node*, allocator<Node*> > queue;
+    const Vec3* points;
+    std::vector<Index, allocator<Index> >* triangles;
+    double minX, minY, invSize;
+
+public:
+    explicit BasicEarcut(Allocator* a = NULL) :
+        nodebuf(a), queue(allocator<Node*>(a)), points(), triangles(), minX(), minY(), invSize()
+    {
+    }
+
+    /* Triangulates the ring points[rings[0], rings[1]) with the holes
+     * points[rings[2], rings[3]), ... and appends the triangles to output
+     * as point indices. Triangles are CW in the x-y plane, like the
+     * triangles of the sweep.
+     */
+    void triangulate(const Vec3* data, const Index* rings, size_t ringCount, std::vector<Index, allocator<Index> >& output);
+
+    void clear()
+    {
+        nodebuf.clear();
+        queue.clear();
+    }
+
+    void dispose()
+    {
+        nodebuf.dispose();
+        std::vector<Node*, allocator<Node*> >(queue.get_allocator()).swap(queue);
+    }
+
+private:
+    Node* LinkedList(Index begin, Index end, bool clockwise);
+    Node* FilterPoints(Node* start, Node* end = NULL);
+    void EarcutLinked(Node* ear, int pass);
+    bool IsEar(Node* ear);
+    bool IsEarHashed(Node* ear);
+    Node* CureLocalIntersections(Node* start);
+    void SplitEarcut(Node* start);
+    Node* EliminateHoles(const Index* rings, size_t ringCount, Node* outerNode);
+    Node* EliminateHole(Node* hole, Node* outerNode);
+    Node* FindHoleBridge(Node* hole, Node* outerNode);
+    void IndexCurve(Node* start);
+    Node* SortLinked(Node* list);
+    int32_t ZOrder(double x, double y);
+    bool IsValidDiagonal(Node* a, Node* b);
+    bool IntersectsPolygon(Node* a, Node* b);
+    bool MiddleInside(Node* a, Node* b);
+    Node* SplitPolygon(Node* a, Node* b);
+    Node* InsertNode(Index i, Node* last);
+    void RemoveNode(Node* p);
+
+    void AddTriangle(Node* a, Node* b, Node* c)
+    {
+        triangles->push_back(c->i);
+        triangles->push_back(b->i);
+        triangles->push_back(a->i);
+    }
+
+    static Node* GetLeftmost(Node* start);
+    static bool SectorContainsSector(Node* m, Node* p);
+    static bool PointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py);
+    static double Area(Node* p, Node* q, Node* r);
+    static bool Equals(Node* p1, Node* p2);
+    static bool Intersects(Node* p1, Node* q1, Node* p2, Node* q2);
+    static bool OnSegment(Node* p, Node* q, Node* r);
+    static int Sign(double value);
+    static bool LocallyInside(Node* a, Node* b);
+};
+
+//
+// source
+//
+
+template<typename Config>
+LIBTESS_INLINE void BasicEarcut<Config>::triangulate(const Vec3* data, const Index* rings, size_t ringCount, std::vector<Index, allocator<Index> >& output)
+{
+    Node *outerNode;
+    Index count = 0;
+
+    points = data;
+    triangles = &output;
+    invSize = 0;
+
+    if (ringCount == 0) {
+        return;
+    }
+
+    outerNode = LinkedList(rings[0], rings[1], true);
+    if (!outerNode || outerNode->next == outerNode->prev) {
+        this->clear();
+        return;
+    }
+
+    for (size_t i = 0; i < ringCount; ++i) {
+        count += rings[i * 2 + 1] - rings[i * 2];
+    }
+
+    if (ringCount > 1) {
+        outerNode = EliminateHoles(rings + 2, ringCount - 1, outerNode);
+    }
+
+    /* If the shape is not too simple, the z-order curve hash is used
+     * later. It is computed from the bounding box of the outer ring.
+     */
+    if (count > HASH_MIN) {
+        double maxX, maxY;
+        minX = maxX = data[rings[0]].x;
+        minY = maxY = data[rings[0]].y;
+        for (Index i = rings[0] + 1; i < rings[1]; ++i) {
+            double x = data[i].x;
+            double y = data[i].y;
+            if (x < minX) minX = x;
+            if (y < minY) minY = y;
+            if (x > maxX) maxX = x;
+            if (y > maxY) maxY = y;
+        }
+        invSize = std::max(maxX - minX, maxY - minY);
+        invSize = invSize != 0 ? 32767 / invSize : 0;
+    }
+
+    EarcutLinked(outerNode, 0);
+
+    this->clear();
+}
+
+/* Creates a circular doubly linked list from the ring, in the specified
+ * winding order.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::LinkedList(Index begin, Index end, bool clockwise)
+{
+    Node* last = NULL;
+    double sum = 0;
+
+    for (Index i = begin, j = end - 1; i < end; j = i++) {
+        sum += (points[j].x - points[i].x) * (points[i].y + points[j].y);
+    }
+
+    if (clockwise == (sum > 0)) {
+        for (Index i = begin; i < end; ++i) {
+            last = InsertNode(i, last);
+        }
+    }
+    else {
+        for (Index i = end - 1; i >= begin; --i) {
+            last = InsertNode(i, last);
+        }
+    }
+
+    if (last && Equals(last, last->next)) {
+        RemoveNode(last);
+        last = last->next;
+    }
+
+    return last;
+}
+
+/* Eliminates colinear or duplicate points.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::FilterPoints(Node* start, Node* end)
+{
+    Node *p;
+    bool again;
+
+    if (!start) {
+        return start;
+    }
+    if (!end) {
+        end = start;
+    }
+
+    p = start;
+    do {
+        again = false;
+
+        if (!p->steiner && (Equals(p, p->next) || Area(p->prev, p, p->next) == 0)) {
+            RemoveNode(p);
+            p = end = p->prev;
+            if (p == p->next) {
+                break;
+            }
+            again = true;
+        }
+        else {
+            p = p->next;
+        }
+    } while (again || p != end);
+
+    return end;
+}
+
+/* Main ear slicing loop which triangulates a polygon (given as a linked list).
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicEarcut<Config>::EarcutLinked(Node* ear, int pass)
+{
+    Node *stop, *prev, *next;
+
+    if (!ear) {
+        return;
+    }
+
+    /* interlink polygon nodes in z-order */
+    if (!pass && invSize) {
+        IndexCurve(ear);
+    }
+
+    stop = ear;
+
+    /* iterate through ears, slicing them one by one */
+    while (ear->prev != ear->next) {
+        prev = ear->prev;
+        next = ear->next;
+
+        if (invSize ? IsEarHashed(ear) : IsEar(ear)) {
+            AddTriangle(prev, ear, next);
+            RemoveNode(ear);
+
+            /* skipping the next vertex leads to less sliver triangles */
+            ear = next->next;
+            stop = next->next;
+            continue;
+        }
+
+        ear = next;
+
+        /* if we looped through the whole remaining polygon and can't find any more ears */
+        if (ear == stop) {
+            if (!pass) {
+                /* try filtering points and slicing again */
+                EarcutLinked(FilterPoints(ear), 1);
+            }
+            else if (pass == 1) {
+                /* if this didn't work, try curing all small self-intersections locally */
+                ear = CureLocalIntersections(FilterPoints(ear));
+                EarcutLinked(ear, 2);
+            }
+            else if (pass == 2) {
+                /* as a last resort, try splitting the remaining polygon into two */
+                SplitEarcut(ear);
+            }
+            break;
+        }
+    }
+}
+
+/* Checks whether a polygon node forms a valid ear with adjacent nodes.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::IsEar(Node* ear)
+{
+    Node *a = ear->prev, *b = ear, *c = ear->next;
+
+    if (Area(a, b, c) >= 0) {
+        return false; /* reflex, can't be an ear */
+    }
+
+    /* now make sure we don't have other points inside the potential ear */
+    double x0 = std::min(a->x, std::min(b->x, c->x));
+    double y0 = std::min(a->y, std::min(b->y, c->y));
+    double x1 = std::max(a->x, std::max(b->x, c->x));
+    double y1 = std::max(a->y, std::max(b->y, c->y));
+
+    for (Node* p = c->next; p != a; p = p->next) {
+        if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+            PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+            Area(p->prev, p, p->next) >= 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::IsEarHashed(Node* ear)
+{
+    Node *a = ear->prev, *b = ear, *c = ear->next;
+
+    if (Area(a, b, c) >= 0) {
+        return false; /* reflex, can't be an ear */
+    }
+
+    double x0 = std::min(a->x, std::min(b->x, c->x));
+    double y0 = std::min(a->y, std::min(b->y, c->y));
+    double x1 = std::max(a->x, std::max(b->x, c->x));
+    double y1 = std::max(a->y, std::max(b->y, c->y));
+
+    /* z-order range for the current triangle bbox */
+    int32_t minZ = ZOrder(x0, y0);
+    int32_t maxZ = ZOrder(x1, y1);
+
+    Node *p = ear->prevZ;
+    Node *n = ear->nextZ;
+
+    #define LIBTESS_EARCUT_INSIDE(p) \
+        ((p)->x >= x0 && (p)->x <= x1 && (p)->y >= y0 && (p)->y <= y1 && (p) != a && (p) != c && \
+         PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, (p)->x, (p)->y) && \
+         Area((p)->prev, (p), (p)->next) >= 0)
+
+    /* look for points inside the triangle in both directions */
+    while (p && p->z >= minZ && n && n->z <= maxZ) {
+        if (LIBTESS_EARCUT_INSIDE(p)) return false;
+        p = p->prevZ;
+
+        if (LIBTESS_EARCUT_INSIDE(n)) return false;
+        n = n->nextZ;
+    }
+
+    /* look for remaining points in decreasing z-order */
+    while (p && p->z >= minZ) {
+        if (LIBTESS_EARCUT_INSIDE(p)) return false;
+        p = p->prevZ;
+    }
+
+    /* look for remaining points in increasing z-order */
+    while (n && n->z <= maxZ) {
+        if (LIBTESS_EARCUT_INSIDE(n)) return false;
+        n = n->nextZ;
+    }
+
+    #undef LIBTESS_EARCUT_INSIDE
+
+    return true;
+}
+
+/* Goes through all polygon nodes and cures small local self-intersections.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::CureLocalIntersections(Node* start)
+{
+    Node* p = start;
+
+    do {
+        Node* a = p->prev;
+        Node* b = p->next->next;
+
+        if (!Equals(a, b) && Intersects(a, p, p->next, b) && LocallyInside(a, b) && LocallyInside(b, a)) {
+            AddTriangle(a, p, b);
+
+            /* remove two nodes involved */
+            RemoveNode(p);
+            RemoveNode(p->next);
+
+            p = start = b;
+        }
+        p = p->next;
+    } while (p != start);
+
+    return FilterPoints(p);
+}
+
+/* Tries splitting the polygon into two and triangulates them independently.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicEarcut<Config>::SplitEarcut(Node* start)
+{
+    Node* a = start;
+
+    do {
+        Node* b = a->next->next;
+        while (b != a->prev) {
+            if (a->i != b->i && IsValidDiagonal(a, b)) {
+                /* split the polygon in two by the diagonal */
+                Node* c = SplitPolygon(a, b);
+
+                /* filter colinear points around the cuts */
+                a = FilterPoints(a, a->next);
+                c = FilterPoints(c, c->next);
+
+                /* run earcut on each half */
+                EarcutLinked(a, 0);
+                EarcutLinked(c, 0);
+                return;
+            }
+            b = b->next;
+        }
+        a = a->next;
+    } while (a != start);
+}
+
+/* Links every hole into the outer loop, producing a single-ring polygon
+ * without holes.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::EliminateHoles(const Index* rings, size_t ringCount, Node* outerNode)
+{
+    queue.clear();
+
+    for (size_t i = 0; i < ringCount; ++i) {
+        Node* list = LinkedList(rings[i * 2], rings[i * 2 + 1], false);
+        if (!list) {
+            continue;
+        }
+        if (list == list->next) {
+            list->steiner = true;
+        }
+        queue.push_back(GetLeftmost(list));
+    }
+
+    std::sort(queue.begin(), queue.end(), NodeLess());
+
+    /* process holes from left to right */
+    for (size_t i = 0; i < queue.size(); ++i) {
+        outerNode = EliminateHole(queue[i], outerNode);
+    }
+
+    return outerNode;
+}
+
+/* Finds a bridge between vertices that connects hole with an outer ring
+ * and links it.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::EliminateHole(Node* hole, Node* outerNode)
+{
+    Node* bridge = FindHoleBridge(hole, outerNode);
+    if (!bridge) {
+        return outerNode;
+    }
+
+    Node* bridgeReverse = SplitPolygon(bridge, hole);
+
+    /* filter collinear points around the cuts */
+    FilterPoints(bridgeReverse, bridgeReverse->next);
+    return FilterPoints(bridge, bridge->next);
+}
+
+/* David Eberly's algorithm for finding a bridge between hole and outer polygon.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::FindHoleBridge(Node* hole, Node* outerNode)
+{
+    Node* p = outerNode;
+    Node* m = NULL;
+    double hx = hole->x;
+    double hy = hole->y;
+    double qx = -DBL_MAX;
+
+    /* find a segment intersected by a ray from the hole's leftmost point to the left;
+     * segment's endpoint with lesser x will be potential connection point
+     */
+    do {
+        if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+            double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+            if (x <= hx && x > qx) {
+                qx = x;
+                m = p->x < p->next->x ? p : p->next;
+                if (x == hx) {
+                    return m; /* hole touches outer segment; pick leftmost endpoint */
+                }
+            }
+        }
+        p = p->next;
+    } while (p != outerNode);
+
+    if (!m) {
+        return NULL;
+    }
+
+    /* look for points inside the triangle of hole point, segment intersection and endpoint;
+     * if there are no points found, we have a valid connection;
+     * otherwise choose the point of the minimum angle with the ray as connection point
+     */
+    Node* stop = m;
+    double mx = m->x;
+    double my = m->y;
+    double tanMin = DBL_MAX;
+
+    p = m;
+    do {
+        if (hx >= p->x && p->x >= mx && hx != p->x &&
+            PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+            double tan = fabs(hy - p->y) / (hx - p->x); /* tangential */
+
+            if (LocallyInside(p, hole) && (tan < tanMin || (tan == tanMin &&
+                (p->x > m->x || (p->x == m->x && SectorContainsSector(m, p)))))) {
+                m = p;
+                tanMin = tan;
+            }
+        }
+        p = p->next;
+    } while (p != stop);
+
+    return m;
+}
+
+/* Interlinks polygon nodes in z-order.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicEarcut<Config>::IndexCurve(Node* start)
+{
+    Node* p = start;
+
+    do {
+        if (p->z == 0) {
+            p->z = ZOrder(p->x, p->y);
+        }
+        p->prevZ = p->prev;
+        p->nextZ = p->next;
+        p = p->next;
+    } while (p != start);
+
+    p->prevZ->nextZ = NULL;
+    p->prevZ = NULL;
+
+    SortLinked(p);
+}
+
+/* Simon Tatham's linked list merge sort algorithm.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::SortLinked(Node* list)
+{
+    Node *p, *q, *e, *tail;
+    int numMerges, pSize, qSize;
+    int inSize = 1;
+
+    do {
+        p = list;
+        list = NULL;
+        tail = NULL;
+        numMerges = 0;
+
+        while (p) {
+            numMerges++;
+            q = p;
+            pSize = 0;
+            for (int i = 0; i < inSize; i++) {
+                pSize++;
+                q = q->nextZ;
+                if (!q) break;
+            }
+            qSize = inSize;
+
+            while (pSize > 0 || (qSize > 0 && q)) {
+                if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z)) {
+                    e = p;
+                    p = p->nextZ;
+                    pSize--;
+                }
+                else {
+                    e = q;
+                    q = q->nextZ;
+                    qSize--;
+                }
+
+                if (tail) tail->nextZ = e;
+                else list = e;
+
+                e->prevZ = tail;
+                tail = e;
+            }
+
+            p = q;
+        }
+
+        tail->nextZ = NULL;
+        inSize *= 2;
+    } while (numMerges > 1);
+
+    return list;
+}
+
+/* z-order of a point given coords and inverse of the longer side of data bbox.
+ */
+template<typename Config>
+LIBTESS_INLINE int32_t BasicEarcut<Config>::ZOrder(double fx, double fy)
+{
+    /* coords are transformed into non-negative 15-bit integer range */
+    int32_t x = int32_t((fx - minX) * invSize);
+    int32_t y = int32_t((fy - minY) * invSize);
+
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+
+    y = (y | (y << 8)) & 0x00FF00FF;
+    y = (y | (y << 4)) & 0x0F0F0F0F;
+    y = (y | (y << 2)) & 0x33333333;
+    y = (y | (y << 1)) & 0x55555555;
+
+    return x | (y << 1);
+}
+
+/* Finds the leftmost node of a polygon ring.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::GetLeftmost(Node* start)
+{
+    Node* p = start;
+    Node* leftmost = start;
+
+    do {
+        if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) {
+            leftmost = p;
+        }
+        p = p->next;
+    } while (p != start);
+
+    return leftmost;
+}
+
+/* Whether sector in vertex m contains sector in vertex p in the same coordinates.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::SectorContainsSector(Node* m, Node* p)
+{
+    return Area(m->prev, m, p->prev) < 0 && Area(p->next, m, m->next) < 0;
+}
+
+/* Checks if a point lies within a convex triangle.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::PointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+{
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+           (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+           (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+/* Checks if a diagonal between two polygon nodes is valid (lies in polygon interior).
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::IsValidDiagonal(Node* a, Node* b)
+{
+    return a->next->i != b->i && a->prev->i != b->i && !IntersectsPolygon(a, b) && /* doesn't intersect other edges */
+        ((LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&       /* locally visible */
+         (Area(a->prev, a, b->prev) != 0 || Area(a, b->prev, b) != 0)) ||          /* does not create opposite-facing sectors */
+         (Equals(a, b) && Area(a->prev, a, a->next) > 0 && Area(b->prev, b, b->next) > 0)); /* special zero-length case */
+}
+
+/* Signed area of a triangle.
+ */
+template<typename Config>
+LIBTESS_INLINE double BasicEarcut<Config>::Area(Node* p, Node* q, Node* r)
+{
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::Equals(Node* p1, Node* p2)
+{
+    return p1->x == p2->x && p1->y == p2->y;
+}
+
+/* Checks if two segments intersect.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::Intersects(Node* p1, Node* q1, Node* p2, Node* q2)
+{
+    int o1 = Sign(Area(p1, q1, p2));
+    int o2 = Sign(Area(p1, q1, q2));
+    int o3 = Sign(Area(p2, q2, p1));
+    int o4 = Sign(Area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4) return true; /* general case */
+
+    if (o1 == 0 && OnSegment(p1, p2, q1)) return true; /* p1, q1 and p2 are collinear and p2 lies on p1q1 */
+    if (o2 == 0 && OnSegment(p1, q2, q1)) return true; /* p1, q1 and q2 are collinear and q2 lies on p1q1 */
+    if (o3 == 0 && OnSegment(p2, p1, q2)) return true; /* p2, q2 and p1 are collinear and p1 lies on p2q2 */
+    if (o4 == 0 && OnSegment(p2, q1, q2)) return true; /* p2, q2 and q1 are collinear and q1 lies on p2q2 */
+
+    return false;
+}
+
+/* For collinear points p, q, r, checks if point q lies on segment pr.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::OnSegment(Node* p, Node* q, Node* r)
+{
+    return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+           q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+}
+
+template<typename Config>
+LIBTESS_INLINE int BasicEarcut<Config>::Sign(double value)
+{
+    return (value > 0) - (value < 0);
+}
+
+/* Checks if a polygon diagonal intersects any polygon segments.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::IntersectsPolygon(Node* a, Node* b)
+{
+    Node* p = a;
+
+    do {
+        if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+            Intersects(p, p->next, a, b)) {
+            return true;
+        }
+        p = p->next;
+    } while (p != a);
+
+    return false;
+}
+
+/* Checks if a polygon diagonal is locally inside the polygon.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::LocallyInside(Node* a, Node* b)
+{
+    return Area(a->prev, a, a->next) < 0 ?
+        Area(a, b, a->next) >= 0 && Area(a, a->prev, b) >= 0 :
+        Area(a, b, a->prev) < 0 || Area(a, a->next, b) < 0;
+}
+
+/* Checks if the middle point of a polygon diagonal is inside the polygon.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicEarcut<Config>::MiddleInside(Node* a, Node* b)
+{
+    Node* p = a;
+    bool inside = false;
+    double px = (a->x + b->x) / 2;
+    double py = (a->y + b->y) / 2;
+
+    do {
+        if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+            (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+            inside = !inside;
+        }
+        p = p->next;
+    } while (p != a);
+
+    return inside;
+}
+
+/* Links two polygon vertices with a bridge; if the vertices belong to the
+ * same ring, it splits polygon into two; if one belongs to the outer ring
+ * and another to a hole, it merges it into a single ring.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::SplitPolygon(Node* a, Node* b)
+{
+    Node* a2 = nodebuf.allocate();
+    Node* b2 = nodebuf.allocate();
+    Node* an = a->next;
+    Node* bp = b->prev;
+
+    a2->i = a->i;
+    a2->x = a->x;
+    a2->y = a->y;
+    b2->i = b->i;
+    b2->x = b->x;
+    b2->y = b->y;
+
+    a->next = b;
+    b->prev = a;
+
+    a2->next = an;
+    an->prev = a2;
+
+    b2->next = a2;
+    a2->prev = b2;
+
+    bp->next = b2;
+    b2->prev = bp;
+
+    return b2;
+}
+
+/* Creates a node and links it with the previous one (in a circular doubly linked list).
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicEarcut<Config>::Node* BasicEarcut<Config>::InsertNode(Index i, Node* last)
+{
+    Node* p = nodebuf.allocate();
+
+    p->i = i;
+    p->x = points[i].x;
+    p->y = points[i].y;
+
+    if (!last) {
+        p->prev = p;
+        p->next = p;
+    }
+    else {
+        p->next = last->next;
+        p->prev = last;
+        last->next->prev = p;
+        last->next = p;
+    }
+    return p;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicEarcut<Config>::RemoveNode(Node* p)
+{
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+
+    if (p->prevZ) p->prevZ->nextZ = p->nextZ;
+    if (p->nextZ) p->nextZ->prevZ = p->prevZ;
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_EARCUT_HPP
@@ -0,0 +1,81 @@
+#ifndef LIBTESS_EARCUT_INL
+#define LIBTESS_EARCUT_INL
+
+namespace libtess {
+
+/* Returns the winding number a contour of contourPoints adds inside
+ * itself, the same way the sweep counts it, or 0 for a contour without
+ * area.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::ContourWinding(size_t ring)
+{
+    Index begin = contourRings[ring * 2];
+    Index end = contourRings[ring * 2 + 1];
+    double area = 0;
+    int winding;
+
+    for (Index i = begin, j = end - 1; i < end; j = i++) {
+        area += (double(contourPoints[j].x) - contourPoints[i].x) * (double(contourPoints[i].y) + contourPoints[j].y);
+    }
+
+    /* area > 0 is CCW in the x-y plane, and s = y, t = x mirrors the plane */
+    winding = area > 0 ? -1 : (area < 0 ? 1 : 0);
+    return this->reverseContours ? -winding : winding;
+}
+
+/* Ear clipping engine. The first contour is the outline and the others
+ * are its holes. Where the winding rule puts a hole inside the polygon
+ * the hole is not cut out; if the outline is outside, the holes that are
+ * inside are triangulated on their own.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::RenderEarcut(TessWindingRule windingRule)
+{
+    size_t ringCount = contourRings.size() / 2;
+    int outerWinding = this->ContourWinding(0);
+    Index* rings = &contourRings[0];
+    size_t holes = 0;
+
+    if (outerWinding && IsWindingInside(windingRule, outerWinding)) {
+        /* move the holes that are cut out to the front */
+        for (size_t i = 1; i < ringCount; ++i) {
+            int winding = this->ContourWinding(i);
+            if (winding == 0 || !IsWindingInside(windingRule, outerWinding + winding)) {
+                ++holes;
+                std::swap(rings[holes * 2], rings[i * 2]);
+                std::swap(rings[holes * 2 + 1], rings[i * 2 + 1]);
+            }
+        }
+        earcut.triangulate(&contourPoints[0], rings, holes + 1, elements);
+    }
+    else {
+        for (size_t i = 1; i < ringCount; ++i) {
+            int winding = this->ContourWinding(i);
+            if (winding && IsWindingInside(windingRule, outerWinding + winding)) {
+                earcut.triangulate(&contourPoints[0], rings + i * 2, 1, elements);
+            }
+        }
+    }
+
+    /* output the vertices that are used, in the order of the triangles */
+    vertexMap.assign(contourPoints.size(), INVALID_INDEX);
+    for (size_t i = 0; i < elements.size(); ++i) {
+        Index& n = vertexMap[elements[i]];
+        if (n == INVALID_INDEX) {
+            const Vec3& v = contourPoints[elements[i]];
+            n = Index(vertices.size());
+            this->vertices.push_back(OutputVertex(v, (vertex_type*) NULL));
+            this->indices.push_back(n);
+        }
+        elements[i] = n;
+    }
+
+    this->release();
+
+    return LIBTESS_OK;
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_EARCUT_INL
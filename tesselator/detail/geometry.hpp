@@ -36,11 +36,62 @@
 #define LIBTESS_GEOMETRY_HPP
 
 #include "mesh.hpp"
+#include "predicates.hpp"
 
 namespace libtess {
 
-LIBTESS_INLINE int VertexIsCCW(Vertex *u, Vertex *v, Vertex *w)
+/* Returns the numerator of EdgeEval(u, v, w) with den its denominator,
+ * or of EdgeTransEval(u, v, w) for transposed arguments. Both are exact.
+ */
+LIBTESS_INLINE int64_t EdgeDet(int32_t us, int32_t ut, int32_t vs, int32_t vt, int32_t ws, int32_t wt, int64_t& den)
+{
+    int64_t gapL = int64_t(vs) - us;
+    int64_t gapR = int64_t(ws) - vs;
+
+    den = gapL + gapR;
+    return (int64_t(vt) - wt) * gapL + (int64_t(vt) - ut) * gapR;
+}
+
+/* hi * 2^64 + lo = a * b, from 32-bit halves */
+LIBTESS_INLINE void WideProduct(int64_t a, int64_t b, int64_t& hi, uint64_t& lo)
+{
+    uint64_t ua = a < 0 ? 0 - uint64_t(a) : uint64_t(a);
+    uint64_t ub = b < 0 ? 0 - uint64_t(b) : uint64_t(b);
+    uint64_t p00 = (ua & 0xFFFFFFFFu) * (ub & 0xFFFFFFFFu);
+    uint64_t p01 = (ua & 0xFFFFFFFFu) * (ub >> 32);
+    uint64_t p10 = (ua >> 32) * (ub & 0xFFFFFFFFu);
+    uint64_t p11 = (ua >> 32) * (ub >> 32);
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+    uint64_t h = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+
+    lo = (mid << 32) | (p00 & 0xFFFFFFFFu);
+    if ((a < 0) != (b < 0)) {
+        lo = ~lo + 1;
+        h = ~h + (lo == 0);
+    }
+    hi = int64_t(h);
+}
+
+/* a * b >= c * d, exact */
+LIBTESS_INLINE bool ProductGEQ(int64_t a, int64_t b, int64_t c, int64_t d)
+{
+    int64_t hi1, hi2;
+    uint64_t lo1, lo2;
+
+    WideProduct(a, b, hi1, lo1);
+    WideProduct(c, d, hi2, lo2);
+    return hi1 > hi2 || (hi1 == hi2 && lo1 >= lo2);
+}
+
+template<typename Config>
+LIBTESS_INLINE int VertexIsCCW(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
 {
+    if (Config::INTEGER_COORDS) {
+        return (int64_t(v->s) - u->s) * (int64_t(w->t) - u->t) - (int64_t(v->t) - u->t) * (int64_t(w->s) - u->s) >= 0;
+    }
+    if (Config::EXACT_PREDICATES) {
+        return Orient2d(u->s, u->t, v->s, v->t, w->s, w->t) >= 0;
+    }
     /* For almost-degenerate situations, the results are not reliable.
      * Unless the floating-point arithmetic can be performed without
      * rounding errors, *any* implementation will give incorrect results
@@ -50,24 +101,68 @@ LIBTESS_INLINE int VertexIsCCW(Vertex *u, Vertex *v, Vertex *w)
     return (u->s*(v->t - w->t) + v->s*(w->t - u->t) + w->s*(u->t - v->t)) >= 0;
 }
 
-LIBTESS_INLINE bool VertexEqual(Vertex* u, Vertex* v)
+/* Gives value, a floating-point estimate of a determinant, the sign of
+ * orient, the exact one. The value is kept when the signs agree, which
+ * is all but the near-degenerate cases, and without exact predicates.
+ */
+template<typename Config, typename T>
+LIBTESS_INLINE T ExactSign(T value, double orient)
 {
+    if (!Config::EXACT_PREDICATES) {
+        return value;
+    }
+    if (orient > 0) {
+        return value > 0 ? value : std::numeric_limits<T>::min();
+    }
+    if (orient < 0) {
+        return value < 0 ? value : -std::numeric_limits<T>::min();
+    }
+    return 0;
+}
+
+/* The sign of EdgeSign(u, v, w), v against the edge uw, for ExactSign().
+ */
+template<typename Config>
+LIBTESS_INLINE double EdgeOrient(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
+{
+    return Config::EXACT_PREDICATES ? Orient2d(u->s, u->t, w->s, w->t, v->s, v->t) : 0;
+}
+
+template<typename Config>
+LIBTESS_INLINE double EdgeTransOrient(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
+{
+    return Config::EXACT_PREDICATES ? Orient2d(u->t, u->s, w->t, w->s, v->t, v->s) : 0;
+}
+
+template<typename Config>
+LIBTESS_INLINE bool VertexEqual(BasicVertex<Config>* u, BasicVertex<Config>* v)
+{
+    if (Config::INTEGER_COORDS) {
+        return u->s == v->s && u->t == v->t;
+    }
     //return ((u)->s == (v)->s && (u)->t == (v)->t);
     return IsEqual(u->s, v->s) && IsEqual(u->t, v->t);
 }
 
-LIBTESS_INLINE bool VertexLessEqual(Vertex* u, Vertex* v)
+template<typename Config>
+LIBTESS_INLINE bool VertexLessEqual(BasicVertex<Config>* u, BasicVertex<Config>* v)
 {
     //return ( u->s < v->s ) || //((u)->s == (v)->s && (u)->t <= (v)->t));
     //    ( IsEqual( u->s, v->s ) && ( u->t < v->t || IsEqual( u->t, v->t ) ) );
 
+    if (Config::INTEGER_COORDS) {
+        return (u->s < v->s) || (u->s == v->s && u->t <= v->t);
+    }
     return (u->s < v->s) || //((u)->s == (v)->s && (u)->t <= (v)->t));
         (IsEqual(u->s, v->s) && (u->t < v->t || IsEqual(u->t, v->t)));
 
 }
 
-LIBTESS_INLINE int CountFaceVertices(Face* face)
+template<typename Config>
+LIBTESS_INLINE int CountFaceVertices(BasicFace<Config>* face)
 {
+    typedef BasicHalfEdge<Config> HalfEdge;
+
     HalfEdge *e = face->edge;
     int n = 0;
     do {
@@ -77,34 +172,43 @@ LIBTESS_INLINE int CountFaceVertices(Face* face)
     return n;
 }
 
-LIBTESS_INLINE bool EdgeGoesLeft(HalfEdge* e)
+template<typename Config>
+LIBTESS_INLINE bool EdgeGoesLeft(BasicHalfEdge<Config>* e)
 {
     return VertexLessEqual((e)->mirror->vertex, (e)->vertex);
 }
 
-LIBTESS_INLINE bool EdgeGoesRight(HalfEdge* e)
+template<typename Config>
+LIBTESS_INLINE bool EdgeGoesRight(BasicHalfEdge<Config>* e)
 {
     return VertexLessEqual((e)->vertex, (e)->mirror->vertex);
 }
 
-LIBTESS_INLINE bool EdgeIsInternal(HalfEdge* e)
+template<typename Config>
+LIBTESS_INLINE bool EdgeIsInternal(BasicHalfEdge<Config>* e)
 {
     return e->mirror->Lface && e->mirror->Lface->inside;
 }
 
 /* Versions of VertLeq, EdgeSign, EdgeEval with s and t transposed. */
-LIBTESS_INLINE bool VertexTransLEQ(Vertex* u, Vertex* v)
+template<typename Config>
+LIBTESS_INLINE bool VertexTransLEQ(BasicVertex<Config>* u, BasicVertex<Config>* v)
 {
     return (((u)->t < (v)->t) || ((u)->t == (v)->t && (u)->s <= (v)->s));
 }
 
 // Manhattan
-LIBTESS_INLINE Float VertexDistance(Vertex* u, Vertex* v)
+template<typename Config>
+LIBTESS_INLINE typename Config::Float VertexDistance(BasicVertex<Config>* u, BasicVertex<Config>* v)
 {
-    return fabs(u->s - v->s) + fabs(u->t - v->t);
+    typedef typename Config::Float Float;
+    typedef typename Config::Real Real;
+
+    return Float(fabs(Real(u->s) - v->s) + fabs(Real(u->t) - v->t));
 }
 
-LIBTESS_STATIC Float EdgeEval(Vertex *u, Vertex *v, Vertex *w)
+template<typename Config>
+LIBTESS_STATIC typename Config::Real EdgeEval(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
 {
     /* Given three vertices u,v,w such that VertLeq(u,v) && VertLeq(v,w),
      * evaluates the t-coord of the edge uw at the s-coord of the vertex v.
@@ -125,26 +229,35 @@ LIBTESS_STATIC Float EdgeEval(Vertex *u, Vertex *v, Vertex *w)
      * ر v->t = 0  r Ϊ󷴽( (uw)(v->s))
      * r֤ MIN(u->t, w->t) <= r <= MAX(u->t, w->t)
      */
-    Float gapL, gapR;
-
     assert(VertexLessEqual(u, v) && VertexLessEqual(v, w));
 
+    typedef typename Config::Float Float;
+    typedef typename Config::Real Real;
+
+    if (Config::INTEGER_COORDS) {
+        int64_t den, num = EdgeDet(u->s, u->t, v->s, v->t, w->s, w->t, den);
+        return den > 0 ? Real(num) / Real(den) : 0;
+    }
+
+    Float gapL, gapR;
+
     gapL = v->s - u->s;
     gapR = w->s - v->s;
 
     if (gapL + gapR > 0) {
         if (gapL < gapR) {
-            return (v->t - u->t) + (u->t - w->t) * (gapL / (gapL + gapR));
+            return ExactSign<Config>((v->t - u->t) + (u->t - w->t) * (gapL / (gapL + gapR)), EdgeOrient(u, v, w));
         }
         else {
-            return (v->t - w->t) + (w->t - u->t) * (gapR / (gapL + gapR));
+            return ExactSign<Config>((v->t - w->t) + (w->t - u->t) * (gapR / (gapL + gapR)), EdgeOrient(u, v, w));
         }
     }
     /* vertical line */
     return 0;
 }
 
-LIBTESS_STATIC Float EdgeSign(Vertex *u, Vertex *v, Vertex *w)
+template<typename Config>
+LIBTESS_STATIC typename Config::Real EdgeSign(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
 {
     /* Returns a number whose sign matches EdgeEval(u,v,w) but which
      * is cheaper to evaluate.  Returns > 0, == 0 , or < 0
@@ -153,26 +266,60 @@ LIBTESS_STATIC Float EdgeSign(Vertex *u, Vertex *v, Vertex *w)
      * һ EdgeEval(u, v, w) ƥ䵫ɱϵ͵֡
      *  v ڱԵ uw ϷϷ·ʱ > 0== 0  < 0
      */
-    Float gapL, gapR;
-
     assert(VertexLessEqual(u, v) && VertexLessEqual(v, w));
 
+    typedef typename Config::Float Float;
+    typedef typename Config::Real Real;
+
+    if (Config::INTEGER_COORDS) {
+        int64_t den, num = EdgeDet(u->s, u->t, v->s, v->t, w->s, w->t, den);
+        return Real(num);
+    }
+
+    Float gapL, gapR;
+
     gapL = v->s - u->s;
     gapR = w->s - v->s;
 
     if (gapL + gapR > 0) {
-        return (v->t - w->t) * gapL + (v->t - u->t) * gapR;
+        return ExactSign<Config>((v->t - w->t) * gapL + (v->t - u->t) * gapR, EdgeOrient(u, v, w));
     }
     /* vertical line */
     return 0;
 }
 
 
+/* EdgeEval(u1, v, w1) >= EdgeEval(u2, v, w2), exact on the integer grid.
+ */
+template<typename Config>
+LIBTESS_INLINE bool EdgeEvalGEQ(BasicVertex<Config> *u1, BasicVertex<Config> *w1, BasicVertex<Config> *u2, BasicVertex<Config> *w2, BasicVertex<Config> *v)
+{
+    typedef typename Config::Float Float;
+
+    if (Config::INTEGER_COORDS) {
+        int64_t den1, num1 = EdgeDet(u1->s, u1->t, v->s, v->t, w1->s, w1->t, den1);
+        int64_t den2, num2 = EdgeDet(u2->s, u2->t, v->s, v->t, w2->s, w2->t, den2);
+
+        assert(VertexLessEqual(u1, v) && VertexLessEqual(v, w1));
+        assert(VertexLessEqual(u2, v) && VertexLessEqual(v, w2));
+
+        /* vertical lines */
+        if (den1 == 0) { num1 = 0; den1 = 1; }
+        if (den2 == 0) { num2 = 0; den2 = 1; }
+        return ProductGEQ(num1, den2, num2, den1);
+    }
+
+    Float t1 = EdgeEval(u1, v, w1);
+    Float t2 = EdgeEval(u2, v, w2);
+    return t1 >= t2;
+}
+
 /***********************************************************************
  * Define versions of EdgeSign, EdgeEval with s and t transposed.
  */
 
-LIBTESS_STATIC Float EdgeTransEval(Vertex *u, Vertex *v, Vertex *w)
+template<typename Config>
+LIBTESS_STATIC typename Config::Real EdgeTransEval(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
 {
     /* Given three vertices u,v,w such that VertexTransLEQ(u,v) && VertexTransLEQ(v,w),
      * evaluates the t-coord of the edge uw at the s-coord of the vertex v.
@@ -184,40 +331,57 @@ LIBTESS_STATIC Float EdgeTransEval(Vertex *u, Vertex *v, Vertex *w)
      * let r be the negated result (this evaluates (uw)(v->t)), then
      * r is guaranteed to satisfy MIN(u->s,w->s) <= r <= MAX(u->s,w->s).
      */
-    Float gapL, gapR;
-
     assert(VertexTransLEQ(u, v) && VertexTransLEQ(v, w));
 
+    typedef typename Config::Float Float;
+    typedef typename Config::Real Real;
+
+    if (Config::INTEGER_COORDS) {
+        int64_t den, num = EdgeDet(u->t, u->s, v->t, v->s, w->t, w->s, den);
+        return den > 0 ? Real(num) / Real(den) : 0;
+    }
+
+    Float gapL, gapR;
+
     gapL = v->t - u->t;
     gapR = w->t - v->t;
 
     if (gapL + gapR > 0) {
         if (gapL < gapR) {
-            return (v->s - u->s) + (u->s - w->s) * (gapL / (gapL + gapR));
+            return ExactSign<Config>((v->s - u->s) + (u->s - w->s) * (gapL / (gapL + gapR)), EdgeTransOrient(u, v, w));
         }
         else {
-            return (v->s - w->s) + (w->s - u->s) * (gapR / (gapL + gapR));
+            return ExactSign<Config>((v->s - w->s) + (w->s - u->s) * (gapR / (gapL + gapR)), EdgeTransOrient(u, v, w));
         }
     }
     /* vertical line */
     return 0;
 }
 
-LIBTESS_STATIC Float EdgeTransSign(Vertex *u, Vertex *v, Vertex *w)
+template<typename Config>
+LIBTESS_STATIC typename Config::Real EdgeTransSign(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w)
 {
     /* Returns a number whose sign matches TransEval(u,v,w) but which
      * is cheaper to evaluate.  Returns > 0, == 0 , or < 0
      * as v is above, on, or below the edge uw.
      */
-    Float gapL, gapR;
-
     assert(VertexTransLEQ(u, v) && VertexTransLEQ(v, w));
 
+    typedef typename Config::Float Float;
+    typedef typename Config::Real Real;
+
+    if (Config::INTEGER_COORDS) {
+        int64_t den, num = EdgeDet(u->t, u->s, v->t, v->s, w->t, w->s, den);
+        return Real(num);
+    }
+
+    Float gapL, gapR;
+
     gapL = v->t - u->t;
     gapR = w->t - v->t;
 
     if (gapL + gapR > 0) {
-        return (v->s - w->s) * gapL + (v->s - u->s) * gapR;
+        return ExactSign<Config>((v->s - w->s) * gapL + (v->s - u->s) * gapR, EdgeTransOrient(u, v, w));
     }
     /* vertical line */
     return 0;
@@ -245,13 +409,24 @@ LIBTESS_STATIC Float EdgeTransSign(Vertex *u, Vertex *v, Vertex *w)
 //    : (x + (y-x) * (a/(a+b))))
 //    : (y + (x-y) * (b/(a+b)))))
 
-LIBTESS_INLINE Float Interpolate(Float a, Float x, Float b, Float y)
+template<typename T>
+LIBTESS_INLINE T Interpolate(T a, T x, T b, T y)
 {
     a = (a < 0) ? 0 : a;
     b = (b < 0) ? 0 : b;
     return (a <= b) ? ((b == 0) ? ((x + y) / 2) : (x + (y - x) * (a / (a + b)))) : (y + (x - y) * (b / (a + b)));
 }
 
+/* Rounds an intersection coordinate to the grid of the sweep plane.
+ */
+template<typename Config>
+LIBTESS_INLINE typename Config::Coord Snap(typename Config::Real x)
+{
+    typedef typename Config::Coord Coord;
+
+    return Config::INTEGER_COORDS ? Coord(floor(x + 0.5)) : Coord(x);
+}
+
 /* Given edges (o1,d1) and (o2,d2), compute their point of intersection.
  * The computed point is guaranteed to lie in the intersection of the
  * bounding rectangles defined by each edge.
@@ -260,9 +435,12 @@ LIBTESS_INLINE Float Interpolate(Float a, Float x, Float b, Float y)
  * 㱣֤λÿ߶ı߽εĽ㴦
  *
  */
-LIBTESS_STATIC void EdgeIntersect(Vertex *o1, Vertex *d1, Vertex *o2, Vertex *d2, Vertex *v)
+template<typename Config>
+LIBTESS_STATIC void EdgeIntersect(BasicVertex<Config> *o1, BasicVertex<Config> *d1, BasicVertex<Config> *o2, BasicVertex<Config> *d2, BasicVertex<Config> *v)
 {
-    Float z1, z2;
+    typedef typename Config::Real Real;
+
+    Real z1, z2;
 
     /* This is certainly not the most efficient way to find the intersection
      * of two line segments, but it is very numerically stable.
@@ -282,21 +460,21 @@ LIBTESS_STATIC void EdgeIntersect(Vertex *o1, Vertex *d1, Vertex *o2, Vertex *d2
 
     if (!VertexLessEqual(o2, d1)) {
         /* Technically, no intersection -- do our best */
-        v->s = (o2->s + d1->s) / 2;
+        v->s = Snap<Config>((Real(o2->s) + d1->s) / 2);
     }
     else if (VertexLessEqual(d1, d2)) {
      /* Interpolate between o2 and d1 */
         z1 = EdgeEval(o1, o2, d1);
         z2 = EdgeEval(o2, d1, d2);
         if (z1 + z2 < 0) { z1 = -z1; z2 = -z2; }
-        v->s = Interpolate(z1, o2->s, z2, d1->s);
+        v->s = Snap<Config>(Interpolate<Real>(z1, o2->s, z2, d1->s));
     }
     else {
      /* Interpolate between o2 and d2 */
         z1 = EdgeSign(o1, o2, d1);
         z2 = -EdgeSign(o1, d2, d1);
         if (z1 + z2 < 0) { z1 = -z1; z2 = -z2; }
-        v->s = Interpolate(z1, o2->s, z2, d2->s);
+        v->s = Snap<Config>(Interpolate<Real>(z1, o2->s, z2, d2->s));
     }
 
     /* Now repeat the process for t */
@@ -307,37 +485,41 @@ LIBTESS_STATIC void EdgeIntersect(Vertex *o1, Vertex *d1, Vertex *o2, Vertex *d2
 
     if (!VertexTransLEQ(o2, d1)) {
         /* Technically, no intersection -- do our best */
-        v->t = (o2->t + d1->t) / 2;
+        v->t = Snap<Config>((Real(o2->t) + d1->t) / 2);
     }
     else if (VertexTransLEQ(d1, d2)) {
      /* Interpolate between o2 and d1 */
         z1 = EdgeTransEval(o1, o2, d1);
         z2 = EdgeTransEval(o2, d1, d2);
         if (z1 + z2 < 0) { z1 = -z1; z2 = -z2; }
-        v->t = Interpolate(z1, o2->t, z2, d1->t);
+        v->t = Snap<Config>(Interpolate<Real>(z1, o2->t, z2, d1->t));
     }
     else {
      /* Interpolate between o2 and d2 */
         z1 = EdgeTransSign(o1, o2, d1);
         z2 = -EdgeTransSign(o1, d2, d1);
         if (z1 + z2 < 0) { z1 = -z1; z2 = -z2; }
-        v->t = Interpolate(z1, o2->t, z2, d2->t);
+        v->t = Snap<Config>(Interpolate<Real>(z1, o2->t, z2, d2->t));
     }
 }
 
 // libtess2
-LIBTESS_STATIC Float inCircle(Vertex *v, Vertex *v0, Vertex *v1, Vertex *v2)
+template<typename Config>
+LIBTESS_STATIC typename Config::Float inCircle(BasicVertex<Config> *v, BasicVertex<Config> *v0, BasicVertex<Config> *v1, BasicVertex<Config> *v2)
 {
+    typedef typename Config::Float Float;
+    typedef typename Config::Real Real;
+
     Float adx, ady, bdx, bdy, cdx, cdy;
     Float abdet, bcdet, cadet;
     Float alift, blift, clift;
 
-    adx = v0->s - v->s;
-    ady = v0->t - v->t;
-    bdx = v1->s - v->s;
-    bdy = v1->t - v->t;
-    cdx = v2->s - v->s;
-    cdy = v2->t - v->t;
+    adx = Float(Real(v0->s) - v->s);
+    ady = Float(Real(v0->t) - v->t);
+    bdx = Float(Real(v1->s) - v->s);
+    bdy = Float(Real(v1->t) - v->t);
+    cdx = Float(Real(v2->s) - v->s);
+    cdy = Float(Real(v2->t) - v->t);
 
     abdet = adx * bdy - bdx * ady;
     bcdet = bdx * cdy - cdx * bdy;
@@ -352,7 +534,8 @@ LIBTESS_STATIC Float inCircle(Vertex *v, Vertex *v0, Vertex *v1, Vertex *v2)
 
 /* Returns 1 is edge is locally delaunay
  */
-LIBTESS_INLINE int EdgeIsLocallyDelaunay(HalfEdge *e)
+template<typename Config>
+LIBTESS_INLINE int EdgeIsLocallyDelaunay(BasicHalfEdge<Config> *e)
 {
     return inCircle(e->mirror->Lnext->Lnext->vertex, e->Lnext->vertex, e->Lnext->Lnext->vertex, e->vertex) < 0;
 }
@@ -116,36 +116,37 @@
 
 namespace libtess {
 
-struct Vertex;
-struct Face;
-struct HalfEdge;
-struct ActiveRegion;
+template<typename Config> int VertexIsCCW(BasicVertex<Config> *u, BasicVertex<Config> *v, BasicVertex<Config> *w);
+template<typename Config> int CountFaceVertices(BasicFace<Config>* face);
+template<typename Config> bool EdgeIsInternal(BasicHalfEdge<Config>* e);
 
-int VertexIsCCW(Vertex *u, Vertex *v, Vertex *w);
-int CountFaceVertices(Face* face);
-bool EdgeIsInternal(HalfEdge* e);
-
-struct Vertex
+template<typename Config>
+struct BasicVertex
 {
+    LIBTESS_CONFIG_TYPES(Config);
+
     Vertex   *next;     /* next vertex (never NULL) */
     Vertex   *prev;     /* previous vertex (never NULL) */
     HalfEdge *edge;     /* a half-edge with this origin */
 
     /* Internal data (keep hidden) */
     Vec3 coords;        /* vertex location in 3D */
-    Float s, t;         /* projection onto the sweep plane */
+    Coord s, t;         /* projection onto the sweep plane */
     int pqHandle;       /* to allow deletion from priority queue */
     Index n;            /* to allow identify unique vertices */
     Index idx;          /* to allow map result to original verts */
 
-    Vertex()
+    BasicVertex()
     {
         memset(this, 0, sizeof(*this));
     }
 };
 
-struct Face
+template<typename Config>
+struct BasicFace
 {
+    LIBTESS_CONFIG_TYPES(Config);
+
     Face     *next;     /* next face (never NULL) */
     Face     *prev;     /* previous face (never NULL) */
     HalfEdge *edge;     /* a half edge with this left face */
@@ -156,14 +157,17 @@ struct Face
     Bool marked;        /* flag for conversion to strips */
     Bool inside;        /* this face is in the polygon interior */
 
-    Face()
+    BasicFace()
     {
         memset(this, 0, sizeof(*this));
     }
 };
 
-struct HalfEdge
+template<typename Config>
+struct BasicHalfEdge
 {
+    LIBTESS_CONFIG_TYPES(Config);
+
     HalfEdge *next;     /* doubly-linked list (prev==Sym->next) */
     HalfEdge *mirror;   /* same edge, opposite direction */
     HalfEdge *Onext;    /* next edge CCW around origin */
@@ -177,13 +181,20 @@ struct HalfEdge
                            from the right face to the left face */
     int mark;           /* Used by the Edge Flip algorithm */
 
-    HalfEdge()
+    BasicHalfEdge()
     {
         memset(this, 0, sizeof(*this));
     }
 };
 
-typedef std::pair<HalfEdge, HalfEdge> EdgePair;
+template<typename Config>
+struct BasicEdgePair
+{
+    LIBTESS_CONFIG_TYPES(Config);
+
+    HalfEdge first;
+    HalfEdge second;
+};
 
 //#define Rface   Sym->Lface
 //#define Dst     Sym->Org
@@ -195,23 +206,27 @@ typedef std::pair<HalfEdge, HalfEdge> EdgePair;
 //#define Dnext   Rprev->Sym  /* 3 pointers */
 //#define Rnext   Oprev->Sym  /* 3 pointers -- */
 
-class Mesh
+template<typename Config>
+class BasicMesh
 {
 public:
+    LIBTESS_CONFIG_TYPES(Config);
+
     Vertex   m_vtxHead;     /* dummy header for vertex list  */
     Face     m_faceHead;    /* dummy header for face list    */
     HalfEdge m_edgeHead;    /* dummy header for edge list    */
     HalfEdge m_edgeHeadst;  /* and its symmetric counterpart */
 
-    pool<Vertex, LIBTESS_PAGE_SIZE> vtxbuf;
-    pool<Face, LIBTESS_PAGE_SIZE> facebuf;
-    pool<EdgePair, LIBTESS_PAGE_SIZE> edgebuf;
+    pool<Vertex, Config::PAGE_SIZE> vtxbuf;
+    pool<Face, Config::PAGE_SIZE> facebuf;
+    pool<EdgePair, Config::PAGE_SIZE> edgebuf;
 
 public:
-    Mesh();
-    ~Mesh();
+    explicit BasicMesh(Allocator* a = NULL);
+    ~BasicMesh();
     int init();
     void dispose();
+    void clear();
 
     bool empty()const { return m_vtxHead.next == &m_vtxHead && m_vtxHead.prev == &m_vtxHead; }
     AABB ComputeAABB();
@@ -230,6 +245,15 @@ public:
     HalfEdge * SplitEdge(HalfEdge *eOrg);
     HalfEdge * Connect(HalfEdge *eOrg, HalfEdge *eDst);
 
+    /* Connect() for a worker thread, eOrg and eDst must share a face. The
+     * new edge and face are preallocated and left out of the mesh lists,
+     * LinkEdge() and LinkFace() insert them later before *eNext and *fNext,
+     * where Connect() would have.
+     */
+    static HalfEdge * ConnectDetached(HalfEdge *eOrg, HalfEdge *eDst, EdgePair *pair, Face *newFace, HalfEdge **eNext, Face **fNext);
+    void LinkEdge(HalfEdge *e, HalfEdge *eNext);
+    void LinkFace(Face *f, Face *fNext);
+
     void ZeroAllFace(Face *fZap);
 
     // libtess2
@@ -241,7 +265,9 @@ public:
 private:
     void MakeVertex(Vertex *newVertex, HalfEdge *eOrig, Vertex *vNext);
     void MakeFace(Face *newFace, HalfEdge *eOrig, Face *fNext);
-    void SpliceEdge(HalfEdge *a, HalfEdge *b);
+    static void InitFace(Face *newFace, HalfEdge *eOrig, Bool inside);
+    static HalfEdge * InitEdge(EdgePair *pair);
+    static void SpliceEdge(HalfEdge *a, HalfEdge *b);
 
 };
 
@@ -249,17 +275,20 @@ private:
 // source
 //
 
-LIBTESS_INLINE Mesh::Mesh()
+template<typename Config>
+LIBTESS_INLINE BasicMesh<Config>::BasicMesh(Allocator* a) : vtxbuf(a), facebuf(a), edgebuf(a)
 {
     this->init();
 }
 
-LIBTESS_INLINE Mesh::~Mesh()
+template<typename Config>
+LIBTESS_INLINE BasicMesh<Config>::~BasicMesh()
 {
     this->dispose();
 }
 
-LIBTESS_INLINE int Mesh::init()
+template<typename Config>
+LIBTESS_INLINE int BasicMesh<Config>::init()
 {
     Vertex *v;
     Face *f;
@@ -301,7 +330,8 @@ LIBTESS_INLINE int Mesh::init()
     return 0;
 }
 
-LIBTESS_INLINE void Mesh::dispose()
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::dispose()
 {
     vtxbuf.dispose();
     facebuf.dispose();
@@ -309,7 +339,19 @@ LIBTESS_INLINE void Mesh::dispose()
     this->init();
 }
 
-LIBTESS_INLINE AABB Mesh::ComputeAABB()
+/* Like dispose(), but the pool pages are kept for the next polygon.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::clear()
+{
+    vtxbuf.clear();
+    facebuf.clear();
+    edgebuf.clear();
+    this->init();
+}
+
+template<typename Config>
+LIBTESS_INLINE typename BasicMesh<Config>::AABB BasicMesh<Config>::ComputeAABB()
 {
     if (this->empty()) {
         return AABB();
@@ -333,7 +375,8 @@ LIBTESS_INLINE AABB Mesh::ComputeAABB()
  * the new vertex *before* vNext so that algorithms which walk the vertex
  * list will not see the newly created vertices.
  */
-LIBTESS_INLINE void Mesh::MakeVertex(Vertex *newVertex, HalfEdge *eOrig, Vertex *vNext)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::MakeVertex(Vertex *newVertex, HalfEdge *eOrig, Vertex *vNext)
 {
     HalfEdge *e;
     Vertex *vPrev;
@@ -365,34 +408,45 @@ LIBTESS_INLINE void Mesh::MakeVertex(Vertex *newVertex, HalfEdge *eOrig, Vertex
  * the new face *before* fNext so that algorithms which walk the face
  * list will not see the newly created faces.
  */
-LIBTESS_INLINE void Mesh::MakeFace(Face *newFace, HalfEdge *eOrig, Face *fNext)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::MakeFace(Face *newFace, HalfEdge *eOrig, Face *fNext)
 {
-    HalfEdge *e;
-    Face *fPrev;
-    Face *fNew = newFace;
+    assert(newFace != NULL);
 
-    assert(fNew != NULL);
-
-    /* insert in circular doubly-linked list before fNext */
-    fPrev = fNext->prev;
-    fNew->prev = fPrev;
-    fPrev->next = fNew;
-    fNew->next = fNext;
-    fNext->prev = fNew;
-
-    fNew->edge = eOrig;
-    fNew->trail = NULL;
-    fNew->marked = FALSE;
+    this->LinkFace(newFace, fNext);
 
     /* The new face is marked "inside" if the old one was.  This is a
      * convenience for the common case where a face has been split in two.
      */
-    fNew->inside = fNext->inside;
+    InitFace(newFace, eOrig, fNext->inside);
+}
+
+/* Inserts a face in the circular doubly-linked list before fNext.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::LinkFace(Face *f, Face *fNext)
+{
+    Face *fPrev = fNext->prev;
+    f->prev = fPrev;
+    fPrev->next = f;
+    f->next = fNext;
+    fNext->prev = f;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::InitFace(Face *newFace, HalfEdge *eOrig, Bool inside)
+{
+    HalfEdge *e;
+
+    newFace->edge = eOrig;
+    newFace->trail = NULL;
+    newFace->marked = FALSE;
+    newFace->inside = inside;
 
     /* fix other edges on this face loop */
     e = eOrig;
     do {
-        e->Lface = fNew;
+        e->Lface = newFace;
         e = e->Lnext;
     } while (e != eOrig);
 }
@@ -400,7 +454,8 @@ LIBTESS_INLINE void Mesh::MakeFace(Face *newFace, HalfEdge *eOrig, Face *fNext)
 /* __gl_meshMakeEdge creates one edge, two vertices, and a loop (face).
  * The loop consists of the two new half-edges.
  */
-LIBTESS_INLINE HalfEdge * Mesh::MakeEdge()
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::MakeEdge()
 {
     Vertex *newVertex1 = vtxbuf.allocate();
     Vertex *newVertex2 = vtxbuf.allocate();
@@ -433,19 +488,29 @@ LIBTESS_INLINE HalfEdge * Mesh::MakeEdge()
  * No vertex or face structures are allocated, but these must be assigned
  * before the current edge operation is completed.
  */
-LIBTESS_INLINE HalfEdge * Mesh::MakeEdge(HalfEdge *eNext)
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::MakeEdge(HalfEdge *eNext)
 {
     HalfEdge *e;
-    HalfEdge *eMirror;
-    HalfEdge *ePrev;
 
     EdgePair *pair = edgebuf.allocate();// (EdgePair *)bucketAlloc( this->edgeBucket );
     if (pair == NULL) {
         return NULL;
     }
 
-    e = &pair->first;
-    eMirror = &pair->second;
+    e = InitEdge(pair);
+    this->LinkEdge(e, eNext);
+    return e;
+}
+
+/* Inserts the edge pair of e in the circular doubly-linked list before
+ * eNext.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::LinkEdge(HalfEdge *e, HalfEdge *eNext)
+{
+    HalfEdge *eMirror = e->mirror;
+    HalfEdge *ePrev;
 
     /* Make sure eNext points to the first edge of the edge pair */
     if (eNext->mirror < eNext) { eNext = eNext->mirror; }
@@ -458,6 +523,15 @@ LIBTESS_INLINE HalfEdge * Mesh::MakeEdge(HalfEdge *eNext)
     ePrev->mirror->next = e;
     e->next = eNext;
     eNext->mirror->next = eMirror;
+}
+
+/* Makes the two half-edges of a pair a loop of their own.
+ */
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::InitEdge(EdgePair *pair)
+{
+    HalfEdge *e = &pair->first;
+    HalfEdge *eMirror = &pair->second;
 
     e->mirror = eMirror;
     e->Onext = e;
@@ -487,7 +561,8 @@ LIBTESS_INLINE HalfEdge * Mesh::MakeEdge(HalfEdge *eNext)
  * ٶ㲢ȫֶбɾ
  * ¶ѭָ¶㡣
  */
-LIBTESS_INLINE void Mesh::KillVertex(Vertex *vDel, Vertex *newOrg)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::KillVertex(Vertex *vDel, Vertex *newOrg)
 {
     HalfEdge *e, *eStart = vDel->edge;
     Vertex *vPrev, *vNext;
@@ -511,7 +586,8 @@ LIBTESS_INLINE void Mesh::KillVertex(Vertex *vDel, Vertex *newOrg)
 /* KillFace( fDel ) destroys a face and removes it from the global face
  * list.  It updates the face loop to point to a given new face.
  */
-LIBTESS_INLINE void Mesh::KillFace(Face *fDel, Face *newLface)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::KillFace(Face *fDel, Face *newLface)
 {
     HalfEdge *e, *eStart = fDel->edge;
     Face *fPrev, *fNext;
@@ -535,7 +611,8 @@ LIBTESS_INLINE void Mesh::KillFace(Face *fDel, Face *newLface)
 /* KillEdge( eDel ) destroys an edge (the half-edges eDel and eDel->Sym),
  * and removes from the global edge list.
  */
-LIBTESS_INLINE void Mesh::KillEdge(HalfEdge *eDel)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::KillEdge(HalfEdge *eDel)
 {
     HalfEdge *ePrev, *eNext;
 
@@ -557,7 +634,8 @@ LIBTESS_INLINE void Mesh::KillEdge(HalfEdge *eDel)
  * depending on whether a and b belong to different face or vertex rings.
  * For more explanation see __gl_meshSplice() below.
  */
-LIBTESS_INLINE void Mesh::SpliceEdge(HalfEdge *a, HalfEdge *b)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::SpliceEdge(HalfEdge *a, HalfEdge *b)
 {
     HalfEdge *aOnext = a->Onext;
     HalfEdge *bOnext = b->Onext;
@@ -591,7 +669,8 @@ LIBTESS_INLINE void Mesh::SpliceEdge(HalfEdge *a, HalfEdge *b)
  * If eDst == eOrg->Onext, the new vertex will have a single edge.
  * If eDst == eOrg->Oprev, the old vertex will have a single edge.
  */
-LIBTESS_INLINE int Mesh::Splice(HalfEdge *eOrg, HalfEdge *eDst)
+template<typename Config>
+LIBTESS_INLINE int BasicMesh<Config>::Splice(HalfEdge *eOrg, HalfEdge *eDst)
 {
     int joiningLoops = FALSE;
     int joiningVertices = FALSE;
@@ -651,7 +730,8 @@ LIBTESS_INLINE int Mesh::Splice(HalfEdge *eOrg, HalfEdge *eDst)
  * plus a few calls to memFree, but this would allocate and delete
  * unnecessary vertices and faces.
  */
-LIBTESS_INLINE int Mesh::DeleteEdge(HalfEdge *eDel)
+template<typename Config>
+LIBTESS_INLINE int BasicMesh<Config>::DeleteEdge(HalfEdge *eDel)
 {
     HalfEdge *eDelSym = eDel->mirror;
     int joiningLoops = FALSE;
@@ -711,7 +791,8 @@ LIBTESS_INLINE int Mesh::DeleteEdge(HalfEdge *eDel)
  * eNew == eOrg->Lnext, and eNew->Dst is a newly created vertex.
  * eOrg and eNew will have the same left face.
  */
-LIBTESS_INLINE HalfEdge * Mesh::AddEdgeVertex(HalfEdge *eOrg)
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::AddEdgeVertex(HalfEdge *eOrg)
 {
     HalfEdge *eNewSym;
     HalfEdge *eNew = this->MakeEdge(eOrg);
@@ -749,7 +830,8 @@ LIBTESS_INLINE HalfEdge * Mesh::AddEdgeVertex(HalfEdge *eOrg)
  *  eNew == eOrg->Lnext¶ eOrg->Dst == eNew->Org
  * eOrg  eNew ӵͬ档
  */
-LIBTESS_INLINE HalfEdge * Mesh::SplitEdge(HalfEdge *eOrg)
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::SplitEdge(HalfEdge *eOrg)
 {
     HalfEdge *eNew;
     HalfEdge *tempHalfEdge = this->AddEdgeVertex(eOrg);
@@ -784,7 +866,8 @@ LIBTESS_INLINE HalfEdge * Mesh::SplitEdge(HalfEdge *eOrg)
  * If (eOrg->Lnext == eDst), the old face is reduced to a single edge.
  * If (eOrg->Lnext->Lnext == eDst), the old face is reduced to two edges.
  */
-LIBTESS_INLINE HalfEdge * Mesh::Connect(HalfEdge *eOrg, HalfEdge *eDst)
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::Connect(HalfEdge *eOrg, HalfEdge *eDst)
 {
     HalfEdge *eNewSym;
     int joiningLoops = FALSE;
@@ -825,6 +908,34 @@ LIBTESS_INLINE HalfEdge * Mesh::Connect(HalfEdge *eOrg, HalfEdge *eDst)
     return eNew;
 }
 
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config> * BasicMesh<Config>::ConnectDetached(HalfEdge *eOrg, HalfEdge *eDst, EdgePair *pair, Face *newFace, HalfEdge **eNext, Face **fNext)
+{
+    HalfEdge *eNew = InitEdge(pair);
+    HalfEdge *eNewSym = eNew->mirror;
+
+    assert(eDst->Lface == eOrg->Lface);
+
+    *eNext = eOrg;
+    *fNext = eOrg->Lface;
+
+    /* Connect the new edge appropriately */
+    SpliceEdge(eNew, eOrg->Lnext);
+    SpliceEdge(eNewSym, eDst);
+
+    /* Set the vertex and face information */
+    eNew->vertex = eOrg->mirror->vertex;
+    eNewSym->vertex = eDst->vertex;
+    eNew->Lface = eNewSym->Lface = eOrg->Lface;
+
+    /* Make sure the old face points to a valid half-edge */
+    eOrg->Lface->edge = eNewSym;
+
+    /* We split one loop into two -- the new loop is eNew->Lface */
+    InitFace(newFace, eNew, eOrg->Lface->inside);
+    return eNew;
+}
+
 /* __gl_meshZapFace( fZap ) destroys a face and removes it from the
  * global face list.  All edges of fZap will have a NULL pointer as their
  * left face.  Any edges which also have a NULL pointer as their right face
@@ -835,7 +946,8 @@ LIBTESS_INLINE HalfEdge * Mesh::Connect(HalfEdge *eOrg, HalfEdge *eDst)
  * κҲпָΪıԵȫɾԼɴ˲κθ붥㣩
  * ͨκ˳һһ zapping ɾZAAPPED faces 
  */
-LIBTESS_INLINE void Mesh::ZeroAllFace(Face *fZap)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::ZeroAllFace(Face *fZap)
 {
     HalfEdge *eStart = fZap->edge;
     HalfEdge *e, *eNext, *eSym;
@@ -882,14 +994,25 @@ LIBTESS_INLINE void Mesh::ZeroAllFace(Face *fZap)
 }
 
 // libtess2
-LIBTESS_INLINE bool Mesh::MergeConvexFaces(int maxVertsPerFace)
+template<typename Config>
+LIBTESS_INLINE bool BasicMesh<Config>::MergeConvexFaces(int maxVertsPerFace)
 {
     HalfEdge *e, *eNext, *eSym;
     //HalfEdge *eHead = eHead; 2020-11-6
     HalfEdge *eHead = &m_edgeHead;
     Vertex *va, *vb, *vc, *vd, *ve, *vf;
+    Face *f;
     int leftNv, rightNv;
 
+    /* f->n holds the number of vertices of each inside face, so an edge
+     * does not walk its two faces again
+     */
+    for (f = m_faceHead.next; f != &m_faceHead; f = f->next) {
+        if (f->inside) {
+            f->n = CountFaceVertices(f);
+        }
+    }
+
     for (e = eHead->next; e != eHead; e = eNext) {
         eNext = e->next;
         eSym = e->mirror;
@@ -902,8 +1025,8 @@ LIBTESS_INLINE bool Mesh::MergeConvexFaces(int maxVertsPerFace)
         if (!eSym->Lface || !eSym->Lface->inside)
             continue;
 
-        leftNv = CountFaceVertices(e->Lface);
-        rightNv = CountFaceVertices(eSym->Lface);
+        leftNv = int(e->Lface->n);
+        rightNv = int(eSym->Lface->n);
         if ((leftNv + rightNv - 2) > maxVertsPerFace)
             continue;
 
@@ -927,9 +1050,12 @@ LIBTESS_INLINE bool Mesh::MergeConvexFaces(int maxVertsPerFace)
             if (e == eNext || e == eNext->mirror) {
                 eNext = eNext->next;
             }
+            /* the left face is deleted */
+            f = eSym->Lface;
             if (!this->DeleteEdge(e)) {
                 return false;
             }
+            f->n = Index(leftNv + rightNv - 2);
         }
     }
 
@@ -937,7 +1063,8 @@ LIBTESS_INLINE bool Mesh::MergeConvexFaces(int maxVertsPerFace)
 }
 
 // libtess2
-LIBTESS_INLINE void Mesh::FlipEdge(HalfEdge *edge)
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::FlipEdge(HalfEdge *edge)
 {
     HalfEdge *a0 = edge;
     HalfEdge *a1 = a0->Lnext;
@@ -1017,7 +1144,8 @@ LIBTESS_INLINE void Mesh::FlipEdge(HalfEdge *edge)
 
 #ifdef NDEBUG
 
-LIBTESS_INLINE void Mesh::CheckMesh()
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::CheckMesh()
 {
 }
 
@@ -1025,7 +1153,8 @@ LIBTESS_INLINE void Mesh::CheckMesh()
 
 /* __gl_meshCheckMesh( mesh ) checks a mesh for self-consistency.
  */
-LIBTESS_INLINE void Mesh::CheckMesh()
+template<typename Config>
+LIBTESS_INLINE void BasicMesh<Config>::CheckMesh()
 {
     Face *fHead = &m_faceHead;
     Vertex *vHead = &m_vtxHead;
@@ -44,7 +44,8 @@ namespace libtess {
  * winding of the new edge.
  * ǽߺϲΪһʱҪ±ߵϾơ
  */
-LIBTESS_INLINE void AddWinding(HalfEdge* eDst, HalfEdge* eSrc)
+template<typename Config>
+LIBTESS_INLINE void AddWinding(BasicHalfEdge<Config>* eDst, BasicHalfEdge<Config>* eSrc)
 {
     eDst->winding += eSrc->winding;
     eDst->mirror->winding += eSrc->mirror->winding;
@@ -77,8 +78,11 @@ LIBTESS_INLINE void AddWinding(HalfEdge* eDst, HalfEdge* eSrc)
  * to the fan is a simple orientation test.  By making the fan as large
  * as possible, we restore the invariant (check it yourself).
  */
-LIBTESS_STATIC int TessellateMonoRegion(Mesh *mesh, Face *face)
+template<typename Connector, typename Config>
+LIBTESS_STATIC int TessellateMonoRegion(Connector& connect, BasicFace<Config> *face)
 {
+    typedef BasicHalfEdge<Config> HalfEdge;
+
     HalfEdge *up, *lo;
 
     /* All edges are oriented CCW around the boundary of the region.
@@ -103,7 +107,7 @@ LIBTESS_STATIC int TessellateMonoRegion(Mesh *mesh, Face *face)
              */
             while (lo->Lnext != up && (EdgeGoesLeft(lo->Lnext)
                 || EdgeSign(lo->vertex, lo->mirror->vertex, lo->Lnext->mirror->vertex) <= 0)) {
-                HalfEdge *tempHalfEdge = mesh->Connect(lo->Lnext, lo);
+                HalfEdge *tempHalfEdge = connect(lo->Lnext, lo);
                 if (tempHalfEdge == NULL) {
                     return LIBTESS_ERROR;
                 }
@@ -115,7 +119,7 @@ LIBTESS_STATIC int TessellateMonoRegion(Mesh *mesh, Face *face)
             /* lo->Org is on the left.  We can make CCW triangles from up->Dst. */
             while (lo->Lnext != up && (EdgeGoesRight(up->Onext->mirror)
                 || EdgeSign(up->mirror->vertex, up->vertex, up->Onext->mirror->vertex) >= 0)) {
-                HalfEdge *tempHalfEdge = mesh->Connect(up, up->Onext->mirror);
+                HalfEdge *tempHalfEdge = connect(up, up->Onext->mirror);
                 if (tempHalfEdge == NULL) {
                     return LIBTESS_ERROR;
                 }
@@ -130,7 +134,7 @@ LIBTESS_STATIC int TessellateMonoRegion(Mesh *mesh, Face *face)
      */
     assert(lo->Lnext != up);
     while (lo->Lnext->Lnext != up) {
-        HalfEdge *tempHalfEdge = mesh->Connect(lo->Lnext, lo);
+        HalfEdge *tempHalfEdge = connect(lo->Lnext, lo);
         if (tempHalfEdge == NULL) {
             return LIBTESS_ERROR;
         }
@@ -140,14 +144,59 @@ LIBTESS_STATIC int TessellateMonoRegion(Mesh *mesh, Face *face)
     return LIBTESS_OK;
 }
 
+/* Connects the diagonals of TessellateMonoRegion() in the mesh.
+ */
+template<typename Config>
+struct MeshConnector
+{
+    LIBTESS_CONFIG_TYPES(Config);
+
+    Mesh *mesh;
+
+    HalfEdge * operator()(HalfEdge *eOrg, HalfEdge *eDst)
+    {
+        return mesh->Connect(eOrg, eDst);
+    }
+};
+
+/* Connects the diagonals of TessellateMonoRegion() on a worker thread,
+ * with the preallocated edges and faces [next, end). The slots record
+ * where Mesh::LinkEdge() and Mesh::LinkFace() must insert them.
+ */
+template<typename Config>
+struct DetachedConnector
+{
+    LIBTESS_CONFIG_TYPES(Config);
+
+    EdgePair **pairs;
+    Face **faces;
+    HalfEdge **edgeNext;
+    Face **faceNext;
+    size_t next, end;
+
+    HalfEdge * operator()(HalfEdge *eOrg, HalfEdge *eDst)
+    {
+        if (next == end) {
+            return NULL;
+        }
+        HalfEdge *e = Mesh::ConnectDetached(eOrg, eDst, pairs[next], faces[next], &edgeNext[next], &faceNext[next]);
+        ++next;
+        return e;
+    }
+};
+
 /* __gl_meshTessellateInterior( mesh ) tessellates each region of
  * the mesh which is marked "inside" the polygon.  Each such region
  * must be monotone.
  * ϸбΪΡڲÿÿǵ()
  */
-LIBTESS_STATIC int TessellateInterior(Mesh *mesh)
+template<typename Config>
+LIBTESS_STATIC int TessellateInterior(BasicMesh<Config> *mesh)
 {
+    typedef BasicFace<Config> Face;
+
     Face *f, *next;
+    MeshConnector<Config> connect = { mesh };
 
     /*LINTED*/
     for (f = mesh->m_faceHead.next; f != &mesh->m_faceHead; f = next) {
@@ -156,7 +205,7 @@ LIBTESS_STATIC int TessellateInterior(Mesh *mesh)
          */
         next = f->next;
         if (f->inside) {
-            if (TessellateMonoRegion(mesh, f) != LIBTESS_OK) {
+            if (TessellateMonoRegion(connect, f) != LIBTESS_OK) {
                 return LIBTESS_ERROR;
             }
         }
@@ -193,8 +242,11 @@ void DiscardExterior(TESSmesh *mesh)
  * If keepOnlyBoundary is TRUE, it also deletes all edges which do not
  * separate an interior region from an exterior one.
  */
-LIBTESS_STATIC int SetWindingNumber(Mesh *mesh, int value, int keepOnlyBoundary)
+template<typename Config>
+LIBTESS_STATIC int SetWindingNumber(BasicMesh<Config> *mesh, int value, int keepOnlyBoundary)
 {
+    typedef BasicHalfEdge<Config> HalfEdge;
+
     HalfEdge *e, *eNext;
 
     for (e = mesh->m_edgeHead.next; e != &mesh->m_edgeHead; e = eNext) {
@@ -0,0 +1,116 @@
+#ifndef LIBTESS_MONO_INL
+#define LIBTESS_MONO_INL
+
+namespace libtess {
+
+/* Triangulates the monotone regions marked "inside". With several threads
+ * the regions are split in ranges of about the same number of diagonals.
+ * Every region only changes its own half-edges, and the diagonals and
+ * faces are allocated beforehand in the order TessellateInterior() would
+ * take them, then linked into the mesh lists in that order, so the mesh
+ * is the same as with one thread.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::TessellateRegions()
+{
+    #ifdef LIBTESS_USE_THREADS
+    size_t threads = threadCount > 1 ? size_t(threadCount) : 1;
+    size_t slots = 0;
+    Face *f;
+
+    if (threads > 1) {
+        monoFaces.clear();
+        monoFirst.clear();
+        for (f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
+            if (f->inside) {
+                int n = CountFaceVertices(f);
+                monoFaces.push_back(f);
+                monoFirst.push_back(slots);
+                slots += n > 3 ? n - 3 : 0;
+            }
+        }
+        monoFirst.push_back(slots);
+    }
+
+    if (threads > 1 && monoFaces.size() >= LIBTESS_PARALLEL_FACES_MIN) {
+        std::thread workers[16];
+        int status[16];
+        size_t bounds[17];
+
+        threads = std::min<size_t>(threads, 16);
+
+        monoPairs.resize(slots);
+        monoNewFaces.resize(slots);
+        monoEdgeNext.resize(slots);
+        monoFaceNext.resize(slots);
+        for (size_t i = 0; i < slots; ++i) {
+            monoPairs[i] = mesh.edgebuf.allocate();
+            monoNewFaces[i] = mesh.facebuf.allocate();
+            if (monoPairs[i] == NULL || monoNewFaces[i] == NULL) {
+                return LIBTESS_ERROR;
+            }
+        }
+
+        DetachedConnector<Config> connect = { slots ? &monoPairs[0] : NULL, slots ? &monoNewFaces[0] : NULL,
+            slots ? &monoEdgeNext[0] : NULL, slots ? &monoFaceNext[0] : NULL, 0, 0 };
+
+        /* ranges with about the same number of diagonals */
+        bounds[0] = 0;
+        for (size_t i = 1; i < threads; ++i) {
+            size_t end = bounds[i - 1];
+            while (end < monoFaces.size() && monoFirst[end] < slots * i / threads) {
+                ++end;
+            }
+            bounds[i] = end;
+        }
+        bounds[threads] = monoFaces.size();
+
+        for (size_t i = 0; i < threads; ++i) {
+            status[i] = LIBTESS_OK;
+        }
+        for (size_t i = 1; i < threads; ++i) {
+            workers[i] = std::thread(TessellateRegionRange, &monoFaces[0] + bounds[i], &monoFirst[0] + bounds[i],
+                bounds[i + 1] - bounds[i], connect, status + i);
+        }
+
+        /* the calling thread takes the first range */
+        TessellateRegionRange(&monoFaces[0], &monoFirst[0], bounds[1], connect, status);
+
+        for (size_t i = 1; i < threads; ++i) {
+            workers[i].join();
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            if (status[i] != LIBTESS_OK) {
+                return LIBTESS_ERROR;
+            }
+        }
+
+        for (size_t i = 0; i < slots; ++i) {
+            mesh.LinkEdge(&monoPairs[i]->first, monoEdgeNext[i]);
+            mesh.LinkFace(monoNewFaces[i], monoFaceNext[i]);
+        }
+        return LIBTESS_OK;
+    }
+    #endif
+
+    return TessellateInterior(&this->mesh);
+}
+
+/* Triangulates count regions, region i with the slots [first[i], first[i + 1]).
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::TessellateRegionRange(Face** faces, const size_t* first, size_t count, DetachedConnector<Config> connect, int* status)
+{
+    for (size_t i = 0; i < count; ++i) {
+        connect.next = first[i];
+        connect.end = first[i + 1];
+        if (TessellateMonoRegion(connect, faces[i]) != LIBTESS_OK || connect.next != connect.end) {
+            *status = LIBTESS_ERROR;
+            return;
+        }
+    }
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_MONO_INL
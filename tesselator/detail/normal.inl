@@ -37,7 +37,8 @@
 
 namespace libtess {
 
-LIBTESS_INLINE Vec3 Tesselator::ComputeNormal()
+template<typename Config>
+LIBTESS_INLINE typename BasicTesselator<Config>::Vec3 BasicTesselator<Config>::ComputeNormal()
 {
     Vertex *v, *v1, *v2;
     Float c, tLen2, maxLen2;
@@ -110,7 +111,8 @@ LIBTESS_INLINE Vec3 Tesselator::ComputeNormal()
     return norm;
 }
 
-LIBTESS_INLINE void Tesselator::CheckOrientation()
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::CheckOrientation()
 {
     Float area;
     Face *f, *fHead = &mesh.m_faceHead;
@@ -145,8 +147,8 @@ LIBTESS_INLINE void Tesselator::CheckOrientation()
 
 #include <stdlib.h>
 extern int RandomSweep;
-const Float S_UNIT_X = (RandomSweep ? (2 * drand48() - 1) : 1.0);
-const Float S_UNIT_Y = (RandomSweep ? (2 * drand48() - 1) : 0.0);
+const double S_UNIT_X = (RandomSweep ? (2 * drand48() - 1) : 1.0);
+const double S_UNIT_Y = (RandomSweep ? (2 * drand48() - 1) : 0.0);
 
 #else// FOR_TRITE_TEST_PROGRAM
 
@@ -160,11 +162,11 @@ const Float S_UNIT_Y = (RandomSweep ? (2 * drand48() - 1) : 0.0);
  * direction to be something unusual (ie. not parallel to one of the
  * coordinate axes).
  */
-const Float S_UNIT_X = (Float)0.50941539564955385;    /* Pre-normalized */
-const Float S_UNIT_Y = (Float)0.86052074622010633;
+const double S_UNIT_X = 0.50941539564955385;    /* Pre-normalized */
+const double S_UNIT_Y = 0.86052074622010633;
 #else// SLANTED_SWEEP
-const Float S_UNIT_X = (Float)1.0;
-const Float S_UNIT_Y = (Float)0.0;
+const double S_UNIT_X = 1.0;
+const double S_UNIT_Y = 0.0;
 #endif//SLANTED_SWEEP
 #endif// FOR_TRITE_TEST_PROGRAM
 
@@ -172,7 +174,8 @@ const Float S_UNIT_Y = (Float)0.0;
  * Determine the polygon normal and project vertices onto the plane of the polygon.
  * ȷη߲ͶӰƽϡ
  */
-LIBTESS_INLINE void Tesselator::ProjectPolygon()
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::ProjectPolygon()
 {
     Vertex *v, *vHead = &this->mesh.m_vtxHead;
 
@@ -180,6 +183,8 @@ LIBTESS_INLINE void Tesselator::ProjectPolygon()
      */
     #ifdef LIBTESS_COMPUTE_NORMAL
 
+    static_assert(!Config::INTEGER_COORDS, "integer coordinates need the x-y plane, undefine LIBTESS_COMPUTE_NORMAL");
+
     Vec3 norm = this->normal;
     bool computedNormal = false;
     int i;
@@ -204,7 +209,7 @@ LIBTESS_INLINE void Tesselator::ProjectPolygon()
     /* Now make it exactly perpendicular
      * ȫֱ
      */
-    w = Dot(sUnit, norm);
+    w = Dot<Float>(sUnit, norm);
     sUnit -= w * norm;
     Normalize(sUnit);
 
@@ -228,8 +233,8 @@ LIBTESS_INLINE void Tesselator::ProjectPolygon()
      * ͶӰɨƽ
      */
     for (v = vHead->next; v != vHead; v = v->next) {
-        v->s = Dot(v->coords, sUnit);
-        v->t = Dot(v->coords, tUnit);
+        v->s = Dot<Float>(v->coords, sUnit);
+        v->t = Dot<Float>(v->coords, tUnit);
         /* ԭɨΪ
          */
         //v->t = Dot( v->coords, sUnit );
@@ -242,10 +247,13 @@ LIBTESS_INLINE void Tesselator::ProjectPolygon()
     #else
 
     /* ɨ߷Ϊ
+     * On the integer grid s and t are set by AddMeshContour().
      */
-    for (v = vHead->next; v != vHead; v = v->next) {
-        v->s = v->coords.y;
-        v->t = v->coords.x;
+    if (!Config::INTEGER_COORDS) {
+        for (v = vHead->next; v != vHead; v = v->next) {
+            v->s = v->coords.y;
+            v->t = v->coords.x;
+        }
     }
 
     #endif
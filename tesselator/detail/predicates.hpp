@@ -0,0 +1,195 @@
+/*
+ * Filtered exact orientation predicate, after Jonathan Richard Shewchuk,
+ * "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric
+ * Predicates" (1997), whose predicates.c is placed in the public domain.
+ *
+ * The determinant is first computed in double precision with a forward
+ * error bound. Only if the bound does not decide the sign, it is computed
+ * again exactly as a floating-point expansion.
+ */
+#ifndef LIBTESS_PREDICATES_HPP
+#define LIBTESS_PREDICATES_HPP
+
+namespace libtess {
+namespace predicates {
+
+/* half an ulp of 1.0, and the error bound of the filter */
+const double epsilon = 1.1102230246251565e-16;
+const double splitter = 134217729.0; /* 2^27 + 1 */
+const double ccwerrboundA = (3.0 + 16.0 * epsilon) * epsilon;
+
+/* x + y == a + b exactly, |a| >= |b| */
+LIBTESS_INLINE void FastTwoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    y = b - (x - a);
+}
+
+/* x + y == a + b exactly */
+LIBTESS_INLINE void TwoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bvirt = x - a;
+    double avirt = x - bvirt;
+    y = (a - avirt) + (b - bvirt);
+}
+
+/* x + y == a - b exactly */
+LIBTESS_INLINE void TwoDiff(double a, double b, double& x, double& y)
+{
+    x = a - b;
+    double bvirt = a - x;
+    double avirt = x + bvirt;
+    y = (a - avirt) + (bvirt - b);
+}
+
+LIBTESS_INLINE void Split(double a, double& hi, double& lo)
+{
+    double c = splitter * a;
+    hi = c - (c - a);
+    lo = a - hi;
+}
+
+/* x + y == a * b exactly */
+LIBTESS_INLINE void TwoProduct(double a, double b, double& x, double& y)
+{
+    double ahi, alo, bhi, blo;
+    x = a * b;
+    Split(a, ahi, alo);
+    Split(b, bhi, blo);
+    y = alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+}
+
+/* x[3] + x[2] + x[1] + x[0] == (a1 + a0) - (b1 + b0) exactly */
+LIBTESS_INLINE void TwoTwoDiff(double a1, double a0, double b1, double b0, double* x)
+{
+    double i, j, k;
+    TwoDiff(a0, b0, i, x[0]);
+    TwoSum(a1, i, j, k);
+    TwoDiff(k, b1, i, x[1]);
+    TwoSum(j, i, x[3], x[2]);
+}
+
+/* h = e + f, for nonoverlapping expansions sorted by increasing
+ * magnitude, without zero components. Returns the length of h.
+ */
+LIBTESS_INLINE int ExpansionSum(int elen, const double* e, int flen, const double* f, double* h)
+{
+    double Q, Qnew, hh;
+    int eindex = 0, findex = 0, hindex = 0;
+
+    if ((f[0] > e[0]) == (f[0] > -e[0])) {
+        Q = e[eindex++];
+    }
+    else {
+        Q = f[findex++];
+    }
+
+    if (eindex < elen && findex < flen) {
+        if ((f[findex] > e[eindex]) == (f[findex] > -e[eindex])) {
+            FastTwoSum(e[eindex++], Q, Qnew, hh);
+        }
+        else {
+            FastTwoSum(f[findex++], Q, Qnew, hh);
+        }
+        Q = Qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+        while (eindex < elen && findex < flen) {
+            if ((f[findex] > e[eindex]) == (f[findex] > -e[eindex])) {
+                TwoSum(Q, e[eindex++], Qnew, hh);
+            }
+            else {
+                TwoSum(Q, f[findex++], Qnew, hh);
+            }
+            Q = Qnew;
+            if (hh != 0.0) {
+                h[hindex++] = hh;
+            }
+        }
+    }
+    while (eindex < elen) {
+        TwoSum(Q, e[eindex++], Qnew, hh);
+        Q = Qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    while (findex < flen) {
+        TwoSum(Q, f[findex++], Qnew, hh);
+        Q = Qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (Q != 0.0 || hindex == 0) {
+        h[hindex++] = Q;
+    }
+    return hindex;
+}
+
+/* The exact determinant, as its most significant component */
+LIBTESS_INLINE double Orient2dExact(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    double p1, p0, q1, q0;
+    double aterms[4], bterms[4], cterms[4];
+    double v[8], w[12];
+    int vlength, wlength;
+
+    TwoProduct(ax, by, p1, p0);
+    TwoProduct(ax, cy, q1, q0);
+    TwoTwoDiff(p1, p0, q1, q0, aterms);
+
+    TwoProduct(bx, cy, p1, p0);
+    TwoProduct(bx, ay, q1, q0);
+    TwoTwoDiff(p1, p0, q1, q0, bterms);
+
+    TwoProduct(cx, ay, p1, p0);
+    TwoProduct(cx, by, q1, q0);
+    TwoTwoDiff(p1, p0, q1, q0, cterms);
+
+    vlength = ExpansionSum(4, aterms, 4, bterms, v);
+    wlength = ExpansionSum(vlength, v, 4, cterms, w);
+    return w[wlength - 1];
+}
+
+}// end namespace predicates
+
+/* Returns a positive value if a, b, c are in CCW order, a negative value
+ * if they are in CW order and zero if they are collinear. The sign is
+ * exact, the value approximates twice the signed area.
+ */
+LIBTESS_INLINE double Orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    double detleft = (ax - cx) * (by - cy);
+    double detright = (ay - cy) * (bx - cx);
+    double det = detleft - detright;
+    double detsum;
+
+    if (detleft > 0) {
+        if (detright <= 0) {
+            return det;
+        }
+        detsum = detleft + detright;
+    }
+    else if (detleft < 0) {
+        if (detright >= 0) {
+            return det;
+        }
+        detsum = -detleft - detright;
+    }
+    else {
+        return det;
+    }
+
+    if (det >= predicates::ccwerrboundA * detsum || -det >= predicates::ccwerrboundA * detsum) {
+        return det;
+    }
+
+    return predicates::Orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_PREDICATES_HPP
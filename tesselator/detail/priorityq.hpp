@@ -0,0 +1,429 @@
+/*
+ * SGI FREE SOFTWARE LICENSE B (Version 2.0, Sept. 18, 2008)
+ * Copyright (C) 1991-2000 Silicon Graphics, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice including the dates of first publication and
+ * either this permission notice or a reference to
+ * http://oss.sgi.com/projects/FreeB/
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * SILICON GRAPHICS, INC. BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Silicon Graphics, Inc.
+ * shall not be used in advertising or otherwise to promote the sale, use or
+ * other dealings in this Software without prior written authorization from
+ * Silicon Graphics, Inc.
+ */
+/*
+** Author: Eric Veach, July 1994.
+**
+*/
+
+#ifndef LIBTESS_PRIORITYQ_HPP
+#define LIBTESS_PRIORITYQ_HPP
+
+#include "geometry.hpp"
+
+namespace libtess {
+
+//
+// radix sort
+//
+
+/* Maps a coordinate to an unsigned integer with the same order
+ * (-0 and +0 map to the same key).
+ */
+template<typename T>
+struct radix_key;
+
+template<>
+struct radix_key<float>
+{
+    typedef uint32_t type;
+
+    static type get(float x)
+    {
+        type u;
+        if (x == 0) x = 0;
+        memcpy(&u, &x, sizeof(u));
+        return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+    }
+};
+
+template<>
+struct radix_key<double>
+{
+    typedef uint64_t type;
+
+    static type get(double x)
+    {
+        type u;
+        if (x == 0) x = 0;
+        memcpy(&u, &x, sizeof(u));
+        return (u >> 63) ? ~u : (u | (type(1) << 63));
+    }
+};
+
+template<>
+struct radix_key<int32_t>
+{
+    typedef uint32_t type;
+
+    static type get(int32_t x)
+    {
+        return uint32_t(x) ^ 0x80000000u;
+    }
+};
+
+/* Sorts vertices by (s, t) ascending with an LSD radix sort on the
+ * integer keys.  Passes where all keys share the same byte are skipped,
+ * so inputs with a small coordinate range only pay for a few passes.
+ */
+template<typename Config>
+class VertexRadixSort
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+    typedef typename radix_key<Coord>::type key_type;
+
+    struct item
+    {
+        key_type s, t;
+        Vertex* v;
+    };
+
+    enum { KEY_BYTES = sizeof(key_type), PASSES = KEY_BYTES * 2 };
+
+private:
+    std::vector<item, allocator<item> > items;
+    std::vector<item, allocator<item> > temp;
+    std::vector<size_t, allocator<size_t> > counts;
+
+public:
+    explicit VertexRadixSort(Allocator* a = NULL) :
+        items(allocator<item>(a)), temp(allocator<item>(a)), counts(allocator<size_t>(a))
+    {
+    }
+
+    /* Sorts [first, last) in place.
+     */
+    void sort(Vertex** first, Vertex** last)
+    {
+        size_t n = last - first;
+        size_t i;
+        int pass;
+
+        if (n < 2) {
+            return;
+        }
+
+        items.resize(n);
+        temp.resize(n);
+        counts.assign(PASSES * 256, 0);
+
+        /* build keys and all histograms in one pass */
+        for (i = 0; i < n; ++i) {
+            item& it = items[i];
+            it.v = first[i];
+            it.s = radix_key<Coord>::get(it.v->s);
+            it.t = radix_key<Coord>::get(it.v->t);
+            for (pass = 0; pass < PASSES; ++pass) {
+                ++counts[pass * 256 + digit(it, pass)];
+            }
+        }
+
+        item* src = &items[0];
+        item* dst = &temp[0];
+        for (pass = 0; pass < PASSES; ++pass) {
+            size_t* count = &counts[pass * 256];
+            size_t offset = 0;
+            int b;
+
+            if (count[digit(src[0], pass)] == n) {
+                continue;
+            }
+
+            for (b = 0; b < 256; ++b) {
+                size_t c = count[b];
+                count[b] = offset;
+                offset += c;
+            }
+            for (i = 0; i < n; ++i) {
+                dst[count[digit(src[i], pass)]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        for (i = 0; i < n; ++i) {
+            first[i] = src[i].v;
+        }
+    }
+
+    void dispose()
+    {
+        std::vector<item, allocator<item> >(items.get_allocator()).swap(items);
+        std::vector<item, allocator<item> >(temp.get_allocator()).swap(temp);
+        std::vector<size_t, allocator<size_t> >(counts.get_allocator()).swap(counts);
+    }
+
+private:
+    /* t is the minor key, so its bytes are sorted first */
+    static int digit(const item& it, int pass)
+    {
+        return pass < KEY_BYTES
+            ? int((it.t >> (pass * 8)) & 0xFF)
+            : int((it.s >> ((pass - KEY_BYTES) * 8)) & 0xFF);
+    }
+};
+
+//
+// PriorityQ
+//
+
+/* The event queue of the sweep.  The original vertices are known before
+ * the sweep starts, so they are sorted once into a plain array which is
+ * consumed from the back.  Vertices created during the sweep (edge
+ * intersections) go into a small binary heap.  The minimum is whichever
+ * of the two fronts is smaller.
+ *
+ * Vertex::pqHandle records where a vertex lives:
+ *   handle >= 0              index in the heap
+ *   handle <= -2             index -(handle + 2) in the sorted array
+ *   handle == INVALID_INDEX  not in the queue
+ * Deleting from the sorted array just clears the slot, deleting from
+ * the heap is O(log n).  Nothing is allocated per event once the
+ * buffers have grown to their working size.
+ */
+template<typename Config>
+class BasicPriorityQ
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+protected:
+    std::vector<Vertex*, allocator<Vertex*> > order;   /* sorted initial events, minimum at back() */
+    std::vector<Vertex*, allocator<Vertex*> > heap;    /* events created during the sweep */
+    VertexRadixSort<Config> presort;
+    bool initialized;
+
+public:
+    explicit BasicPriorityQ(Allocator* a = NULL) :
+        order(allocator<Vertex*>(a)), heap(allocator<Vertex*>(a)), presort(a), initialized(false)
+    {
+    }
+
+    void init(size_t size)
+    {
+        order.clear();
+        heap.clear();
+        order.reserve(size);
+        heap.reserve(size);
+        initialized = false;
+    }
+
+    /* Before sort() the vertex is appended to the array, afterwards it
+     * goes into the heap.
+     */
+    int insert(Vertex* v)
+    {
+        if (!initialized) {
+            v->pqHandle = -(int(order.size()) + 2);
+            order.push_back(v);
+        }
+        else {
+            v->pqHandle = int(heap.size());
+            heap.push_back(v);
+            sift_up(heap.size() - 1);
+        }
+        return v->pqHandle;
+    }
+
+    void sort()
+    {
+        /* 64-bit keys take twice the passes and are no faster than
+         * std::sort, see bench/radix.cpp
+         */
+        if (sizeof(typename VertexRadixSort<Config>::key_type) <= 4 && order.size() >= LIBTESS_RADIX_SORT_MIN) {
+            /* ascending, then flipped so that the minimum is at the back */
+            presort.sort(&order[0], &order[0] + order.size());
+            std::reverse(order.begin(), order.end());
+        }
+        else {
+            std::sort(order.begin(), order.end(), VertexGreater);
+        }
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i]->pqHandle = -(int(i) + 2);
+        }
+        initialized = true;
+    }
+
+    bool empty()
+    {
+        return top() == NULL;
+    }
+
+    size_t size()const
+    {
+        return order.size() + heap.size();
+    }
+
+    void erase(Vertex* v)
+    {
+        int h = v->pqHandle;
+
+        if (!this->find(v)) {
+            LIBTESS_LOG("PriorityQ.erase() : Vertex is not exists.");
+            return;
+        }
+
+        v->pqHandle = INVALID_INDEX;
+        if (h < 0) {
+            order[-(h + 2)] = NULL;
+            return;
+        }
+
+        size_t i = size_t(h);
+        Vertex* last = heap.back();
+        heap.pop_back();
+        if (i < heap.size()) {
+            heap[i] = last;
+            last->pqHandle = int(i);
+            if (i > 0 && !VertexLessEqual(heap[(i - 1) / 2], last)) {
+                sift_up(i);
+            }
+            else {
+                sift_down(i);
+            }
+        }
+    }
+
+    void clear()
+    {
+        order.clear();
+        heap.clear();
+        initialized = false;
+    }
+
+    /* Like clear(), and releases the buffers.
+     */
+    void dispose()
+    {
+        std::vector<Vertex*, allocator<Vertex*> >(order.get_allocator()).swap(order);
+        std::vector<Vertex*, allocator<Vertex*> >(heap.get_allocator()).swap(heap);
+        presort.dispose();
+        initialized = false;
+    }
+
+    Vertex* find(Vertex* v)const
+    {
+        int h = v->pqHandle;
+
+        if (h >= 0) {
+            return (size_t(h) < heap.size() && heap[h] == v) ? v : NULL;
+        }
+        else if (h <= -2) {
+            size_t i = size_t(-(h + 2));
+            return (i < order.size() && order[i] == v) ? v : NULL;
+        }
+        return NULL;
+    }
+
+    Vertex* top()
+    {
+        /* skip the slots of deleted vertices */
+        while (!order.empty() && order.back() == NULL) {
+            order.pop_back();
+        }
+
+        if (order.empty()) {
+            return heap.empty() ? NULL : heap[0];
+        }
+        if (!heap.empty() && VertexLessEqual(heap[0], order.back())) {
+            return heap[0];
+        }
+        return order.back();
+    }
+
+    Vertex* pop()
+    {
+        Vertex* v = this->top();
+
+        if (v == NULL) {
+            return NULL;
+        }
+
+        if (!order.empty() && order.back() == v) {
+            order.pop_back();
+            v->pqHandle = INVALID_INDEX;
+        }
+        else {
+            this->erase(v);
+        }
+        return v;
+    }
+
+private:
+    static bool VertexGreater(Vertex* u, Vertex* v)
+    {
+        return (u->s > v->s) || (u->s == v->s && u->t > v->t);
+    }
+
+    void sift_up(size_t i)
+    {
+        Vertex* v = heap[i];
+
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (VertexLessEqual(heap[parent], v)) {
+                break;
+            }
+            heap[i] = heap[parent];
+            heap[i]->pqHandle = int(i);
+            i = parent;
+        }
+        heap[i] = v;
+        v->pqHandle = int(i);
+    }
+
+    void sift_down(size_t i)
+    {
+        Vertex* v = heap[i];
+        size_t n = heap.size();
+
+        for (;;) {
+            size_t child = i * 2 + 1;
+            if (child >= n) {
+                break;
+            }
+            if (child + 1 < n && VertexLessEqual(heap[child + 1], heap[child])) {
+                ++child;
+            }
+            if (VertexLessEqual(v, heap[child])) {
+                break;
+            }
+            heap[i] = heap[child];
+            heap[i]->pqHandle = int(i);
+            i = child;
+        }
+        heap[i] = v;
+        v->pqHandle = int(i);
+    }
+};
+
+}// end namespace libtess
+
+#endif// LIBTESS_PRIORITYQ_HPP
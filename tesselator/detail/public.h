@@ -41,11 +41,20 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <new>
 #include <set>
 #include <stack>
 #include <stdint.h>
 #include <vector>
 
+#ifdef LIBTESS_USE_THREADS
+#include <thread>
+#endif
+
 #ifdef _MSC_VER
 #undef min
 #undef max
@@ -53,6 +62,11 @@
 
 // Config
 
+// The precision, vector, pool, page size, dictionary, predicate and integer
+// coordinate macros below only describe DefaultConfig, the configuration of
+// Tesselator and TessBatch. Other configurations are given as the template
+// argument of BasicTesselator, see TessConfig.
+
 // whether to calculate
 //#define LIBTESS_COMPUTE_NORMAL
 //#define TRUE_PROJECT  // error
@@ -65,6 +79,62 @@
 // whether to use pool allocator
 #define LIBTESS_USE_POOL
 
+// edge dictionary: balanced tree (O(log n) search) or plain list
+#if !defined(LIBTESS_USE_DICT_LIST) && !defined(LIBTESS_USE_DICT_TREE)
+    #define LIBTESS_USE_DICT_TREE
+#endif
+
+// orientation tests: filtered exact predicates, or plain floating point
+#if !defined(LIBTESS_USE_EXACT_PREDICATES) && !defined(LIBTESS_USE_FAST_PREDICATES)
+    #define LIBTESS_USE_EXACT_PREDICATES
+#endif
+
+// sweep on an integer grid: add_contour() takes int32_t coordinates within
+// +-(2^30 - 1), the predicates are exact in 64-bit integers and intersections
+// are rounded to the grid. Only for the x-y plane.
+//#define LIBTESS_INTEGER_COORDS
+
+#if defined(LIBTESS_INTEGER_COORDS) && defined(LIBTESS_COMPUTE_NORMAL)
+    #error LIBTESS_INTEGER_COORDS needs the x-y plane, undefine LIBTESS_COMPUTE_NORMAL
+#endif
+
+// TESS_ENGINE_AUTO uses ear clipping for at most this many holes, the sweep
+// for more, see bench/earcut.cpp
+#ifndef LIBTESS_AUTO_EARCUT_HOLES
+    #define LIBTESS_AUTO_EARCUT_HOLES 16
+#endif
+
+// event queues of float or int32_t coordinates with at least this many vertices
+// are presorted by radix sort
+#ifndef LIBTESS_RADIX_SORT_MIN
+    #define LIBTESS_RADIX_SORT_MIN 256
+#endif
+
+// run TessellateInterior() on Tesselator::threadCount threads, needs C++11 <thread>
+//#define LIBTESS_USE_THREADS
+
+// meshes with fewer inside faces are tessellated on the calling thread
+#ifndef LIBTESS_PARALLEL_FACES_MIN
+    #define LIBTESS_PARALLEL_FACES_MIN 1024
+#endif
+
+// Tesselator::cacheSimilar takes a cached result for contours within
+// 2^-LIBTESS_SIMILAR_BITS of it in the canonical frame, in units of its axis
+#ifndef LIBTESS_SIMILAR_BITS
+    #define LIBTESS_SIMILAR_BITS 12
+#endif
+
+// vertex cache size Tesselator::optimizeVertexCache optimizes for
+#ifndef LIBTESS_VERTEX_CACHE_SIZE
+    #define LIBTESS_VERTEX_CACHE_SIZE 16
+#endif
+
+// most vertices of a draw range of Tesselator::shortIndices, 0xFFFF stays
+// free for primitive restart
+#ifndef LIBTESS_SHORT_RANGE_VERTICES
+    #define LIBTESS_SHORT_RANGE_VERTICES 0xFFFF
+#endif
+
 // default pool buffer size
 #ifndef LIBTESS_PAGE_SIZE
     #define LIBTESS_PAGE_SIZE 256
@@ -103,7 +173,22 @@ namespace libtess {
 typedef int Index;
 typedef char Bool;
 
-class Tesselator;
+template<typename T> struct BasicVec2;
+template<typename T> struct BasicVec3;
+template<typename T> struct BasicAABB;
+template<typename Config> struct BasicVertex;
+template<typename Config> struct BasicFace;
+template<typename Config> struct BasicHalfEdge;
+template<typename Config> struct BasicEdgePair;
+template<typename Config> struct BasicActiveRegion;
+template<typename Config> class BasicMesh;
+template<typename Config> class BasicDict;
+template<typename Config> class BasicPriorityQ;
+template<typename Config> class BasicSweep;
+template<typename Config> class BasicEarcut;
+template<typename Config> class BasicTipsify;
+template<typename Config> class BasicTesselator;
+template<typename Config> class BasicTessCache;
 
 /* See OpenGL Red Book for description of the winding rules
  * http://www.glprogramming.com/red/chapter11.html
@@ -118,12 +203,23 @@ enum TessWindingRule
 };
 
 
+/* Triangulation engine of Tesselator::tesselate()
+ */
+enum TessEngine
+{
+    TESS_ENGINE_AUTO,           /* cheapest engine that handles the input      */
+    TESS_ENGINE_SWEEP,          /* sweep line, any input                       */
+    TESS_ENGINE_EARCUT,         /* ear clipping, simple polygons with holes    */
+    TESS_ENGINE_CONVEX,         /* triangle fan of a lone convex contour       */
+};
+
 enum TessElementType
 {
     TESS_TRIANGLES,
     TESS_BOUNDARY_CONTOURS,
-    //TESS_POLYGONS,
-    //TESS_CONNECTED_POLYGONS,
+    TESS_TRIANGLE_STRIPS,       /* strips joined with the restart index INVALID_INDEX */
+    TESS_POLYGONS,              /* convex polygons of up to polySize vertices       */
+    TESS_CONNECTED_POLYGONS,    /* polygons, each followed by its neighbour polygons */
 };
 
 // error code
@@ -143,15 +239,26 @@ namespace libtess{
     typedef glm::vec2 Vec2;
     typedef glm::vec3 Vec3;
 }
+
+or, for one configuration only:
+
+struct GlmConfig : libtess::TessConfig<float, 2>
+{
+    typedef glm::vec2 Vec2;
+    typedef glm::vec3 Vec3;
+};
+libtess::BasicTesselator<GlmConfig> tess;
 */
-#ifndef LIBTESS_CUSTOM_VECTOR
 
-struct Vec2
+template<typename T>
+struct BasicVec2
 {
+    typedef T Float;
+
     Float x, y;
 
-    Vec2() : x(), y() {}
-    Vec2(Float vx, Float vy) : x(vx), y(vy) {}
+    BasicVec2() : x(), y() {}
+    BasicVec2(Float vx, Float vy) : x(vx), y(vy) {}
 
     Float& operator[](int i)
     {
@@ -164,12 +271,15 @@ struct Vec2
     }
 };
 
-struct Vec3
+template<typename T>
+struct BasicVec3
 {
+    typedef T Float;
+
     Float x, y, z;
 
-    Vec3() : x(), y(), z() {}
-    Vec3(Float vx, Float vy, Float vz) : x(vx), y(vy), z(vz) {}
+    BasicVec3() : x(), y(), z() {}
+    BasicVec3(Float vx, Float vy, Float vz) : x(vx), y(vy), z(vz) {}
 
     Float& operator[](int i)
     {
@@ -182,21 +292,141 @@ struct Vec3
     }
 };
 
+#ifndef LIBTESS_CUSTOM_VECTOR
+typedef BasicVec2<Float> Vec2;
+typedef BasicVec3<Float> Vec3;
 #endif
 
-struct AABB
+template<typename T>
+struct BasicAABB
 {
-    Float amin, amax;
-    Float bmin, bmax;
+    T amin, amax;
+    T bmin, bmax;
+
+    BasicAABB() : amin(FLT_MAX), amax(FLT_MIN), bmin(FLT_MAX), bmax(FLT_MIN) {}
+};
+
+/* Picks T if Condition is true, F otherwise.
+ */
+template<bool Condition, typename T, typename F>
+struct select_type
+{
+    typedef T type;
+};
+
+template<typename T, typename F>
+struct select_type<false, T, F>
+{
+    typedef F type;
+};
+
+/* Compile-time configuration of BasicTesselator: the precision, the
+ * dimension of the output vertices, the pools, the input coordinates,
+ * the edge dictionary and the predicates. Tesselators with different
+ * configurations can be used in one program.
+ *
+ * CoordType is T, or int32_t for the sweep on an integer grid (see
+ * LIBTESS_INTEGER_COORDS), which needs the x-y plane. DictTree picks the
+ * balanced tree over the plain list, ExactPredicates the filtered exact
+ * orientation tests over plain floating point; the integer grid is exact
+ * either way.
+ */
+template<typename T, int Dimension = 3, size_t PageSize = LIBTESS_PAGE_SIZE, bool UsePool = true,
+    typename CoordType = T, bool DictTree = true, bool ExactPredicates = true>
+struct TessConfig
+{
+    typedef T Float;
+
+    static const bool INTEGER_COORDS = std::numeric_limits<CoordType>::is_integer;
+
+    // coordinates of the sweep plane, and the determinants computed from them
+    typedef CoordType Coord;
+    typedef typename select_type<INTEGER_COORDS, double, T>::type Real;
+
+    typedef BasicVec2<T> Vec2;
+    typedef BasicVec3<T> Vec3;
+
+    static const int VERTEX_SIZE = Dimension;   /* 2 or 3, the vertex_type of the output */
+    static const size_t PAGE_SIZE = PageSize;
+    static const bool USE_POOL = UsePool;
+    static const bool DICT_TREE = DictTree;
+    static const bool EXACT_PREDICATES = ExactPredicates;
 
-    AABB() : amin(FLT_MAX), amax(FLT_MIN), bmin(FLT_MAX), bmax(FLT_MIN) {}
+    static_assert(!INTEGER_COORDS || sizeof(CoordType) == 4, "integer coordinates are int32_t");
 };
 
+#ifdef LIBTESS_USE_VEC3
+const int LIBTESS_VERTEX_SIZE = 3;
+#else
+const int LIBTESS_VERTEX_SIZE = 2;
+#endif
+
+#ifdef LIBTESS_USE_POOL
+const bool LIBTESS_POOL = true;
+#else
+const bool LIBTESS_POOL = false;
+#endif
+
+#ifdef LIBTESS_INTEGER_COORDS
+const bool LIBTESS_INTEGER_GRID = true;
+#else
+const bool LIBTESS_INTEGER_GRID = false;
+#endif
+
+#ifdef LIBTESS_USE_DICT_TREE
+const bool LIBTESS_DICT_TREE = true;
+#else
+const bool LIBTESS_DICT_TREE = false;
+#endif
+
+#ifdef LIBTESS_USE_EXACT_PREDICATES
+const bool LIBTESS_EXACT_PREDICATES = true;
+#else
+const bool LIBTESS_EXACT_PREDICATES = false;
+#endif
+
+/* The configuration given by the macros.
+ */
+struct DefaultConfig : TessConfig<Float, LIBTESS_VERTEX_SIZE, LIBTESS_PAGE_SIZE, LIBTESS_POOL,
+    select_type<LIBTESS_INTEGER_GRID, int32_t, Float>::type, LIBTESS_DICT_TREE, LIBTESS_EXACT_PREDICATES>
+{
+    typedef libtess::Vec2 Vec2;
+    typedef libtess::Vec3 Vec3;
+};
+
+/* The types of a configuration, for the class templates.
+ */
+#define LIBTESS_CONFIG_TYPES(Config) \
+    typedef typename Config::Float Float; \
+    typedef typename Config::Coord Coord; \
+    typedef typename Config::Real Real; \
+    typedef typename Config::Vec2 Vec2; \
+    typedef typename Config::Vec3 Vec3; \
+    typedef BasicAABB<Float> AABB; \
+    typedef BasicVertex<Config> Vertex; \
+    typedef BasicFace<Config> Face; \
+    typedef BasicHalfEdge<Config> HalfEdge; \
+    typedef BasicEdgePair<Config> EdgePair; \
+    typedef BasicActiveRegion<Config> ActiveRegion; \
+    typedef BasicMesh<Config> Mesh; \
+    typedef BasicDict<Config> Dict; \
+    typedef BasicPriorityQ<Config> PriorityQ; \
+    typedef BasicSweep<Config> Sweep; \
+    typedef BasicEarcut<Config> Earcut; \
+    typedef BasicTipsify<Config> Tipsify; \
+    typedef BasicTessCache<Config> TessCache; \
+    typedef BasicTesselator<Config> Tesselator
+
 enum
 {
     INVALID_INDEX = (~(Index) 0)
 };
 
+/* The sentinels of the sweep on an integer grid sit on the limit, so every
+ * coordinate difference fits in 31 bits and every product of two in 62 bits.
+ */
+const int32_t COORD_LIMIT = int32_t(1) << 30;
+
 #ifndef TRUE
     #define TRUE 1
 #endif
@@ -204,34 +434,39 @@ enum
     #define FALSE 0
 #endif
 
-LIBTESS_INLINE Float Abs(Float x)
+template<typename T>
+LIBTESS_INLINE T Abs(T x)
 {
     return x < 0 ? -x : x;
 }
 
-LIBTESS_INLINE bool IsEqual(Float a, Float b)
+template<typename T>
+LIBTESS_INLINE bool IsEqual(T a, T b)
 {
     using namespace std;
     return fabs(b - a) < 0.000001f;
 }
 
-LIBTESS_INLINE Float Dot(Vec3& u, Vec3& v)
+template<typename T, typename V>
+LIBTESS_INLINE T Dot(V& u, V& v)
 {
     return u.x * v.x + u.y * v.y + u.z * v.z;
 }
 
-LIBTESS_INLINE Vec3 Cross(Vec3& u, Vec3& v)
+template<typename V>
+LIBTESS_INLINE V Cross(V& u, V& v)
 {
-    return Vec3(
+    return V(
         u.y * v.z - u.z * v.y,
         u.z * v.x - u.x * v.z,
         u.x * v.y - u.y * v.x);
 }
 
 #if defined(FOR_TRITE_TEST_PROGRAM) || defined(TRUE_PROJECT)
-void Normalize(Vec3& v)
+template<typename V>
+void Normalize(V& v)
 {
-    Float len = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    double len = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
 
     assert(len > 0);
     len = sqrt(len);
@@ -241,7 +476,8 @@ void Normalize(Vec3& v)
 }
 #endif
 
-LIBTESS_INLINE int LongAxis(Vec3& v)
+template<typename V>
+LIBTESS_INLINE int LongAxis(V& v)
 {
     int i = 0;
 
@@ -250,7 +486,8 @@ LIBTESS_INLINE int LongAxis(Vec3& v)
     return i;
 }
 
-LIBTESS_INLINE int ShortAxis(Vec3& v)
+template<typename V>
+LIBTESS_INLINE int ShortAxis(V& v)
 {
     int i = 0;
 
@@ -259,6 +496,226 @@ LIBTESS_INLINE int ShortAxis(Vec3& v)
     return i;
 }
 
+//
+// allocator
+//
+
+/* Memory interface of the tesselator. Every page of the mesh, sweep and
+ * dictionary pools, the event queue and the output buffers are taken
+ * from the Allocator given to the Tesselator constructor.
+ */
+class Allocator
+{
+public:
+    virtual ~Allocator() {}
+    virtual void* allocate(size_t size) = 0;
+    virtual void deallocate(void* p, size_t size) = 0;
+};
+
+class HeapAllocator : public Allocator
+{
+public:
+    void* allocate(size_t size)
+    {
+        return ::operator new(size);
+    }
+
+    void deallocate(void* p, size_t)
+    {
+        ::operator delete(p);
+    }
+};
+
+/* The allocator used when none is given.
+ */
+LIBTESS_INLINE Allocator* default_allocator()
+{
+    static HeapAllocator heap;
+    return &heap;
+}
+
+/* Bump arena. deallocate() does nothing, reset() makes all memory
+ * available again in O(1) and keeps the chunks. An arena is not thread
+ * safe, use one per thread, and reset it only after every Tesselator
+ * using it is disposed or destroyed.
+ */
+class Arena : public Allocator
+{
+private:
+    struct chunk
+    {
+        chunk* next;
+        size_t size;
+    };
+
+    const static size_t ALIGN = 16;
+    const static size_t HEADER = (sizeof(chunk) + ALIGN - 1) & ~(ALIGN - 1);
+
+    Allocator* upstream;
+    size_t chunkSize;
+    chunk* head;
+    chunk* current;
+    size_t offset;
+
+public:
+    explicit Arena(size_t size = 64 * 1024, Allocator* parent = NULL) :
+        upstream(parent ? parent : default_allocator()),
+        chunkSize(size),
+        head(),
+        current(),
+        offset()
+    {
+    }
+
+    ~Arena()
+    {
+        this->dispose();
+    }
+
+    void* allocate(size_t size)
+    {
+        size = (size + ALIGN - 1) & ~(ALIGN - 1);
+        for (;;) {
+            if (current && offset + size <= current->size) {
+                void* p = reinterpret_cast<unsigned char*>(current) + HEADER + offset;
+                offset += size;
+                return p;
+            }
+            if (current && current->next) {
+                current = current->next;
+                offset = 0;
+                continue;
+            }
+            chunk* c = new_chunk(size > chunkSize ? size : chunkSize);
+            if (current) {
+                current->next = c;
+            }
+            else {
+                head = c;
+            }
+            current = c;
+            offset = 0;
+        }
+    }
+
+    void deallocate(void*, size_t)
+    {
+    }
+
+    /* Releases all allocations at once, the chunks are kept.
+     */
+    void reset()
+    {
+        current = head;
+        offset = 0;
+    }
+
+    /* Returns the chunks to the parent allocator.
+     */
+    void dispose()
+    {
+        while (head) {
+            chunk* next = head->next;
+            upstream->deallocate(head, HEADER + head->size);
+            head = next;
+        }
+        current = NULL;
+        offset = 0;
+    }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    chunk* new_chunk(size_t size)
+    {
+        chunk* c = static_cast<chunk*>(upstream->allocate(HEADER + size));
+        c->next = NULL;
+        c->size = size;
+        return c;
+    }
+};
+
+/* STL allocator over an Allocator, for the std::vector members.
+ */
+template<typename T>
+class allocator
+{
+public:
+    typedef T                 value_type;
+    typedef value_type*       pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef std::size_t       size_type;
+    typedef std::ptrdiff_t    difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef allocator<U> other;
+    };
+
+    Allocator* source;
+
+public:
+    explicit allocator(Allocator* a = NULL) : source(a ? a : default_allocator())
+    {
+    }
+
+    template<typename U>
+    allocator(const allocator<U>& other) : source(other.source)
+    {
+    }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        return static_cast<pointer>(source->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        source->deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size()const
+    {
+        return size_type(-1) / sizeof(T);
+    }
+
+    pointer address(reference x)const
+    {
+        return &x;
+    }
+
+    const_pointer address(const_reference x)const
+    {
+        return &x;
+    }
+
+    void construct(pointer p, const T& x)
+    {
+        new(p) T(x);
+    }
+
+    void destroy(pointer p)
+    {
+        p->~T();
+    }
+
+    template<typename U>
+    bool operator==(const allocator<U>& other)const
+    {
+        return source == other.source;
+    }
+
+    template<typename U>
+    bool operator!=(const allocator<U>& other)const
+    {
+        return source != other.source;
+    }
+};
+
 //
 // memory pool
 //
@@ -289,15 +746,20 @@ private:
 
     typedef node *page_type;
 
+    Allocator* source;
     node* entry;    // free space entry
-    std::vector<page_type> poolbuf;
+    std::vector<page_type, allocator<page_type> > poolbuf;
+    size_type page;     // first page that has never been handed out completely
+    size_type offset;   // first unused node in that page
 
 public:
-    pool() : entry()
+    explicit pool(Allocator* a = NULL) : source(a ? a : default_allocator()),
+        entry(), poolbuf(allocator<page_type>(source)), page(), offset()
     {
     }
 
-    pool(const this_type&) : entry()
+    pool(const this_type& other) : source(other.source),
+        entry(), poolbuf(allocator<page_type>(source)), page(), offset()
     {
     }
 
@@ -324,13 +786,23 @@ public:
     pointer allocate(size_type size = 1, const_pointer = 0)
     {
         assert(size == 1);
-        if (!entry) {
-            node* buf = allocate_buffer();
-            entry = buf;
-        }
         node* n = entry;
-        entry = entry->next;
-        return this->address(n);
+        if (n) {
+            entry = entry->next;
+        }
+        else {
+            /* take the next untouched node, pages are kept by clear() */
+            if (offset == PageSize) {
+                ++page;
+                offset = 0;
+            }
+            if (page == poolbuf.size()) {
+                allocate_buffer();
+            }
+            n = poolbuf[page] + offset;
+            ++offset;
+        }
+        return this->address(new (n) node());
     }
 
     pointer allocate(size_type n, size_type alignment, const_pointer = 0)
@@ -352,21 +824,14 @@ public:
         return nullptr;
     }
 
+    /* Releases all objects but keeps the pages for reuse.
+     * Nodes are handed out page by page, so this is O(1).
+     */
     void clear()
     {
-        if (poolbuf.empty()) {
-            return;
-        }
-
         entry = nullptr;
-        for (size_type i = 0; i < poolbuf.size(); ++i) {
-            page_type page = poolbuf[i];
-            for (size_type j = 0; j < PAGE_SIZE; ++j) {
-                page[j] = page + j + 1;
-            }
-            page[PAGE_SIZE - 1].next = entry;
-            entry = page[0];
-        }
+        page = 0;
+        offset = 0;
     }
 
     void dispose()
@@ -374,8 +839,10 @@ public:
         for (size_type i = 0; i < poolbuf.size(); ++i) {
             deallocate_buffer(poolbuf[i]);
         }
-        poolbuf.clear();
+        std::vector<page_type, allocator<page_type> >(poolbuf.get_allocator()).swap(poolbuf);
         entry = nullptr;
+        page = 0;
+        offset = 0;
     }
 
     size_type max_size()const
@@ -398,6 +865,9 @@ public:
             ++n;
             p = p->next;
         }
+        if (!poolbuf.empty()) {
+            n += (poolbuf.size() - page) * PAGE_SIZE - offset;
+        }
         return n;
     }
 
@@ -419,19 +889,14 @@ public:
 private:
     page_type allocate_buffer()
     {
-        page_type page = new node[PageSize];
-        // init page
-        for (size_type i = 0; i < PageSize; ++i) {
-            page[i].next = page + i + 1;
-        }
-        page[PageSize - 1].next = nullptr;
-        poolbuf.push_back(page);
-        return page;
+        page_type buf = static_cast<page_type>(source->allocate(sizeof(node) * PageSize));
+        poolbuf.push_back(buf);
+        return buf;
     }
 
     void deallocate_buffer(page_type &page)
     {
-        delete[]page;
+        source->deallocate(page, sizeof(node) * PageSize);
         page = nullptr;
     }
 
@@ -450,9 +915,10 @@ private:
 // PriorityQueue
 //
 
-struct Vertex;
-bool VertexLessEqual(Vertex* u, Vertex* v);
+template<typename Config>
+bool VertexLessEqual(BasicVertex<Config>* u, BasicVertex<Config>* v);
 
+template<typename Vertex>
 struct VertexLEQ
 {
     bool operator()(Vertex* u, Vertex* v)const
@@ -461,12 +927,17 @@ struct VertexLEQ
     }
 };
 
+template<typename Vertex>
 class vertex_stack
 {
 protected:
-    std::set<Vertex*, VertexLEQ> heap;
+    std::set<Vertex*, VertexLEQ<Vertex>, allocator<Vertex*> > heap;
 
 public:
+    explicit vertex_stack(Allocator* a = NULL) : heap(VertexLEQ<Vertex>(), allocator<Vertex*>(a))
+    {
+    }
+
     bool empty()const
     {
         return heap.empty();
@@ -502,6 +973,11 @@ public:
         heap.clear();
     }
 
+    void dispose()
+    {
+        heap.clear();
+    }
+
     Vertex* find(Vertex* v)
     {
         if (heap.find(v) != heap.end()) {
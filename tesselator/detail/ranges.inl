@@ -0,0 +1,105 @@
+#ifndef LIBTESS_RANGES_INL
+#define LIBTESS_RANGES_INL
+
+namespace libtess {
+
+/* Moves elements to shortElements. If all vertices fit in 16 bits there
+ * is one range, otherwise the primitives are taken in order and a new
+ * range is started when the next one would need more than
+ * LIBTESS_SHORT_RANGE_VERTICES vertices in the current range. A primitive
+ * has primitiveSize elements, or with 0 runs to the next INVALID_INDEX. Each range
+ * gets its own copy of the vertices it uses, in the order of first use,
+ * so the vertices shared by two ranges are duplicated.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::SplitDrawRanges(size_t primitiveSize)
+{
+    size_t vertexCount = this->vertices.size();
+    size_t elementCount = this->elements.size();
+
+    shortElements.resize(elementCount);
+    drawRanges.clear();
+
+    if (vertexCount <= LIBTESS_SHORT_RANGE_VERTICES) {
+        for (size_t i = 0; i < elementCount; ++i) {
+            shortElements[i] = uint16_t(this->elements[i]);
+        }
+        if (elementCount) {
+            TessDrawRange range = { 0, Index(vertexCount), 0, Index(elementCount) };
+            drawRanges.push_back(range);
+        }
+        this->elements.clear();
+        return LIBTESS_OK;
+    }
+
+    if (primitiveSize > LIBTESS_SHORT_RANGE_VERTICES || (primitiveSize && elementCount % primitiveSize)) {
+        LIBTESS_LOG("Tesselator.Tesselate() : elements can not be split in draw ranges.");
+        return LIBTESS_ERROR;
+    }
+
+    /* rangeMap[v * 2] is the last range that used vertex v, and
+     * rangeMap[v * 2 + 1] its number there
+     */
+    rangeMap.assign(vertexCount * 2, INVALID_INDEX);
+    rangeVertices.clear();
+    rangeIndices.clear();
+
+    TessDrawRange range = { 0, 0, 0, 0 };
+    for (size_t i = 0, end; i < elementCount; i = end) {
+        Index id = Index(drawRanges.size());
+        size_t added = 0;
+
+        end = i + primitiveSize;
+        if (primitiveSize == 0) {
+            while (end < elementCount && this->elements[end++] != INVALID_INDEX) {}
+            if (end - i > LIBTESS_SHORT_RANGE_VERTICES + 1) {
+                LIBTESS_LOG("Tesselator.Tesselate() : elements can not be split in draw ranges.");
+                return LIBTESS_ERROR;
+            }
+        }
+
+        for (size_t j = i; j < end; ++j) {
+            Index v = this->elements[j];
+            if (v != INVALID_INDEX && rangeMap[v * 2] != id) {
+                rangeMap[v * 2] = id;
+                rangeMap[v * 2 + 1] = INVALID_INDEX;
+                ++added;
+            }
+        }
+
+        if (size_t(range.vertexCount) + added > LIBTESS_SHORT_RANGE_VERTICES) {
+            range.elementCount = Index(i) - range.firstElement;
+            drawRanges.push_back(range);
+            range.baseVertex += range.vertexCount;
+            range.vertexCount = 0;
+            range.firstElement = Index(i);
+            id = Index(drawRanges.size());
+        }
+
+        for (size_t j = i; j < end; ++j) {
+            Index v = this->elements[j];
+            if (v == INVALID_INDEX) {
+                shortElements[j] = uint16_t(0xFFFF);
+                continue;
+            }
+            if (rangeMap[v * 2] != id || rangeMap[v * 2 + 1] == INVALID_INDEX) {
+                rangeMap[v * 2] = id;
+                rangeMap[v * 2 + 1] = range.vertexCount++;
+                rangeVertices.push_back(this->vertices[v]);
+                rangeIndices.push_back(this->indices[v]);
+            }
+            shortElements[j] = uint16_t(rangeMap[v * 2 + 1]);
+        }
+    }
+    range.elementCount = Index(elementCount) - range.firstElement;
+    drawRanges.push_back(range);
+
+    this->vertices.swap(rangeVertices);
+    this->indices.swap(rangeIndices);
+    this->elements.clear();
+    return LIBTESS_OK;
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_RANGES_INL
@@ -0,0 +1,197 @@
+#ifndef LIBTESS_STRIPS_INL
+#define LIBTESS_STRIPS_INL
+
+namespace libtess {
+
+/* A face that can not join a strip: outside, or already in one.
+ */
+template<typename Config>
+LIBTESS_INLINE bool StripMarked(BasicFace<Config>* f)
+{
+    return f == NULL || !f->inside || f->marked;
+}
+
+template<typename Config>
+LIBTESS_INLINE void AddToTrail(BasicFace<Config>* f, BasicFace<Config>*& trail)
+{
+    f->trail = trail;
+    trail = f;
+    f->marked = TRUE;
+}
+
+/* The longest strip with the triangle on the left of eOrig, as in the GLU
+ * renderer. It walks forward and backward as far as possible, starting
+ * from the side with an even number of triangles so that every triangle
+ * keeps its orientation. Returns the first edge of the strip and its
+ * number of triangles in size.
+ */
+template<typename Config>
+LIBTESS_INLINE typename BasicTesselator<Config>::HalfEdge* BasicTesselator<Config>::MaximumStrip(HalfEdge* eOrig, size_t& size)
+{
+    size_t headSize = 0, tailSize = 0;
+    Face *trail = NULL;
+    HalfEdge *e, *eTail, *eHead, *eStart;
+
+    for (e = eOrig; !StripMarked(e->Lface); ++tailSize, e = e->Onext) {
+        AddToTrail(e->Lface, trail);
+        ++tailSize;
+        e = e->Lnext->mirror;         /* Dprev */
+        if (StripMarked(e->Lface)) break;
+        AddToTrail(e->Lface, trail);
+    }
+    eTail = e;
+
+    for (e = eOrig; !StripMarked(e->mirror->Lface); ++headSize, e = e->mirror->Onext->mirror) { /* Dnext */
+        AddToTrail(e->mirror->Lface, trail);
+        ++headSize;
+        e = e->mirror->Lnext;         /* Oprev */
+        if (StripMarked(e->mirror->Lface)) break;
+        AddToTrail(e->mirror->Lface, trail);
+    }
+    eHead = e;
+
+    size = tailSize + headSize;
+    if ((tailSize & 1) == 0) {
+        eStart = eTail->mirror;
+    }
+    else if ((headSize & 1) == 0) {
+        eStart = eHead;
+    }
+    else {
+        /* Both sides have odd length, we must shorten one of them. In fact,
+         * we must start from eHead to guarantee inclusion of eOrig->Lface.
+         */
+        --size;
+        eStart = eHead->Onext;
+    }
+
+    while (trail) {
+        trail->marked = FALSE;
+        trail = trail->trail;
+    }
+    return eStart;
+}
+
+/* Appends vertex n to the strip at the end of stripElements, which has
+ * length vertices so far. Strips are cut after an even number of
+ * triangles to fit in a draw range of shortIndices; the next one repeats
+ * the last two vertices and keeps the orientation.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::AppendStrip(Index n, size_t& length)
+{
+    if (length == (LIBTESS_SHORT_RANGE_VERTICES & ~1)) {
+        Index a = stripElements[stripElements.size() - 2];
+        Index b = stripElements[stripElements.size() - 1];
+        stripElements.push_back(INVALID_INDEX);
+        stripElements.push_back(a);
+        stripElements.push_back(b);
+        length = 2;
+    }
+    stripElements.push_back(n);
+    ++length;
+}
+
+/* Covers the inside triangles with strips, greedily: from each triangle
+ * not in a strip yet, the longest of the three strips through it is
+ * taken. The strips are joined with INVALID_INDEX, the primitive restart
+ * index of 32-bit elements, and 0xFFFF with shortIndices. Each triangle
+ * has the orientation it has in TESS_TRIANGLES.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::RenderStrips()
+{
+    Vertex *v;
+    Face *f;
+    HalfEdge *e;
+    size_t vertexCount = 0;
+    size_t vertexBase, elementBase;
+    bool joined = !outputSink && !this->elements.empty(); /* after the previous components */
+
+    stripElements.clear();
+
+    for (v = mesh.m_vtxHead.next; v != &mesh.m_vtxHead; v = v->next) {
+        v->n = INVALID_INDEX;
+    }
+    for (f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
+        f->marked = FALSE;
+        f->n = INVALID_INDEX;
+    }
+
+    for (f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
+        if (StripMarked(f)) {
+            continue;
+        }
+
+        size_t size = 0, length = 0;
+        HalfEdge *eStart = NULL;
+        e = f->edge;
+        for (int i = 0; i < 3; ++i, e = e->Lnext) {
+            size_t n;
+            HalfEdge *s = this->MaximumStrip(e, n);
+            if (n > size) {
+                size = n;
+                eStart = s;
+            }
+        }
+        assert(size > 0);
+
+        if (joined || !stripElements.empty()) {
+            stripElements.push_back(INVALID_INDEX);
+        }
+
+        /* number the vertices in the order of first use, as RenderTriangles() */
+        e = eStart;
+        Vertex *strip[2] = { e->vertex, e->mirror->vertex };
+        for (int i = 0; i < 2; ++i) {
+            if (strip[i]->n == INVALID_INDEX) {
+                strip[i]->n = Index(vertexCount++);
+            }
+            this->AppendStrip(strip[i]->n, length);
+        }
+        while (size > 0) {
+            assert(!StripMarked(e->Lface));
+            e->Lface->marked = TRUE;
+            --size;
+            e = e->Lnext->mirror;     /* Dprev */
+            v = e->vertex;
+            if (size > 0) {
+                e->Lface->marked = TRUE;
+                --size;
+                e = e->Onext;
+                if (v->n == INVALID_INDEX) {
+                    v->n = Index(vertexCount++);
+                }
+                this->AppendStrip(v->n, length);
+                v = e->mirror->vertex;
+            }
+            if (v->n == INVALID_INDEX) {
+                v->n = Index(vertexCount++);
+            }
+            this->AppendStrip(v->n, length);
+        }
+
+    }
+
+    if (!this->OutputBegin(vertexCount, stripElements.size(), vertexBase, elementBase)) {
+        return LIBTESS_ERROR;
+    }
+
+    for (v = mesh.m_vtxHead.next; v != &mesh.m_vtxHead; v = v->next) {
+        if (v->n != INVALID_INDEX) {
+            v->n += Index(vertexBase);
+            this->WriteVertex(v->n, v->coords.x, v->coords.y, v->coords.z);
+        }
+    }
+
+    for (size_t i = 0; i < stripElements.size(); ++i) {
+        Index n = stripElements[i];
+        this->WriteElement(elementBase + i, n == INVALID_INDEX ? n : n + Index(vertexBase));
+    }
+
+    return LIBTESS_OK;
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_STRIPS_INL
@@ -37,6 +37,7 @@
 
 #include "dict.hpp"
 #include "mesh.hpp"
+#include "priorityq.hpp"
 
 namespace libtess {
 
@@ -48,8 +49,11 @@ namespace libtess {
 * sweep line crosses each vertex, we update the affected regions.
 */
 
-struct ActiveRegion
+template<typename Config>
+struct BasicActiveRegion
 {
+    LIBTESS_CONFIG_TYPES(Config);
+
     HalfEdge *eUp;      /* upper edge, directed right to left */
     DictNode *nodeUp;   /* dictionary node corresponding to eUp.  eUp Ӧ dict ڵ */
     int windingNumber;  /* used to determine which regions are inside the polygon */
@@ -65,37 +69,53 @@ struct ActiveRegion
 
 /* һ
  */
-LIBTESS_INLINE ActiveRegion* RegionBelow(ActiveRegion* r)
+template<typename Config>
+LIBTESS_INLINE BasicActiveRegion<Config>* RegionBelow(BasicActiveRegion<Config>* r)
 {
+    typedef BasicActiveRegion<Config> ActiveRegion;
+
     return (ActiveRegion *) ((r)->nodeUp)->prev->key;
 }
 
 /* һ
  */
-LIBTESS_INLINE ActiveRegion* RegionAbove(ActiveRegion* r)
+template<typename Config>
+LIBTESS_INLINE BasicActiveRegion<Config>* RegionAbove(BasicActiveRegion<Config>* r)
 {
+    typedef BasicActiveRegion<Config> ActiveRegion;
+
     return (ActiveRegion *) ((r)->nodeUp)->next->key;
 }
 
-//#define LIBTESS_USE_PriorityQ
+#define LIBTESS_USE_PriorityQ
 
-class Sweep
+template<typename Config>
+class BasicSweep
 {
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
 protected:
     int windingRule;      /* rule for determining polygon interior */
     Dict dict;            /* edge dictionary for sweep line */
-    vertex_stack pq;      /* priority queue of vertex events */
+    #ifdef LIBTESS_USE_PriorityQ
+    PriorityQ pq;         /* priority queue of vertex events */
+    #else
+    vertex_stack<Vertex> pq;      /* priority queue of vertex events */
+    #endif
     Vertex *currentEvent; /* current sweep event being processed */
 
-    pool<ActiveRegion, LIBTESS_PAGE_SIZE> regionbuf;
+    pool<ActiveRegion, Config::PAGE_SIZE> regionbuf;
+    allocator<ActiveRegion> regionalloc;    /* one region per allocation without the pool */
 
 public:
     //jmp_buf env;          /* place to jump to when memAllocs fail */
 
 public:
-    Sweep();
+    explicit BasicSweep(Allocator* a = NULL);
     int init(int rule);
     void dispose();
+    void clear();
 
     int ComputeInterior(Mesh& mesh, const AABB& aabb);
 
@@ -104,8 +124,8 @@ private:
     void deallocate(ActiveRegion*);
 
 
-    int IsWindingInside(int n);
-    void ComputeWinding(ActiveRegion *reg);
+    template<int Rule> static int IsWindingInside(int n);
+    template<int Rule> void ComputeWinding(ActiveRegion *reg);
 
     void InitEdgeDict(Mesh& mesh, const AABB& aabb);
     void DoneEdgeDict();
@@ -113,9 +133,9 @@ private:
     int InitPriorityQ(Mesh& mesh);
     void DonePriorityQ();
 
-    void AddSentinel(Mesh& mesh, Float smin, Float smax, Float t);
+    void AddSentinel(Mesh& mesh, Coord smin, Coord smax, Coord t);
     ActiveRegion* AddRegionBelow(ActiveRegion *regAbove, HalfEdge *eNewUp);
-    void AddRightEdges(Mesh& mesh, ActiveRegion *regUp, HalfEdge *eFirst, HalfEdge *eLast, HalfEdge *eTopLeft, int cleanUp);
+    template<int Rule> void AddRightEdges(Mesh& mesh, ActiveRegion *regUp, HalfEdge *eFirst, HalfEdge *eLast, HalfEdge *eTopLeft, int cleanUp);
     void DeleteRegion(ActiveRegion* r);
     void FinishRegion(ActiveRegion* r);
     HalfEdge* FinishLeftRegions(Mesh& mesh, ActiveRegion *regFirst, ActiveRegion *regLast);
@@ -123,16 +143,17 @@ private:
     int CheckForLeftSplice(Mesh& mesh, ActiveRegion *regUp);
     int CheckForRightSplice(Mesh& mesh, ActiveRegion *regUp);
 
-    int CheckForIntersect(Mesh& mesh, ActiveRegion *regUp);
+    template<int Rule> int CheckForIntersect(Mesh& mesh, ActiveRegion *regUp);
     void GetIntersectData(Vertex *isect, Vertex *orgUp, Vertex *dstUp, Vertex *orgLo, Vertex *dstLo);
 
-    void WalkDirtyRegions(Mesh& mesh, ActiveRegion *regUp);
+    template<int Rule> void WalkDirtyRegions(Mesh& mesh, ActiveRegion *regUp);
 
-    void ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp, Vertex *vEvent);
-    void ConnectLeftVertex(Mesh& mesh, Vertex *vEvent);
-    void ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, HalfEdge *eBottomLeft);
+    template<int Rule> void ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp, Vertex *vEvent);
+    template<int Rule> void ConnectLeftVertex(Mesh& mesh, Vertex *vEvent);
+    template<int Rule> void ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, HalfEdge *eBottomLeft);
 
-    void SweepEvent(Mesh& mesh, Vertex *vEvent);
+    template<int Rule> void SweepEvent(Mesh& mesh, Vertex *vEvent);
+    template<int Rule> void SweepEvents(Mesh& mesh);
 
     void RemoveDegenerateEdges(Mesh& mesh);
     bool RemoveDegenerateFaces(Mesh& mesh);
@@ -144,43 +165,60 @@ private:
 // source
 //
 
-LIBTESS_INLINE Sweep::Sweep()
+template<typename Config>
+LIBTESS_INLINE BasicSweep<Config>::BasicSweep(Allocator* a) : dict(a), pq(a), regionbuf(a), regionalloc(a)
 {
     windingRule = TESS_WINDING_ODD;
     currentEvent = NULL;
 }
 
-LIBTESS_INLINE int Sweep::init(int value)
+template<typename Config>
+LIBTESS_INLINE int BasicSweep<Config>::init(int value)
 {
     windingRule = value;
     currentEvent = NULL;
     return LIBTESS_OK;
 }
 
-LIBTESS_INLINE void Sweep::dispose()
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::dispose()
 {
     dict.dispose();
-    pq.clear();
+    pq.dispose();
     regionbuf.dispose();
     currentEvent = NULL;
 }
 
-LIBTESS_INLINE ActiveRegion* Sweep::allocate()
+/* Like dispose(), but the pool pages and queue buffers are kept.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::clear()
+{
+    dict.clear();
+    pq.clear();
+    regionbuf.clear();
+    currentEvent = NULL;
+}
+
+template<typename Config>
+LIBTESS_INLINE BasicActiveRegion<Config>* BasicSweep<Config>::allocate()
 {
-    #ifdef LIBTESS_USE_POOL
-    return regionbuf.allocate();
-    #else
-    return new ActiveRegion;
-    #endif
+    if (Config::USE_POOL) {
+        return regionbuf.allocate();
+    }
+    return new (regionalloc.allocate(1)) ActiveRegion();
 }
 
-LIBTESS_INLINE void Sweep::deallocate(ActiveRegion* r)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::deallocate(ActiveRegion* r)
 {
-    #ifdef LIBTESS_USE_POOL
-    return regionbuf.deallocate(r);
-    #else
-    delete r;
-    #endif
+    if (Config::USE_POOL) {
+        regionbuf.deallocate(r);
+    }
+    else {
+        r->~ActiveRegion();
+        regionalloc.deallocate(r, 1);
+    }
 }
 
 }// end namespace libtess
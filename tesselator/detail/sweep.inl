@@ -106,11 +106,11 @@ extern void DebugEvent(TESStesselator *tess);
  * Щ㱻Ƶ÷ǳȶȻġ
  * Ŀĵضɨ¼Уǽ¶ȶԱ߽򣨷ǽȵؽбȽϣ
  */
-LIBTESS_INLINE int Sweep::EdgeLeq(Sweep* sweep, ActiveRegion *reg1, ActiveRegion *reg2)
+template<typename Config>
+LIBTESS_INLINE int BasicSweep<Config>::EdgeLeq(Sweep* sweep, ActiveRegion *reg1, ActiveRegion *reg2)
 {
     Vertex *event = sweep->currentEvent;
     HalfEdge *e1, *e2;
-    Float t1, t2;
 
     e1 = reg1->eUp;
     e2 = reg2->eUp;
@@ -132,14 +132,13 @@ LIBTESS_INLINE int Sweep::EdgeLeq(Sweep* sweep, ActiveRegion *reg1, ActiveRegion
     }
 
     /* General case - compute signed distance *from* e1, e2 to event */
-    t1 = EdgeEval(e1->mirror->vertex, event, e1->vertex);
-    t2 = EdgeEval(e2->mirror->vertex, event, e2->vertex);
-    return (t1 >= t2);
+    return EdgeEvalGEQ(e1->mirror->vertex, e1->vertex, e2->mirror->vertex, e2->vertex, event);
 }
 
 /* ɾ ActiveRegion
  */
-LIBTESS_INLINE void Sweep::DeleteRegion(ActiveRegion *reg)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::DeleteRegion(ActiveRegion *reg)
 {
     if (reg->fixUpperEdge) {
         /* It was created with zero winding number, so it better be
@@ -158,7 +157,8 @@ LIBTESS_INLINE void Sweep::DeleteRegion(ActiveRegion *reg)
 /* Replace an upper edge which needs fixing (see ConnectRightVertex).
  * Ҫ޸ϱԵμ ConnectRightVertex
  */
-LIBTESS_INLINE int FixUpperEdge(Mesh& mesh, ActiveRegion *reg, HalfEdge *newEdge)
+template<typename Config>
+LIBTESS_INLINE int FixUpperEdge(BasicMesh<Config>& mesh, BasicActiveRegion<Config> *reg, BasicHalfEdge<Config> *newEdge)
 {
     assert(reg->fixUpperEdge);
     if (!mesh.DeleteEdge(reg->eUp)) return 0;
@@ -169,8 +169,12 @@ LIBTESS_INLINE int FixUpperEdge(Mesh& mesh, ActiveRegion *reg, HalfEdge *newEdge
     return 1;
 }
 
-LIBTESS_STATIC ActiveRegion *TopLeftRegion(Mesh& mesh, ActiveRegion *reg)
+template<typename Config>
+LIBTESS_STATIC BasicActiveRegion<Config> *TopLeftRegion(BasicMesh<Config>& mesh, BasicActiveRegion<Config> *reg)
 {
+    typedef BasicVertex<Config> Vertex;
+    typedef BasicHalfEdge<Config> HalfEdge;
+
     Vertex *org = reg->eUp->vertex;
     HalfEdge *e;
 
@@ -196,8 +200,11 @@ LIBTESS_STATIC ActiveRegion *TopLeftRegion(Mesh& mesh, ActiveRegion *reg)
     return reg;
 }
 
-LIBTESS_STATIC ActiveRegion *TopRightRegion(ActiveRegion *reg)
+template<typename Config>
+LIBTESS_STATIC BasicActiveRegion<Config> *TopRightRegion(BasicActiveRegion<Config> *reg)
 {
+    typedef BasicVertex<Config> Vertex;
+
     Vertex *dst = reg->eUp->mirror->vertex;
 
     /* Find the region above the uppermost edge with the same destination */
@@ -218,7 +225,8 @@ LIBTESS_STATIC ActiveRegion *TopRightRegion(ActiveRegion *reg)
  * ϱԵ "eNewUp"
  * ź "inside" ־¡
  */
-LIBTESS_INLINE ActiveRegion* Sweep::AddRegionBelow(ActiveRegion *regAbove, HalfEdge *eNewUp)
+template<typename Config>
+LIBTESS_INLINE BasicActiveRegion<Config>* BasicSweep<Config>::AddRegionBelow(ActiveRegion *regAbove, HalfEdge *eNewUp)
 {
     ActiveRegion *regNew = this->allocate();
     //if (regNew == NULL) longjmp(tess->env,1);
@@ -234,7 +242,7 @@ LIBTESS_INLINE ActiveRegion* Sweep::AddRegionBelow(ActiveRegion *regAbove, HalfE
     return regNew;
 }
 
-LIBTESS_INLINE int Sweep::IsWindingInside(int n)
+LIBTESS_INLINE int IsWindingInside(int windingRule, int n)
 {
     switch (windingRule) {
     case TESS_WINDING_ODD:
@@ -255,10 +263,56 @@ LIBTESS_INLINE int Sweep::IsWindingInside(int n)
     return(FALSE);
 }
 
-LIBTESS_INLINE void Sweep::ComputeWinding(ActiveRegion *reg)
+/* The winding rules as types, so that the sweep is instantiated once per
+ * rule and the inside test compiles to a few branchless instructions.
+ */
+template<int Rule>
+struct WindingRule;
+
+template<>
+struct WindingRule<TESS_WINDING_ODD>
+{
+    static int inside(int n) { return n & 1; }
+};
+
+template<>
+struct WindingRule<TESS_WINDING_NONZERO>
+{
+    static int inside(int n) { return n != 0; }
+};
+
+template<>
+struct WindingRule<TESS_WINDING_POSITIVE>
+{
+    static int inside(int n) { return n > 0; }
+};
+
+template<>
+struct WindingRule<TESS_WINDING_NEGATIVE>
+{
+    static int inside(int n) { return n < 0; }
+};
+
+template<>
+struct WindingRule<TESS_WINDING_ABS_GEQ_TWO>
+{
+    /* n >= 2 || n <= -2, as n + 1 is outside [0, 2] */
+    static int inside(int n) { return unsigned(n) + 1u > 2u; }
+};
+
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE int BasicSweep<Config>::IsWindingInside(int n)
+{
+    return WindingRule<Rule>::inside(n);
+}
+
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::ComputeWinding(ActiveRegion *reg)
 {
     reg->windingNumber = RegionAbove(reg)->windingNumber + reg->eUp->winding;
-    reg->inside = IsWindingInside(reg->windingNumber);
+    reg->inside = IsWindingInside<Rule>(reg->windingNumber);
 }
 
 /*
@@ -272,7 +326,8 @@ LIBTESS_INLINE void Sweep::ComputeWinding(ActiveRegion *reg)
  * "inside" ־Ƶʵ
  *ǰΪĽṹڱ仯ֱڲŴڣ
  */
-LIBTESS_INLINE void Sweep::FinishRegion(ActiveRegion *r)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::FinishRegion(ActiveRegion *r)
 {
     HalfEdge *e = r->eUp;
     Face *f = e->Lface;
@@ -302,7 +357,8 @@ LIBTESS_INLINE void Sweep::FinishRegion(ActiveRegion *r)
  *  regLast ϵֹͣ regLast ΪգǽܵΡ
  * ͬʱҪǽԱ vOrg Χıߵ˳ֵеͬ
  */
-LIBTESS_INLINE HalfEdge* Sweep::FinishLeftRegions(Mesh& mesh, ActiveRegion *regFirst, ActiveRegion *regLast)
+template<typename Config>
+LIBTESS_INLINE BasicHalfEdge<Config>* BasicSweep<Config>::FinishLeftRegions(Mesh& mesh, ActiveRegion *regFirst, ActiveRegion *regLast)
 {
     ActiveRegion *reg, *regPrev;
     HalfEdge *e, *ePrev;
@@ -360,7 +416,9 @@ LIBTESS_INLINE HalfEdge* Sweep::FinishLeftRegions(Mesh& mesh, ActiveRegion *regF
  * ô eTopLeft ıߣ vOrg һ鹹ϴֱ
  *  eTopLeft->Oprev  eTopLeft ֮䣻 eTopLeft ӦΪա
  */
-LIBTESS_INLINE void Sweep::AddRightEdges(
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::AddRightEdges(
     Mesh& mesh,
     ActiveRegion *regUp,
     HalfEdge *eFirst,
@@ -401,7 +459,7 @@ LIBTESS_INLINE void Sweep::AddRightEdges(
         }
         /* Compute the winding number and "inside" flag for the new regions */
         reg->windingNumber = regPrev->windingNumber - e->winding;
-        reg->inside = IsWindingInside(reg->windingNumber);
+        reg->inside = IsWindingInside<Rule>(reg->windingNumber);
 
         /* Check for two outgoing edges with same slope -- process these
          * before any intersection tests (see example in tessComputeInterior).
@@ -421,7 +479,7 @@ LIBTESS_INLINE void Sweep::AddRightEdges(
 
     if (cleanUp) {
         /* Check for intersections between newly adjacent edges. */
-        WalkDirtyRegions(mesh, regPrev);
+        WalkDirtyRegions<Rule>(mesh, regPrev);
     }
 }
 
@@ -435,8 +493,11 @@ LIBTESS_INLINE void Sweep::AddRightEdges(
  *  "isect" еÿһ50%Ȩأ
  * ÿ߸ݵ "isect" Ծ org  dst ָ֮Ȩء
  */
-LIBTESS_STATIC void VertexWeights(Vertex *isect, Vertex *org, Vertex *dst, Float *weights)
+template<typename Config>
+LIBTESS_STATIC void VertexWeights(BasicVertex<Config> *isect, BasicVertex<Config> *org, BasicVertex<Config> *dst, typename Config::Float *weights)
 {
+    typedef typename Config::Float Float;
+
     Float t1 = VertexDistance(org, isect);
     Float t2 = VertexDistance(dst, isect);
 
@@ -456,7 +517,8 @@ LIBTESS_STATIC void VertexWeights(Vertex *isect, Vertex *org, Vertex *dst, Float
  * ԱǿȾص¶㡣
  * صѾɾ
  */
-LIBTESS_INLINE void Sweep::GetIntersectData(Vertex *isect, Vertex *orgUp, Vertex *dstUp, Vertex *orgLo, Vertex *dstLo)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::GetIntersectData(Vertex *isect, Vertex *orgUp, Vertex *dstUp, Vertex *orgLo, Vertex *dstLo)
 {
     Float weights[4];
     //TESS_NOTUSED( tess );
@@ -465,6 +527,12 @@ LIBTESS_INLINE void Sweep::GetIntersectData(Vertex *isect, Vertex *orgUp, Vertex
     isect->idx = INVALID_INDEX;
     VertexWeights(isect, orgUp, dstUp, &weights[0]);
     VertexWeights(isect, orgLo, dstLo, &weights[2]);
+
+    if (Config::INTEGER_COORDS) {
+        /* the point on the grid, not on the edges */
+        isect->coords.x = Float(isect->t);
+        isect->coords.y = Float(isect->s);
+    }
 }
 
 /*
@@ -512,7 +580,8 @@ LIBTESS_INLINE void Sweep::GetIntersectData(Vertex *isect, Vertex *orgUp, Vertex
  * һб֤Ľöô⡣
  * һֵϽ⡣
  */
-LIBTESS_INLINE int Sweep::CheckForRightSplice(Mesh& mesh, ActiveRegion *regUp)
+template<typename Config>
+LIBTESS_INLINE int BasicSweep<Config>::CheckForRightSplice(Mesh& mesh, ActiveRegion *regUp)
 {
     ActiveRegion *regLo = RegionBelow(regUp);
     HalfEdge *eUp = regUp->eUp;
@@ -589,7 +658,8 @@ LIBTESS_INLINE int Sweep::CheckForRightSplice(Mesh& mesh, ActiveRegion *regUp)
  *
  * ֻ轫ĶƴӵһϾͿԽ⡣
  */
-LIBTESS_INLINE int Sweep::CheckForLeftSplice(Mesh& mesh, ActiveRegion *regUp)
+template<typename Config>
+LIBTESS_INLINE int BasicSweep<Config>::CheckForLeftSplice(Mesh& mesh, ActiveRegion *regUp)
 {
     ActiveRegion *regLo = RegionBelow(regUp);
     HalfEdge *eUp = regUp->eUp;
@@ -643,7 +713,9 @@ LIBTESS_INLINE int Sweep::CheckForLeftSplice(Mesh& mesh, ActiveRegion *regUp)
  * £Ѽ "dirty" Ľ
  * ҿɾ regUp
  */
-LIBTESS_INLINE int Sweep::CheckForIntersect(Mesh& mesh, ActiveRegion *regUp)
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE int BasicSweep<Config>::CheckForIntersect(Mesh& mesh, ActiveRegion *regUp)
 {
     ActiveRegion *regLo = RegionBelow(regUp);
     HalfEdge *eUp = regUp->eUp;
@@ -652,7 +724,7 @@ LIBTESS_INLINE int Sweep::CheckForIntersect(Mesh& mesh, ActiveRegion *regUp)
     Vertex *orgLo = eLo->vertex;
     Vertex *dstUp = eUp->mirror->vertex;
     Vertex *dstLo = eLo->mirror->vertex;
-    Float tMinUp, tMaxLo;
+    Coord tMinUp, tMaxLo;
     Vertex isect, *orgMin;
     HalfEdge *e;
 
@@ -729,7 +801,7 @@ LIBTESS_INLINE int Sweep::CheckForIntersect(Mesh& mesh, ActiveRegion *regUp)
             LIBTESS_LONGJMP(regUp == NULL);
             eUp = RegionBelow(regUp)->eUp;
             FinishLeftRegions(mesh, RegionBelow(regUp), regLo);
-            AddRightEdges(mesh, regUp, eUp->mirror->Lnext, eUp, eUp, TRUE);
+            AddRightEdges<Rule>(mesh, regUp, eUp->mirror->Lnext, eUp, eUp, TRUE);
             return TRUE;
         }
         if (dstUp == currentEvent) {
@@ -741,7 +813,7 @@ LIBTESS_INLINE int Sweep::CheckForIntersect(Mesh& mesh, ActiveRegion *regUp)
             e = RegionBelow(regUp)->eUp->mirror->Onext;
             regLo->eUp = eLo->mirror->Lnext;
             eLo = FinishLeftRegions(mesh, regLo, NULL);
-            AddRightEdges(mesh, regUp, eLo->Onext, eUp->mirror->Onext, e, TRUE);
+            AddRightEdges<Rule>(mesh, regUp, eLo->Onext, eUp->mirror->Onext, e, TRUE);
             return TRUE;
         }
         /* Special case: called from ConnectRightVertex.  If either
@@ -803,7 +875,9 @@ LIBTESS_INLINE int Sweep::CheckForIntersect(Mesh& mesh, ActiveRegion *regUp)
  * ̱򣬲ȷֵ䲻ҪĴļͷעͣ
  * ȻǽиԻָʱԴµ
  */
-LIBTESS_INLINE void Sweep::WalkDirtyRegions(Mesh& mesh, ActiveRegion *regUp)
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::WalkDirtyRegions(Mesh& mesh, ActiveRegion *regUp)
 {
     ActiveRegion *regLo = RegionBelow(regUp);
     HalfEdge *eUp, *eLo;
@@ -860,7 +934,7 @@ LIBTESS_INLINE void Sweep::WalkDirtyRegions(Mesh& mesh, ActiveRegion *regUp)
                  * violate the invariant that fixable edges are the only right-going
                  * edge from their associated vertex).
                  */
-                if (CheckForIntersect(mesh, regUp)) {
+                if (CheckForIntersect<Rule>(mesh, regUp)) {
                     /* WalkDirtyRegions() was called recursively; we're done */
                     return;
                 }
@@ -913,7 +987,9 @@ LIBTESS_INLINE void Sweep::WalkDirtyRegions(Mesh& mesh, ActiveRegion *regUp)
  * Quite possibly the vertex we connected to will turn out to be the
  * closest one, in which case we won''t need to make any changes.
  */
-LIBTESS_INLINE void Sweep::ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, HalfEdge *eBottomLeft)
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, HalfEdge *eBottomLeft)
 {
     HalfEdge *eNew;
     HalfEdge *eTopLeft = eBottomLeft->Onext;
@@ -923,7 +999,7 @@ LIBTESS_INLINE void Sweep::ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, H
     int degenerate = FALSE;
 
     if (eUp->mirror->vertex != eLo->mirror->vertex) {
-        (void) CheckForIntersect(mesh, regUp);
+        (void) CheckForIntersect<Rule>(mesh, regUp);
     }
 
     /* Possible new degeneracies: upper or lower edge of regUp may pass
@@ -943,7 +1019,7 @@ LIBTESS_INLINE void Sweep::ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, H
         degenerate = TRUE;
     }
     if (degenerate) {
-        AddRightEdges(mesh, regUp, eBottomLeft->Onext, eTopLeft, eTopLeft, TRUE);
+        AddRightEdges<Rule>(mesh, regUp, eBottomLeft->Onext, eTopLeft, eTopLeft, TRUE);
         return;
     }
 
@@ -962,9 +1038,9 @@ LIBTESS_INLINE void Sweep::ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, H
     /* Prevent cleanup, otherwise eNew might disappear before we've even
      * had a chance to mark it as a temporary edge.
      */
-    AddRightEdges(mesh, regUp, eNew, eNew->Onext, eNew->Onext, FALSE);
+    AddRightEdges<Rule>(mesh, regUp, eNew, eNew->Onext, eNew->Onext, FALSE);
     eNew->mirror->activeRegion->fixUpperEdge = TRUE;
-    WalkDirtyRegions(mesh, regUp);
+    WalkDirtyRegions<Rule>(mesh, regUp);
 }
 
 /* Because vertices at exactly the same location are merged together
@@ -981,7 +1057,9 @@ LIBTESS_INLINE void Sweep::ConnectRightVertex(Mesh& mesh, ActiveRegion *regUp, H
  * Adding the new vertex involves splicing it into the already-processed
  * part of the mesh.
  */
-LIBTESS_INLINE void Sweep::ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp, Vertex *vEvent)
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp, Vertex *vEvent)
 {
     HalfEdge *e, *eTopLeft, *eTopRight, *eLast;
     ActiveRegion *reg;
@@ -1005,7 +1083,7 @@ LIBTESS_INLINE void Sweep::ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp
             regUp->fixUpperEdge = FALSE;
         }
         LIBTESS_LONGJMP(!mesh.Splice(vEvent->edge, e));
-        SweepEvent(mesh, vEvent);    /* recurse */
+        SweepEvent<Rule>(mesh, vEvent);    /* recurse */
         return;
     }
 
@@ -1031,7 +1109,7 @@ LIBTESS_INLINE void Sweep::ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp
         /* e->Dst had no left-going edges -- indicate this to AddRightEdges() */
         eTopLeft = NULL;
     }
-    AddRightEdges(mesh, regUp, eTopRight->Onext, eLast, eTopLeft, TRUE);
+    AddRightEdges<Rule>(mesh, regUp, eTopRight->Onext, eLast, eTopLeft, TRUE);
 }
 
 /*
@@ -1049,7 +1127,9 @@ LIBTESS_INLINE void Sweep::ConnectLeftDegenerate(Mesh& mesh, ActiveRegion *regUp
  *	- merging with the active edge of U or L
  *	- merging with an already-processed portion of U or L
  */
-LIBTESS_INLINE void Sweep::ConnectLeftVertex(Mesh& mesh, Vertex *vEvent)
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::ConnectLeftVertex(Mesh& mesh, Vertex *vEvent)
 {
     ActiveRegion *regUp, *regLo, *reg;
     HalfEdge *eUp, *eLo, *eNew;
@@ -1071,7 +1151,7 @@ LIBTESS_INLINE void Sweep::ConnectLeftVertex(Mesh& mesh, Vertex *vEvent)
 
     /* Try merging with U or L first */
     if (EdgeSign(eUp->mirror->vertex, vEvent, eUp->vertex) == 0) {
-        ConnectLeftDegenerate(mesh, regUp, vEvent);
+        ConnectLeftDegenerate<Rule>(mesh, regUp, vEvent);
         return;
     }
 
@@ -1095,15 +1175,15 @@ LIBTESS_INLINE void Sweep::ConnectLeftVertex(Mesh& mesh, Vertex *vEvent)
             LIBTESS_LONGJMP(!FixUpperEdge(mesh, reg, eNew));
         }
         else {
-            ComputeWinding(AddRegionBelow(regUp, eNew));
+            ComputeWinding<Rule>(AddRegionBelow(regUp, eNew));
         }
-        SweepEvent(mesh, vEvent);
+        SweepEvent<Rule>(mesh, vEvent);
     }
     else {
         /* The new vertex is in a region which does not belong to the polygon.
          * We don''t need to connect this vertex to the rest of the mesh.
          */
-        AddRightEdges(mesh, regUp, vEvent->edge, vEvent->edge, NULL, TRUE);
+        AddRightEdges<Rule>(mesh, regUp, vEvent->edge, vEvent->edge, NULL, TRUE);
     }
 }
 
@@ -1114,7 +1194,9 @@ LIBTESS_INLINE void Sweep::ConnectLeftVertex(Mesh& mesh, Vertex *vEvent)
  * ɨߴʱִбҪĲ
  * ģͺͱֵ䡣
  */
-LIBTESS_INLINE void Sweep::SweepEvent(Mesh& mesh, Vertex *vEvent)
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::SweepEvent(Mesh& mesh, Vertex *vEvent)
 {
     ActiveRegion *regUp, *reg;
     HalfEdge *e, *eTopLeft, *eBottomLeft;
@@ -1131,7 +1213,7 @@ LIBTESS_INLINE void Sweep::SweepEvent(Mesh& mesh, Vertex *vEvent)
         e = e->Onext;
         if (e == vEvent->edge) {
             /* All edges go right -- not incident to any processed edges */
-            ConnectLeftVertex(mesh, vEvent);
+            ConnectLeftVertex<Rule>(mesh, vEvent);
             return;
         }
     }
@@ -1156,10 +1238,10 @@ LIBTESS_INLINE void Sweep::SweepEvent(Mesh& mesh, Vertex *vEvent)
      */
     if (eBottomLeft->Onext == eTopLeft) {
         /* No right-going edges -- add a temporary "fixable" edge */
-        ConnectRightVertex(mesh, regUp, eBottomLeft);
+        ConnectRightVertex<Rule>(mesh, regUp, eBottomLeft);
     }
     else {
-        AddRightEdges(mesh, regUp, eBottomLeft->Onext, eTopLeft, eTopLeft, TRUE);
+        AddRightEdges<Rule>(mesh, regUp, eBottomLeft->Onext, eTopLeft, eTopLeft, TRUE);
     }
 }
 
@@ -1171,7 +1253,8 @@ LIBTESS_INLINE void Sweep::SweepEvent(Mesh& mesh, Vertex *vEvent)
  * We add two sentinel edges above and below all other edges,
  * to avoid special cases at the top and bottom.
  */
-LIBTESS_INLINE void Sweep::AddSentinel(Mesh& mesh, Float smin, Float smax, Float t)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::AddSentinel(Mesh& mesh, Coord smin, Coord smax, Coord t)
 {
     HalfEdge *e;
     ActiveRegion *reg = this->allocate();
@@ -1202,13 +1285,21 @@ LIBTESS_INLINE void Sweep::AddSentinel(Mesh& mesh, Float smin, Float smax, Float
  *
  * ʼʵ
  */
-LIBTESS_INLINE void Sweep::InitEdgeDict(Mesh& mesh, const AABB& aabb)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::InitEdgeDict(Mesh& mesh, const AABB& aabb)
 {
+    dict.init(this, (PFN_DICTKEY_COMPARE) EdgeLeq);
+
+    if (Config::INTEGER_COORDS) {
+        /* outside of the input range and at most 2^31 from any vertex */
+        AddSentinel(mesh, -COORD_LIMIT, COORD_LIMIT, -COORD_LIMIT);
+        AddSentinel(mesh, -COORD_LIMIT, COORD_LIMIT, COORD_LIMIT);
+        return;
+    }
+
     Float w, h;
     Float smin, smax, tmin, tmax;
 
-    dict.init(this, (PFN_DICTKEY_COMPARE) EdgeLeq);
-
     /* If the bbox is empty, ensure that sentinels are not coincident by slightly enlarging it. */
     /* ԭ
     w = (tess->bmax[0] - tess->bmin[0]) + (Float)0.01;
@@ -1234,7 +1325,8 @@ LIBTESS_INLINE void Sweep::InitEdgeDict(Mesh& mesh, const AABB& aabb)
 /* رմʵ
  * ɾ ActiveRegion
  */
-LIBTESS_INLINE void Sweep::DoneEdgeDict()
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::DoneEdgeDict()
 {
     ActiveRegion *reg;
     int fixedEdges = 0;
@@ -1253,13 +1345,14 @@ LIBTESS_INLINE void Sweep::DoneEdgeDict()
         DeleteRegion(reg);
         /* DeleteEdge( reg->eUp );*/
     }
-    dict.dispose();
+    dict.clear();
 }
 
 /*
  * Remove zero-length edges, and contours with fewer than 3 vertices.
  */
-LIBTESS_INLINE void Sweep::RemoveDegenerateEdges(Mesh& mesh)
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::RemoveDegenerateEdges(Mesh& mesh)
 {
     HalfEdge *e, *eNext, *eLnext;
     HalfEdge *eHead = &mesh.m_edgeHead;
@@ -1294,7 +1387,8 @@ LIBTESS_INLINE void Sweep::RemoveDegenerateEdges(Mesh& mesh)
  * Insert all vertices into the priority queue which determines the
  * order in which vertices cross the sweep line.
  */
-LIBTESS_INLINE int Sweep::InitPriorityQ(Mesh& mesh)
+template<typename Config>
+LIBTESS_INLINE int BasicSweep<Config>::InitPriorityQ(Mesh& mesh)
 {
     #if 0
     PriorityQ *pq;
@@ -1327,10 +1421,16 @@ LIBTESS_INLINE int Sweep::InitPriorityQ(Mesh& mesh)
     #endif
 
     #ifdef LIBTESS_USE_PriorityQ
-    pq.init(0, (PQ_Comp) VertexLessEqual);
     Vertex* vHead = &mesh.m_vtxHead;
-    for (Vertex* v = vHead->next; v != vHead; v = v->next) {
-        v->pqHandle = pq.insert(v);
+    Vertex* v;
+    size_t vertexCount = 0;
+    for (v = vHead->next; v != vHead; v = v->next) {
+        ++vertexCount;
+    }
+
+    pq.init(vertexCount);
+    for (v = vHead->next; v != vHead; v = v->next) {
+        pq.insert(v);
     }
     pq.sort();
 
@@ -1347,7 +1447,8 @@ LIBTESS_INLINE int Sweep::InitPriorityQ(Mesh& mesh)
 
 /* 
  */
-LIBTESS_INLINE void Sweep::DonePriorityQ()
+template<typename Config>
+LIBTESS_INLINE void BasicSweep<Config>::DonePriorityQ()
 {
     pq.clear();
 }
@@ -1366,7 +1467,8 @@ LIBTESS_INLINE void Sweep::DonePriorityQ()
  * edge at the time, since one of the routines further up the stack
  * will sometimes be keeping a pointer to that edge.
  */
-LIBTESS_INLINE bool Sweep::RemoveDegenerateFaces(Mesh& mesh)
+template<typename Config>
+LIBTESS_INLINE bool BasicSweep<Config>::RemoveDegenerateFaces(Mesh& mesh)
 {
     Face *f, *fNext;
     HalfEdge *e;
@@ -1386,6 +1488,27 @@ LIBTESS_INLINE bool Sweep::RemoveDegenerateFaces(Mesh& mesh)
     return true;
 }
 
+/* Processes the events of the priority queue in order.
+ */
+template<typename Config>
+template<int Rule>
+LIBTESS_INLINE void BasicSweep<Config>::SweepEvents(Mesh& mesh)
+{
+    Vertex *v, *vNext;
+
+    v = pq.pop();
+    while (v) {
+        vNext = pq.top();
+        while (vNext && VertexEqual(vNext, v)) {
+            vNext = pq.pop();
+            LIBTESS_LONGJMP(!mesh.Splice(v->edge, vNext->edge));
+            vNext = pq.top();
+        }
+        SweepEvent<Rule>(mesh, v);
+        v = pq.pop();
+    };
+}
+
 /*
  * __gl_computeInterior( tess ) computes the planar arrangement specified
  * by the given contours, and further subdivides this arrangement
@@ -1393,9 +1516,20 @@ LIBTESS_INLINE bool Sweep::RemoveDegenerateFaces(Mesh& mesh)
  * to the polygon, according to the rule given by tess->windingRule.
  * Each interior region is guaranteed be monotone.
  */
-LIBTESS_INLINE int Sweep::ComputeInterior(Mesh& mesh, const AABB& aabb)
+template<typename Config>
+LIBTESS_INLINE int BasicSweep<Config>::ComputeInterior(Mesh& mesh, const AABB& aabb)
 {
-    Vertex *v, *vNext;
+    switch (windingRule) {
+    case TESS_WINDING_ODD:
+    case TESS_WINDING_NONZERO:
+    case TESS_WINDING_POSITIVE:
+    case TESS_WINDING_NEGATIVE:
+    case TESS_WINDING_ABS_GEQ_TWO:
+        break;
+    default:
+        LIBTESS_LOG("Sweep.ComputeInterior() : invalid winding rule.");
+        return LIBTESS_ERROR;
+    }
 
     /* Each vertex defines an event for our sweep line.  Start by inserting
      * all the vertices in a priority queue.  Events are processed in
@@ -1419,6 +1553,8 @@ LIBTESS_INLINE int Sweep::ComputeInterior(Mesh& mesh, const AABB& aabb)
     //int t = std::clock();
 
     #if 0
+    Vertex *v, *vNext;
+
     //while( (v = (Vertex *)pqExtractMin( tess->pq )) != NULL ) {
 
     while ((v = pq.pop()) != NULL) {
@@ -1456,17 +1592,24 @@ LIBTESS_INLINE int Sweep::ComputeInterior(Mesh& mesh, const AABB& aabb)
     }
     #endif
 
-    v = pq.pop();
-    while (v) {
-        vNext = pq.top();
-        while (vNext && VertexEqual(vNext, v)) {
-            vNext = pq.pop();
-            LIBTESS_LONGJMP(!mesh.Splice(v->edge, vNext->edge));
-            vNext = pq.top();
-        }
-        SweepEvent(mesh, v);
-        v = pq.pop();
-    };
+    /* the rule is chosen once, the event loop runs on its instantiation */
+    switch (windingRule) {
+    case TESS_WINDING_ODD:
+        SweepEvents<TESS_WINDING_ODD>(mesh);
+        break;
+    case TESS_WINDING_NONZERO:
+        SweepEvents<TESS_WINDING_NONZERO>(mesh);
+        break;
+    case TESS_WINDING_POSITIVE:
+        SweepEvents<TESS_WINDING_POSITIVE>(mesh);
+        break;
+    case TESS_WINDING_NEGATIVE:
+        SweepEvents<TESS_WINDING_NEGATIVE>(mesh);
+        break;
+    case TESS_WINDING_ABS_GEQ_TWO:
+        SweepEvents<TESS_WINDING_ABS_GEQ_TWO>(mesh);
+        break;
+    }
 
     //LIBTESS_LOG("sort time : %i", std::clock() - t);
 
@@ -0,0 +1,275 @@
+/*
+ * Post-transform vertex cache optimization of a triangle list.
+ *
+ * The algorithm is Tipsify (P. Sander, D. Nehab, J. Barczak, "Fast
+ * Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007):
+ * it fans around one vertex at a time and picks the next fanning vertex
+ * among the ones just emitted, by the time they have left in the cache.
+ * It runs in linear time.
+ */
+
+#ifndef LIBTESS_TIPSIFY_HPP
+#define LIBTESS_TIPSIFY_HPP
+
+#include "public.h"
+
+namespace libtess {
+
+template<typename Config>
+class BasicTipsify
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+private:
+    std::vector<Index, allocator<Index> > offsets;   /* triangles of vertex v are adjacency[offsets[v], offsets[v + 1]) */
+    std::vector<Index, allocator<Index> > adjacency;
+    std::vector<Index, allocator<Index> > live;      /* triangles of each vertex not emitted yet */
+    std::vector<Index, allocator<Index> > stamps;    /* time each vertex entered the cache */
+    std::vector<Index, allocator<Index> > deadEnd;   /* emitted vertices, most recent last */
+    std::vector<Index, allocator<Index> > candidates;/* vertices of the last fan */
+    std::vector<Index, allocator<Index> > output;
+    std::vector<Index, allocator<Index> > order;     /* old number of each new vertex */
+    std::vector<unsigned char, allocator<unsigned char> > emitted;
+
+public:
+    explicit BasicTipsify(Allocator* a = NULL) :
+        offsets(allocator<Index>(a)), adjacency(allocator<Index>(a)), live(allocator<Index>(a)),
+        stamps(allocator<Index>(a)), deadEnd(allocator<Index>(a)), candidates(allocator<Index>(a)),
+        output(allocator<Index>(a)), order(allocator<Index>(a)), emitted(allocator<unsigned char>(a))
+    {
+    }
+
+    /* Orders the triangleCount triangles of elements for a vertex cache of
+     * cacheSize vertices into result(). The triangles keep their
+     * orientation.
+     */
+    void optimize(const Index* elements, size_t triangleCount, size_t vertexCount, int cacheSize);
+
+    const Index* result()const
+    {
+        return output.empty() ? NULL : &output[0];
+    }
+
+    /* Writes result() to elements with the vertices renumbered in the
+     * order of first use.
+     */
+    void renumber(Index* elements, size_t vertexCount);
+
+    /* Moves data[old] to data[new] for each vertex renumbered by the last
+     * renumber().
+     */
+    template<typename T>
+    void permute(T* data);
+
+    /* Average cache miss ratio: vertices loaded into a FIFO cache of
+     * cacheSize vertices per triangle.
+     */
+    double acmr(const Index* elements, size_t triangleCount, size_t vertexCount, int cacheSize);
+
+    void clear()
+    {
+        offsets.clear();
+        adjacency.clear();
+        live.clear();
+        stamps.clear();
+        deadEnd.clear();
+        candidates.clear();
+        output.clear();
+        order.clear();
+        emitted.clear();
+    }
+
+    void dispose()
+    {
+        std::vector<Index, allocator<Index> >(offsets.get_allocator()).swap(offsets);
+        std::vector<Index, allocator<Index> >(adjacency.get_allocator()).swap(adjacency);
+        std::vector<Index, allocator<Index> >(live.get_allocator()).swap(live);
+        std::vector<Index, allocator<Index> >(stamps.get_allocator()).swap(stamps);
+        std::vector<Index, allocator<Index> >(deadEnd.get_allocator()).swap(deadEnd);
+        std::vector<Index, allocator<Index> >(candidates.get_allocator()).swap(candidates);
+        std::vector<Index, allocator<Index> >(output.get_allocator()).swap(output);
+        std::vector<Index, allocator<Index> >(order.get_allocator()).swap(order);
+        std::vector<unsigned char, allocator<unsigned char> >(emitted.get_allocator()).swap(emitted);
+    }
+
+private:
+    Index NextVertex(int cacheSize, Index time, size_t vertexCount, size_t& cursor);
+    Index SkipDeadEnd(size_t vertexCount, size_t& cursor);
+};
+
+//
+// source
+//
+
+template<typename Config>
+LIBTESS_INLINE void BasicTipsify<Config>::optimize(const Index* elements, size_t triangleCount, size_t vertexCount, int cacheSize)
+{
+    size_t elementCount = triangleCount * 3;
+    size_t cursor = 1;
+    Index time = Index(cacheSize) + 1;
+    Index f = vertexCount ? 0 : INVALID_INDEX;
+
+    /* vertex to triangle adjacency, counting sort by vertex */
+    offsets.assign(vertexCount + 1, 0);
+    for (size_t i = 0; i < elementCount; ++i) {
+        ++offsets[elements[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    live.assign(offsets.begin(), offsets.end() - 1); /* next free slot */
+    adjacency.resize(elementCount);
+    for (size_t i = 0; i < elementCount; ++i) {
+        adjacency[live[elements[i]]++] = Index(i / 3);
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        live[v] = offsets[v + 1] - offsets[v];
+    }
+
+    stamps.assign(vertexCount, 0);
+    emitted.assign(triangleCount, 0);
+    deadEnd.clear();
+    output.clear();
+
+    while (f != INVALID_INDEX) {
+        candidates.clear();
+        for (Index a = offsets[f]; a < offsets[f + 1]; ++a) {
+            Index t = adjacency[a];
+            if (emitted[t]) {
+                continue;
+            }
+            for (int j = 0; j < 3; ++j) {
+                Index v = elements[t * 3 + j];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - stamps[v] > cacheSize) {
+                    stamps[v] = time++;
+                }
+            }
+            emitted[t] = 1;
+        }
+        f = NextVertex(cacheSize, time, vertexCount, cursor);
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTipsify<Config>::renumber(Index* elements, size_t vertexCount)
+{
+    size_t elementCount = output.size();
+
+    /* unused vertices last */
+    order.clear();
+    stamps.assign(vertexCount, INVALID_INDEX);
+    for (size_t i = 0; i < elementCount; ++i) {
+        Index v = output[i];
+        if (stamps[v] == INVALID_INDEX) {
+            stamps[v] = Index(order.size());
+            order.push_back(v);
+        }
+        elements[i] = stamps[v];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (stamps[v] == INVALID_INDEX) {
+            order.push_back(Index(v));
+        }
+    }
+}
+
+/* The candidate that stays in the cache the longest if all its triangles
+ * are emitted, or one from the dead-end stack if none fits.
+ */
+template<typename Config>
+LIBTESS_INLINE Index BasicTipsify<Config>::NextVertex(int cacheSize, Index time, size_t vertexCount, size_t& cursor)
+{
+    Index best = INVALID_INDEX;
+    Index bestPriority = -1;
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        Index v = candidates[i];
+        if (live[v] > 0) {
+            Index priority = 0;
+            if (time - stamps[v] + 2 * live[v] <= cacheSize) {
+                priority = time - stamps[v];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+    }
+
+    if (best == INVALID_INDEX) {
+        best = SkipDeadEnd(vertexCount, cursor);
+    }
+    return best;
+}
+
+template<typename Config>
+LIBTESS_INLINE Index BasicTipsify<Config>::SkipDeadEnd(size_t vertexCount, size_t& cursor)
+{
+    while (!deadEnd.empty()) {
+        Index v = deadEnd.back();
+        deadEnd.pop_back();
+        if (live[v] > 0) {
+            return v;
+        }
+    }
+    for (; cursor < vertexCount; ++cursor) {
+        if (live[cursor] > 0) {
+            return Index(cursor++);
+        }
+    }
+    return INVALID_INDEX;
+}
+
+template<typename Config>
+template<typename T>
+LIBTESS_INLINE void BasicTipsify<Config>::permute(T* data)
+{
+    /* follow the cycles of the permutation, live marks the moved ones */
+    live.assign(order.size(), 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (live[i] || size_t(order[i]) == i) {
+            continue;
+        }
+        T first = data[i];
+        size_t j = i;
+        for (;;) {
+            size_t k = size_t(order[j]);
+            live[j] = 1;
+            if (k == i) {
+                data[j] = first;
+                break;
+            }
+            data[j] = data[k];
+            j = k;
+        }
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE double BasicTipsify<Config>::acmr(const Index* elements, size_t triangleCount, size_t vertexCount, int cacheSize)
+{
+    Index misses = 0;
+
+    if (triangleCount == 0) {
+        return 0;
+    }
+
+    /* a vertex is in the cache if fewer than cacheSize vertices came in after it */
+    stamps.assign(vertexCount, -cacheSize);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        Index v = elements[i];
+        if (misses - stamps[v] >= cacheSize) {
+            stamps[v] = misses++;
+        }
+    }
+    return double(misses) / double(triangleCount);
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_TIPSIFY_HPP
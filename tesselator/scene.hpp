@@ -0,0 +1,477 @@
+/*
+
+ Re-tessellation of a scene of scattered, independent shapes that are edited
+ one contour at a time, such as the glyphs or icons of a canvas.
+
+ An edit only costs as much as the shapes whose bounds overlap the contour.
+ There is no persistent mesh: one shape with many nested contours is one
+ group, and every edit of it tesselates the whole shape again, about as
+ fast as tesselate() (see bench/scene.cpp).
+
+//
+// Exsample:
+//
+
+libtess::TessScene scene;
+libtess::Index a = scene.add_contour(2, leftShape, sizeof(float) * 2, leftCount);
+libtess::Index b = scene.add_contour(2, rightShape, sizeof(float) * 2, rightCount);
+scene.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES);
+
+// the user drags a vertex of the right shape
+scene.update_contour(b, 2, rightShape, sizeof(float) * 2, rightCount);
+
+// scene.vertices and scene.elements are up to date, only the right shape
+// was tesselated again, the left one only moved if it followed. With
+// TESS_TRIANGLE_STRIPS the elements of every group start with the restart
+// INVALID_INDEX.
+
+*/
+#ifndef LIBTESS_SCENE_HPP
+#define LIBTESS_SCENE_HPP
+
+#include "tesselator.hpp"
+
+namespace libtess {
+
+/* Keeps contours by id together with their tessellation. The contours are
+ * grouped by overlapping x-y bounds as with Tesselator::splitComponents,
+ * and every group owns one range of vertices and of elements. Updating a
+ * contour tesselates again all of the groups that touch the bounds of its
+ * old or new version, and replaces their ranges where the first of them
+ * was. The other ranges keep their contents and only move, which copies
+ * the outputs after them, O(vertices + elements) per update.
+ */
+template<typename Config>
+class BasicTessScene
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
+    typedef typename Tesselator::vertex_type vertex_type;
+
+    // options of every group, see Tesselator
+    bool processCDT;
+    bool reverseContours;
+    TessEngine engine;
+
+    // Number of contours tesselated by the last tesselate() or update_contour().
+    size_t sweptContours;
+
+    // outputs
+    std::vector<vertex_type> vertices;
+    std::vector<Index> elements;   /* indices into vertices */
+
+public:
+    BasicTessScene();
+
+    /* Removes all contours and outputs.
+     */
+    void clear();
+
+    /* Adds a contour and returns its id, the ids count from 0. After the
+     * first tesselate() the contour is tesselated at once, as an update.
+     * Returns INVALID_INDEX if that fails.
+     */
+    Index add_contour(size_t dimension, const void* pointer, size_t stride, size_t count);
+
+    /* Replaces the points of a contour, count 0 removes it and its id
+     * stays unused.
+     */
+    int update_contour(Index id, size_t dimension, const void* pointer, size_t stride, size_t count);
+
+    /* Tesselates all contours, the later updates use the same rule,
+     * element type and polySize, see Tesselator::tesselate().
+     */
+    int tesselate(TessWindingRule windingRule, TessElementType elementType, int polySize = 3);
+
+    size_t contour_count()const { return contours.size(); }
+
+private:
+    struct Contour
+    {
+        std::vector<Coord> points;  /* x, y, z of each point */
+        AABB bounds;                /* x in a, y in b, empty without points */
+        Index next;                 /* next contour of its group */
+    };
+
+    struct Group
+    {
+        Index first;                /* first contour */
+        size_t vertexOffset;
+        size_t vertexCount;
+        size_t elementOffset;
+        size_t elementCount;
+    };
+
+    Tesselator tess;
+    std::vector<Contour> contours;
+    std::vector<Group> groups;      /* in the order of their outputs */
+    std::vector<char> dropped;      /* groups to tesselate again */
+    TessWindingRule windingRule;
+    TessElementType elementType;
+    int polySize;
+    bool built;
+
+    std::vector<Index> work;        /* contours to group and tesselate */
+    std::vector<AABB> workBounds;
+    std::vector<Index> componentOf; /* union-find over work */
+    std::vector<Index> order;
+    std::vector<Group> newGroups;   /* the output of work */
+    std::vector<vertex_type> newVertices;
+    std::vector<Index> newElements;
+
+    BasicTessScene(const BasicTessScene&);
+    BasicTessScene& operator=(const BasicTessScene&);
+
+    static bool Overlap(const AABB& a, const AABB& b);
+
+    Index FindComponent(Index i);
+    int TesselateWork();
+    void ReplaceGroups();
+    void Rebase(std::vector<Index>& list, size_t first, size_t count, size_t vertexFrom, size_t vertexTo, size_t elementFrom, size_t elementTo);
+};
+
+typedef BasicTessScene<DefaultConfig> TessScene;
+
+//
+// source
+//
+
+template<typename Config>
+LIBTESS_INLINE BasicTessScene<Config>::BasicTessScene() :
+    processCDT(false),
+    reverseContours(false),
+    engine(TESS_ENGINE_SWEEP),
+    sweptContours(0),
+    windingRule(TESS_WINDING_ODD),
+    elementType(TESS_TRIANGLES),
+    polySize(3),
+    built(false)
+{
+    tess.retainCapacity = true;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTessScene<Config>::clear()
+{
+    contours.clear();
+    groups.clear();
+    vertices.clear();
+    elements.clear();
+    sweptContours = 0;
+    built = false;
+}
+
+template<typename Config>
+LIBTESS_INLINE Index BasicTessScene<Config>::add_contour(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    Contour contour;
+
+    contour.bounds.amin = contour.bounds.bmin = FLT_MAX;
+    contour.bounds.amax = contour.bounds.bmax = -FLT_MAX;
+    contour.next = INVALID_INDEX;
+    contours.push_back(contour);
+
+    Index id = Index(contours.size() - 1);
+    if (this->update_contour(id, dimension, pointer, stride, count) != LIBTESS_OK) {
+        return INVALID_INDEX;
+    }
+    return id;
+}
+
+template<typename Config>
+LIBTESS_INLINE int BasicTessScene<Config>::update_contour(Index id, size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    if (id < 0 || size_t(id) >= contours.size()) {
+        LIBTESS_LOG("TessScene.update_contour() : invalid contour id.");
+        return LIBTESS_ERROR;
+    }
+
+    Contour& contour = contours[id];
+    const unsigned char *src = (const unsigned char*) pointer;
+    AABB touched = contour.bounds;
+
+    contour.points.resize(count * 3);
+    contour.bounds.amin = contour.bounds.bmin = FLT_MAX;
+    contour.bounds.amax = contour.bounds.bmax = -FLT_MAX;
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        const Coord* coords = (const Coord*) src;
+        Coord* p = &contour.points[i * 3];
+        p[0] = coords[0];
+        p[1] = coords[1];
+        p[2] = dimension > 2 ? coords[2] : 0;
+        contour.bounds.amin = std::min(contour.bounds.amin, Float(coords[0]));
+        contour.bounds.amax = std::max(contour.bounds.amax, Float(coords[0]));
+        contour.bounds.bmin = std::min(contour.bounds.bmin, Float(coords[1]));
+        contour.bounds.bmax = std::max(contour.bounds.bmax, Float(coords[1]));
+    }
+
+    if (!built) {
+        return LIBTESS_OK;
+    }
+
+    touched.amin = std::min(touched.amin, contour.bounds.amin);
+    touched.amax = std::max(touched.amax, contour.bounds.amax);
+    touched.bmin = std::min(touched.bmin, contour.bounds.bmin);
+    touched.bmax = std::max(touched.bmax, contour.bounds.bmax);
+
+    /* The groups with a contour in the touched bounds are tesselated
+     * again. Nothing changed outside of them, so the other groups still
+     * do not overlap each other or the new contour.
+     */
+    bool found = false;
+
+    work.clear();
+    dropped.assign(groups.size(), 0);
+    for (size_t g = 0; g < groups.size(); ++g) {
+        for (Index c = groups[g].first; c != INVALID_INDEX; c = contours[c].next) {
+            if (c == id || Overlap(contours[c].bounds, touched)) {
+                dropped[g] = 1;
+                break;
+            }
+        }
+        if (dropped[g]) {
+            for (Index c = groups[g].first; c != INVALID_INDEX; c = contours[c].next) {
+                work.push_back(c);
+                found = found || c == id;
+            }
+        }
+    }
+    if (!found) {
+        work.push_back(id);
+    }
+
+    int errCode = this->TesselateWork();
+    this->ReplaceGroups();
+    return errCode;
+}
+
+template<typename Config>
+LIBTESS_INLINE int BasicTessScene<Config>::tesselate(TessWindingRule rule, TessElementType type, int size)
+{
+    windingRule = rule;
+    elementType = type;
+    polySize = size;
+    built = true;
+
+    work.clear();
+    for (size_t i = 0; i < contours.size(); ++i) {
+        work.push_back(Index(i));
+    }
+    dropped.assign(groups.size(), 1);
+
+    int errCode = this->TesselateWork();
+    this->ReplaceGroups();
+    return errCode;
+}
+
+template<typename Config>
+LIBTESS_INLINE bool BasicTessScene<Config>::Overlap(const AABB& a, const AABB& b)
+{
+    return a.amin <= b.amax && b.amin <= a.amax && a.bmin <= b.bmax && b.bmin <= a.bmax;
+}
+
+template<typename Config>
+LIBTESS_INLINE Index BasicTessScene<Config>::FindComponent(Index i)
+{
+    Index root = i;
+    while (componentOf[root] != root) {
+        root = componentOf[root];
+    }
+    while (componentOf[i] != root) {
+        Index next = componentOf[i];
+        componentOf[i] = root;
+        i = next;
+    }
+    return root;
+}
+
+/* Groups the contours of work by overlapping bounds with the sort and
+ * sweep of Tesselator::TesselateComponents(), and tesselates every group
+ * into newGroups, newVertices and newElements. The groups come in the
+ * order of their first contour in work.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTessScene<Config>::TesselateWork()
+{
+    int errCode = LIBTESS_OK;
+    Index n = Index(work.size());
+    Index active = 0;
+
+    newGroups.clear();
+    newVertices.clear();
+    newElements.clear();
+    sweptContours = work.size();
+
+    componentOf.resize(n);
+    order.resize(n);
+    for (Index i = 0; i < n; ++i) {
+        componentOf[i] = i;
+        order[i] = i;
+    }
+
+    workBounds.resize(n);
+    for (Index i = 0; i < n; ++i) {
+        workBounds[i] = contours[work[i]].bounds;
+    }
+    BoundsLess<Float> less = { workBounds.empty() ? NULL : &workBounds[0] };
+    std::sort(order.begin(), order.end(), less);
+
+    /* order[0, active) are the contours whose x range contains the left
+     * end of the current one
+     */
+    for (Index i = 0; i < n; ++i) {
+        Index c = order[i];
+        const AABB& b = workBounds[c];
+        if (b.amin > b.amax) {
+            continue;   /* no points */
+        }
+
+        Index kept = 0;
+        for (Index j = 0; j < active; ++j) {
+            Index other = order[j];
+            const AABB& o = workBounds[other];
+            if (o.amax < b.amin) {
+                continue;
+            }
+            order[kept++] = other;
+            if (b.bmin <= o.bmax && o.bmin <= b.bmax) {
+                Index r1 = this->FindComponent(c);
+                Index r2 = this->FindComponent(other);
+                componentOf[std::max(r1, r2)] = std::min(r1, r2);
+            }
+        }
+        order[kept++] = c;
+        active = kept;
+    }
+
+    /* chain the contours of each group behind its root, in work order */
+    for (Index i = 0; i < n; ++i) {
+        contours[work[i]].next = INVALID_INDEX;
+    }
+    for (Index i = n - 1; i >= 0; --i) {
+        Index root = this->FindComponent(i);
+        if (root != i) {
+            contours[work[i]].next = contours[work[root]].next;
+            contours[work[root]].next = work[i];
+        }
+    }
+
+    tess.processCDT = processCDT;
+    tess.reverseContours = reverseContours;
+    tess.engine = engine;
+
+    for (Index i = 0; i < n; ++i) {
+        if (this->FindComponent(i) != i || contours[work[i]].points.empty()) {
+            continue;
+        }
+
+        Group group = { work[i], newVertices.size(), 0, newElements.size(), 0 };
+        tess.init();
+        for (Index c = work[i]; c != INVALID_INDEX; c = contours[c].next) {
+            const std::vector<Coord>& points = contours[c].points;
+            tess.add_contour(3, &points[0], sizeof(Coord) * 3, points.size() / 3);
+        }
+        if (tess.tesselate(windingRule, elementType, polySize) != LIBTESS_OK) {
+            LIBTESS_LOG("TessScene.tesselate() : group error.");
+            errCode = LIBTESS_ERROR;
+        }
+        else {
+            /* the groups move, each one ends the strip before it */
+            if (elementType == TESS_TRIANGLE_STRIPS && !tess.elements.empty()) {
+                newElements.push_back(INVALID_INDEX);
+            }
+            newVertices.insert(newVertices.end(), tess.vertices.begin(), tess.vertices.end());
+            newElements.insert(newElements.end(), tess.elements.begin(), tess.elements.end());
+            group.vertexCount = tess.vertices.size();
+            group.elementCount = newElements.size() - group.elementOffset;
+            this->Rebase(newElements, group.elementOffset, group.elementCount, 0, group.vertexOffset, 0, group.elementOffset);
+        }
+        newGroups.push_back(group);
+    }
+
+    return errCode;
+}
+
+/* Drops the ranges of the dropped groups and puts the new ones where the
+ * first of them was, or at the end. The kept ranges move down over the
+ * holes and up behind the new ranges, with their element indices.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessScene<Config>::ReplaceGroups()
+{
+    size_t v = 0, e = 0, out = 0;
+    size_t vAt = 0, eAt = 0, gAt = 0;
+    bool placed = false;
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        Group group = groups[g];
+        if (dropped[g]) {
+            if (!placed) {
+                vAt = v;
+                eAt = e;
+                gAt = out;
+                placed = true;
+            }
+            continue;
+        }
+        if (group.vertexOffset != v || group.elementOffset != e) {
+            std::copy(vertices.begin() + group.vertexOffset, vertices.begin() + group.vertexOffset + group.vertexCount, vertices.begin() + v);
+            std::copy(elements.begin() + group.elementOffset, elements.begin() + group.elementOffset + group.elementCount, elements.begin() + e);
+            this->Rebase(elements, e, group.elementCount, group.vertexOffset, v, group.elementOffset, e);
+        }
+        group.vertexOffset = v;
+        group.elementOffset = e;
+        v += group.vertexCount;
+        e += group.elementCount;
+        groups[out++] = group;
+    }
+    if (!placed) {
+        vAt = v;
+        eAt = e;
+        gAt = out;
+    }
+    vertices.resize(v);
+    elements.resize(e);
+    groups.resize(out);
+
+    /* the new ranges */
+    size_t vEnd = vAt + newVertices.size();
+    size_t eEnd = eAt + newElements.size();
+    vertices.insert(vertices.begin() + vAt, newVertices.begin(), newVertices.end());
+    elements.insert(elements.begin() + eAt, newElements.begin(), newElements.end());
+    this->Rebase(elements, eAt, newElements.size(), 0, vAt, 0, eAt);
+    this->Rebase(elements, eEnd, elements.size() - eEnd, vAt, vEnd, eAt, eEnd);
+    for (size_t g = gAt; g < groups.size(); ++g) {
+        groups[g].vertexOffset += newVertices.size();
+        groups[g].elementOffset += newElements.size();
+    }
+    for (size_t g = 0; g < newGroups.size(); ++g) {
+        newGroups[g].vertexOffset += vAt;
+        newGroups[g].elementOffset += eAt;
+    }
+    groups.insert(groups.begin() + gAt, newGroups.begin(), newGroups.end());
+}
+
+/* Fixes list[first, + count) after its vertices moved from vertexFrom to
+ * vertexTo and the elements from elementFrom to elementTo. The neighbours
+ * of TESS_CONNECTED_POLYGONS move with the polygons.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTessScene<Config>::Rebase(std::vector<Index>& list, size_t first, size_t count, size_t vertexFrom, size_t vertexTo, size_t elementFrom, size_t elementTo)
+{
+    Index polygonShift = 0;
+
+    if (count == 0) {
+        return;
+    }
+    if (elementType == TESS_CONNECTED_POLYGONS) {
+        size_t stride = size_t(polySize) * 2;
+        polygonShift = Index(elementTo / stride) - Index(elementFrom / stride);
+    }
+    RebaseElements(&list[first], count, elementType, polySize, Index(vertexTo) - Index(vertexFrom), polygonShift);
+}
+
+}// end namespace libtess
+
+#endif// LIBTESS_SCENE_HPP
@@ -78,6 +78,29 @@ draw_elements(GL_TRIANGLES, &tess.vertices[0], &tess.elements[0], tess.elements.
 tess.Tesselate(TESS_WINDING_ODD, TESS_BOUNDARY_CONTOURS);
 draw_elements(GL_LINES, &tess.vertices[0], &tess.elements[0], tess.elements.size());
 
+// writing straight to mapped GPU buffers, see TessSink:
+
+struct MappedSink : libtess::TessSink
+{
+    bool begin(size_t vertexCount, size_t elementCount)
+    {
+        vertexData = map_vertex_buffer(vertexCount * sizeof(Vec2));
+        vertexStride = sizeof(Vec2);
+        elementData = map_index_buffer(elementCount * sizeof(GLushort));
+        indexSize = sizeof(GLushort);
+        return vertexData && elementData;
+    }
+};
+
+MappedSink sink;
+tess.sink = &sink;
+tess.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES);
+
+// other configurations, in the same program:
+
+libtess::BasicTesselator<libtess::TessConfig<double, 3> > tess3d;   // double, Vec3 output
+libtess::BasicTesselator<libtess::TessConfig<float, 2, 64> > small; // float, Vec2 output, 64 objects per pool page
+
 */
 #ifndef LIBTESS_TESSELATOR_HPP
 #define LIBTESS_TESSELATOR_HPP
@@ -86,17 +109,78 @@ draw_elements(GL_LINES, &tess.vertices[0], &tess.elements[0], tess.elements.size
 #include "detail/mesh.hpp"
 #include "detail/mono.hpp"
 #include "detail/sweep.hpp"
+#include "detail/earcut.hpp"
+#include "detail/tipsify.hpp"
+#include "detail/cache.hpp"
 
 namespace libtess {
 
-#ifdef LIBTESS_USE_VEC3
-const int LIBTESS_VERTEX_SIZE = 3;
-#else
-const int LIBTESS_VERTEX_SIZE = 2;
-#endif
+/* Caller memory for the output of tesselate(), see Tesselator::sink.
+ * begin() gets the exact number of vertices and elements before anything
+ * is written, and sets where they go. Vertex i is written as the Float
+ * coordinates x, y (and z if the output is Vec3) at vertexData + i *
+ * vertexStride, element i as an index of indexSize bytes, 2 or 4, at
+ * elementData + i * indexSize.
+ */
+class TessSink
+{
+public:
+    void* vertexData;
+    size_t vertexStride;
+    void* elementData;
+    size_t indexSize;
+
+    TessSink() : vertexData(NULL), vertexStride(0), elementData(NULL), indexSize(sizeof(uint32_t)) {}
+    virtual ~TessSink() {}
+
+    /* Returns false to fail tesselate().
+     */
+    virtual bool begin(size_t vertexCount, size_t elementCount) = 0;
+
+    /* Called after the output of a successful tesselate() is written.
+     */
+    virtual void end() {}
+};
 
-class Tesselator
+/* A part of the output of Tesselator::shortIndices, drawn with
+ * glDrawElementsBaseVertex(mode, elementCount, GL_UNSIGNED_SHORT,
+ * shortElements + firstElement, baseVertex) or the like.
+ */
+struct TessDrawRange
 {
+    Index baseVertex;   /* first vertex, the 16-bit elements are relative to it */
+    Index vertexCount;
+    Index firstElement;
+    Index elementCount;
+};
+
+/* Adds vertexShift to the vertex indices of elements[0, count), for a part
+ * of the output of tesselate() that moves within bigger buffers, and
+ * polygonShift to the neighbours of TESS_CONNECTED_POLYGONS, which are
+ * polygon numbers; elements then starts at a polygon. INVALID_INDEX, the
+ * restart of TESS_TRIANGLE_STRIPS, an unused slot of a polygon or a
+ * missing neighbour, stays as it is.
+ */
+LIBTESS_INLINE void RebaseElements(Index* elements, size_t count, TessElementType elementType, int polySize, Index vertexShift, Index polygonShift)
+{
+    size_t stride = elementType == TESS_CONNECTED_POLYGONS ? size_t(polySize) * 2 : 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (elements[i] != INVALID_INDEX) {
+            elements[i] += stride && i % stride >= size_t(polySize) ? polygonShift : vertexShift;
+        }
+    }
+}
+
+/* The tesselator of a configuration, see TessConfig. Tesselator is the
+ * one of DefaultConfig.
+ */
+template<typename Config>
+class BasicTesselator
+{
+public:
+    LIBTESS_CONFIG_TYPES(Config);
+
 private:
     Mesh  mesh;     /* stores the input contours, and eventually the tessellation itself */
     Sweep sweep;
@@ -108,6 +192,47 @@ private:
 
     Index vertexIndexCounter;
 
+    std::vector<HalfEdge*, allocator<HalfEdge*> > edgeStack; /* work stack of MeshRefineDelaunay() */
+
+    /* Contours kept out of the mesh, for the ear clipping engine or the
+     * convex fast path. contourRings holds begin and end of each contour.
+     */
+    std::vector<Vec3, allocator<Vec3> > contourPoints;
+    std::vector<Index, allocator<Index> > contourRings;
+    std::vector<AABB, allocator<AABB> > contourBounds; /* x-y bounds of each contour, x in a, y in b */
+    int convexOrientation; /* sign of the area of the first contour if it is convex, 0 otherwise */
+    bool sweepContours;    /* the stored contours are for the sweep, see splitComponents */
+
+    std::vector<Index, allocator<Index> > componentOf; /* union-find over the stored contours */
+    std::vector<Index, allocator<Index> > componentOrder;
+
+    Earcut earcut;
+    Tipsify tipsify;
+    std::vector<Index, allocator<Index> > vertexMap; /* contour point to output vertex */
+    std::vector<Index, allocator<Index> > stripElements; /* see RenderStrips() */
+
+    /* Parallel TessellateInterior(): the inside faces, the first slot of
+     * each face, and per slot a preallocated diagonal and face with the
+     * places to link them into the mesh lists.
+     */
+    std::vector<Face*, allocator<Face*> > monoFaces;
+    std::vector<size_t, allocator<size_t> > monoFirst;
+    std::vector<EdgePair*, allocator<EdgePair*> > monoPairs;
+    std::vector<Face*, allocator<Face*> > monoNewFaces;
+    std::vector<HalfEdge*, allocator<HalfEdge*> > monoEdgeNext;
+    std::vector<Face*, allocator<Face*> > monoFaceNext;
+
+    TessSink* outputSink; /* sink written by the Render functions, or NULL for the vectors */
+
+    uint64_t inputHash;   /* hash of the contours added since the last tesselate() */
+    bool inputHashed;     /* all of them were hashed */
+    bool similarFrame;    /* the canonical frame of cacheSimilar is known */
+    double frameOrigin[2];/* first point */
+    double frameAxis[2];  /* to the farthest point, the unit x-axis of the frame */
+    std::vector<Float, allocator<Float> > frameInput; /* the contours in the frame */
+    std::vector<Index, allocator<Index> > rangeMap;   /* see SplitDrawRanges() */
+    std::vector<Index, allocator<Index> > rangeIndices;
+
 public:
     Vec3 normal;          /* user-specified normal (if provided) */
 
@@ -119,18 +244,119 @@ public:
     // default = false
     bool reverseContours; /* AddContour() will treat CCW contours as CW and vice versa */
 
+    // If enabled, init() and tesselate() keep the memory of the mesh, sweep and outputs
+    // for the next polygon, so a steady stream of similar polygons does no heap allocation.
+    // dispose() still releases everything.
+    // default = false
+    bool retainCapacity;
+
+    // Triangulation engine. The sweep is the default, the other engines are opt-in.
+    // TESS_ENGINE_EARCUT only handles polygons without self-intersections: the first
+    // contour is the outline and the others are its holes.
+    // It is used for TESS_TRIANGLES without processCDT, anything else runs the sweep.
+    // Bridging the holes into the outline is quadratic, so past about a hundred holes
+    // ear clipping is slower than the sweep (see bench/earcut.cpp).
+    // The convex fan is also used for TESS_TRIANGLE_STRIPS, as one zigzag strip.
+    // TESS_ENGINE_AUTO looks at the contours in add_contour() and picks the convex fan
+    // for a lone convex contour, ear clipping for a convex outline with up to
+    // LIBTESS_AUTO_EARCUT_HOLES convex holes that are inside it and apart from each other,
+    // and the sweep otherwise.
+    // The fan and ear clipping give a triangulation equivalent to the sweep's, the same
+    // area, winding and orientation, but not the same triangles: the diagonals and the
+    // order of the triangles and of their vertices differ. Only TESS_ENGINE_SWEEP gives
+    // the output of earlier versions.
+    // default = TESS_ENGINE_SWEEP
+    TessEngine engine;
+
+    // If enabled, the contours are grouped by overlapping x-y bounds and each group is
+    // swept on its own, so unrelated shapes do not share the event queue and the edge
+    // dictionary. The output is the same up to the order of the groups.
+    // default = false
+    bool splitComponents;
+
+    // Number of threads that triangulate the monotone regions after the sweep, with
+    // LIBTESS_USE_THREADS and at least LIBTESS_PARALLEL_FACES_MIN regions. The output
+    // does not depend on it.
+    // default = 1
+    int threadCount;
+
+    // If set, tesselate() writes the vertices and elements to the memory of the sink and
+    // leaves vertices, indices and elements empty. The sweep and the convex fan write
+    // there directly, after counting the output; the other engines, the components of
+    // splitComponents and the cache fill the vectors first and copy them once.
+    // default = NULL
+    TessSink* sink;
+
+    // If set, tesselate() takes the result from the cache when the same contours were
+    // tesselated with the same options before, and stores its result otherwise. The
+    // contours are hashed in add_contour() while a cache is set.
+    // default = NULL
+    TessCache* cache;
+
+    // If enabled with a cache, the contours are looked up by their shape up to translation,
+    // rotation and uniform scale. They are moved to a canonical frame, with the first point
+    // at the origin and the farthest point of the first contour at (1, 0), and a result is
+    // taken for contours within 2^-LIBTESS_SIMILAR_BITS of it there. The cache keeps the
+    // result in that frame and transform maps it back, so the vertices of a result taken
+    // are off by up to that tolerance. Not with integer coordinates, see TessConfig.
+    // default = false
+    bool cacheSimilar;
+
+    // If enabled with cacheSimilar, vertices stay in the canonical frame: equal shapes give
+    // the same vertices and elements, and only transform tells the instances apart.
+    // default = false
+    bool instanceOutput;
+
+    // If enabled, tesselate() writes the elements as 16-bit indices to shortElements and
+    // leaves elements empty. With up to LIBTESS_SHORT_RANGE_VERTICES vertices drawRanges
+    // holds a single range, otherwise the primitives are split in several ranges with a
+    // base vertex each, and the vertices shared by two ranges are duplicated in vertices.
+    // Not with a sink, which has its own indexSize.
+    // default = false
+    bool shortIndices;
+
+    // If enabled, tesselate() reorders the triangles of TESS_TRIANGLES for the post-transform
+    // vertex cache (Tipsify, for a cache of LIBTESS_VERTEX_CACHE_SIZE vertices) and renumbers
+    // the vertices in the order of first use, for fetch locality. The triangles and their
+    // orientation do not change. The order is kept if the reordering does not lower the miss
+    // ratio. With a sink the output is copied there afterwards.
+    // default = false
+    bool optimizeVertexCache;
+
+    // The output of the last tesselate() maps to the input plane by
+    //   x' = transform[0] * x + transform[1] * y + transform[2]
+    //   y' = transform[3] * x + transform[4] * y + transform[5]
+    // It is the identity unless instanceOutput was used.
+    Float transform[6];
+
+    // The engine that ran the last tesselate(), one of SWEEP, EARCUT and CONVEX.
+    TessEngine selectedEngine;
+
+    // Average cache miss ratio of the last tesselate() before and after optimizeVertexCache:
+    // vertices loaded per triangle into a FIFO cache of LIBTESS_VERTEX_CACHE_SIZE vertices.
+    // 0 if the triangles were not reordered.
+    double acmrBefore;
+    double acmrAfter;
+
     // outputs
-    #ifdef LIBTESS_USE_VEC3         /* Ķб */
-    std::vector<Vec3> vertices;
-    #else
-    std::vector<Vec2> vertices;
-    #endif
-    std::vector<Index>  indices;    /* б */
-    std::vector<Index>  elements;   /* б */
+    /* Ķб */
+    typedef typename select_type<Config::VERTEX_SIZE == 3, Vec3, Vec2>::type vertex_type;
+    std::vector<vertex_type, allocator<vertex_type> > vertices;
+    std::vector<Index, allocator<Index> > indices;    /* б */
+    std::vector<uint16_t, allocator<uint16_t> > shortElements; /* elements of shortIndices */
+    std::vector<TessDrawRange, allocator<TessDrawRange> > drawRanges;
+    std::vector<Index, allocator<Index> > elements;   /* б */
+
+private:
+    std::vector<vertex_type, allocator<vertex_type> > frameVertices; /* the output in the canonical frame */
+    std::vector<vertex_type, allocator<vertex_type> > rangeVertices; /* the output split by SplitDrawRanges() */
 
 public:
-    Tesselator();
-    ~Tesselator();
+    /* All memory of the tesselator comes from allocator, default_allocator()
+     * if it is NULL. The allocator must outlive the tesselator.
+     */
+    explicit BasicTesselator(Allocator* allocator = NULL);
+    ~BasicTesselator();
 
     /* ʼ
      */
@@ -154,61 +380,219 @@ public:
     int tesselate(TessWindingRule windingRule, TessElementType elementType, int polySize = 3);
 
 private:
+    int TesselateCached(TessWindingRule windingRule, TessElementType elementType, int polySize, TessSink* target);
+    void OptimizeVertexCache();
+    int SplitDrawRanges(size_t primitiveSize);
+    int TesselateContours(TessWindingRule windingRule, TessElementType elementType, int polySize, TessSink* direct);
+    int Deliver(int errCode, TessSink* target);
+    void HashContour(size_t dimension, const void* pointer, size_t stride, size_t count);
+    void HashSimilarContour(size_t dimension, const void* pointer, size_t stride, size_t count);
+    void ToFrame(const vertex_type* src, size_t count, vertex_type* dst);
+    void FromFrame(const vertex_type* src, size_t count, vertex_type* dst);
+    uint64_t CacheKey(TessWindingRule windingRule, TessElementType elementType, int polySize);
+
+    int AddMeshContour(size_t dimension, const void* pointer, size_t stride, size_t count);
+
+    void StoreContour(size_t dimension, const void* pointer, size_t stride, size_t count);
+    int FlushContours();
+    int ContourWinding(size_t ring);
+
+    int ClassifyConvex(size_t dimension, const void* pointer, size_t stride, size_t count);
+    bool KeepContour(size_t dimension, const void* pointer, size_t stride, size_t count);
+    bool PointInOutline(double x, double y);
+    int RenderConvex(TessWindingRule windingRule, TessElementType elementType);
+    int RenderEarcut(TessWindingRule windingRule);
+
+    Index FindComponent(Index contour);
+    int TesselateComponents(TessWindingRule windingRule, TessElementType elementType, int polySize);
+    int SweepMesh(TessWindingRule windingRule, TessElementType elementType, int polySize);
+
     Vec3 ComputeNormal();
     void CheckOrientation();
     void ProjectPolygon();
 
+    void release();
+
+    int TessellateRegions();
+    static void TessellateRegionRange(Face** faces, const size_t* first, size_t count, DetachedConnector<Config> connect, int* status);
+
     void MeshRefineDelaunay(Mesh *mesh);
 
     int RenderTriangles();
     int RenderBoundary();
+    int RenderStrips();
+    HalfEdge* MaximumStrip(HalfEdge* eOrig, size_t& size);
+    void AppendStrip(Index n, size_t& length);
+
+    bool OutputBegin(size_t vertexCount, size_t elementCount, size_t& vertexBase, size_t& elementBase);
+    void WriteVertex(size_t i, Float x, Float y, Float z);
+    void WriteElement(size_t i, Index n);
 
     Index GetNeighbourFace(HalfEdge* edge);
-    int OutputPolymesh(int elementType, int polySize);
+    int OutputPolymesh(TessElementType elementType, int polySize);
+
+    /* the output vertex of a point */
+    static Vec2 OutputVertex(const Vec3& v, Vec2*) { return Vec2(v.x, v.y); }
+    static Vec3 OutputVertex(const Vec3& v, Vec3*) { return v; }
+    static Float OutputZ(const Vec2&) { return 0; }
+    static Float OutputZ(const Vec3& v) { return v.z; }
 };
 
+typedef BasicTesselator<DefaultConfig> Tesselator;
+
 //
 // source
 //
 
-LIBTESS_INLINE Tesselator::Tesselator() : mesh(), sweep()
+template<typename Config>
+LIBTESS_INLINE BasicTesselator<Config>::BasicTesselator(Allocator* a) : mesh(a), sweep(a),
+    edgeStack(allocator<HalfEdge*>(a)),
+    contourPoints(allocator<Vec3>(a)),
+    contourRings(allocator<Index>(a)),
+    contourBounds(allocator<AABB>(a)),
+    convexOrientation(0),
+    sweepContours(false),
+    componentOf(allocator<Index>(a)),
+    componentOrder(allocator<Index>(a)),
+    earcut(a),
+    tipsify(a),
+    vertexMap(allocator<Index>(a)),
+    stripElements(allocator<Index>(a)),
+    monoFaces(allocator<Face*>(a)),
+    monoFirst(allocator<size_t>(a)),
+    monoPairs(allocator<EdgePair*>(a)),
+    monoNewFaces(allocator<Face*>(a)),
+    monoEdgeNext(allocator<HalfEdge*>(a)),
+    monoFaceNext(allocator<Face*>(a)),
+    outputSink(NULL),
+    inputHash(0),
+    inputHashed(true),
+    similarFrame(false),
+    frameInput(allocator<Float>(a)),
+    rangeMap(allocator<Index>(a)),
+    rangeIndices(allocator<Index>(a)),
+    vertices(allocator<vertex_type>(a)),
+    indices(allocator<Index>(a)),
+    shortElements(allocator<uint16_t>(a)),
+    drawRanges(allocator<TessDrawRange>(a)),
+    elements(allocator<Index>(a)),
+    frameVertices(allocator<vertex_type>(a)),
+    rangeVertices(allocator<vertex_type>(a))
 {
     normal = Vec3();
     processCDT = false;
     reverseContours = false;
+    retainCapacity = false;
+    engine = TESS_ENGINE_SWEEP;
+    splitComponents = false;
+    threadCount = 1;
+    sink = NULL;
+    cache = NULL;
+    cacheSimilar = false;
+    instanceOutput = false;
+    shortIndices = false;
+    optimizeVertexCache = false;
+    acmrBefore = acmrAfter = 0;
+    transform[0] = transform[4] = 1;
+    transform[1] = transform[2] = transform[3] = transform[5] = 0;
+    selectedEngine = TESS_ENGINE_SWEEP;
     vertexIndexCounter = 0;
 }
 
-LIBTESS_INLINE Tesselator::~Tesselator()
+template<typename Config>
+LIBTESS_INLINE BasicTesselator<Config>::~BasicTesselator()
 {
 
 }
 
 /* ʼ
  */
-LIBTESS_INLINE int Tesselator::init()
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::init()
 {
-    this->dispose();
-    mesh.init();
+    this->release();
+
+    this->vertices.clear();
+    this->indices.clear();
+    this->elements.clear();
+    shortElements.clear();
+    drawRanges.clear();
+
+    vertexIndexCounter = 0;
     return 0;
 }
 
 /* ͷ
  */
-LIBTESS_INLINE void Tesselator::dispose()
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::dispose()
 {
     mesh.dispose();
     sweep.dispose();
 
-    this->vertices.clear();
-    this->indices.clear();
-    this->elements.clear();
+    std::vector<HalfEdge*, allocator<HalfEdge*> >(edgeStack.get_allocator()).swap(edgeStack);
+    std::vector<Vec3, allocator<Vec3> >(contourPoints.get_allocator()).swap(contourPoints);
+    std::vector<Index, allocator<Index> >(contourRings.get_allocator()).swap(contourRings);
+    std::vector<AABB, allocator<AABB> >(contourBounds.get_allocator()).swap(contourBounds);
+    std::vector<Index, allocator<Index> >(vertexMap.get_allocator()).swap(vertexMap);
+    std::vector<Index, allocator<Index> >(stripElements.get_allocator()).swap(stripElements);
+    std::vector<Index, allocator<Index> >(componentOf.get_allocator()).swap(componentOf);
+    std::vector<Index, allocator<Index> >(componentOrder.get_allocator()).swap(componentOrder);
+    std::vector<Face*, allocator<Face*> >(monoFaces.get_allocator()).swap(monoFaces);
+    std::vector<size_t, allocator<size_t> >(monoFirst.get_allocator()).swap(monoFirst);
+    std::vector<EdgePair*, allocator<EdgePair*> >(monoPairs.get_allocator()).swap(monoPairs);
+    std::vector<Face*, allocator<Face*> >(monoNewFaces.get_allocator()).swap(monoNewFaces);
+    std::vector<HalfEdge*, allocator<HalfEdge*> >(monoEdgeNext.get_allocator()).swap(monoEdgeNext);
+    std::vector<Face*, allocator<Face*> >(monoFaceNext.get_allocator()).swap(monoFaceNext);
+    std::vector<Float, allocator<Float> >(frameInput.get_allocator()).swap(frameInput);
+    std::vector<vertex_type, allocator<vertex_type> >(frameVertices.get_allocator()).swap(frameVertices);
+    std::vector<vertex_type, allocator<vertex_type> >(rangeVertices.get_allocator()).swap(rangeVertices);
+    std::vector<Index, allocator<Index> >(rangeMap.get_allocator()).swap(rangeMap);
+    std::vector<Index, allocator<Index> >(rangeIndices.get_allocator()).swap(rangeIndices);
+    convexOrientation = 0;
+    sweepContours = false;
+    earcut.dispose();
+    tipsify.dispose();
+    std::vector<vertex_type, allocator<vertex_type> >(this->vertices.get_allocator()).swap(this->vertices);
+    std::vector<Index, allocator<Index> >(this->indices.get_allocator()).swap(this->indices);
+    std::vector<Index, allocator<Index> >(this->elements.get_allocator()).swap(this->elements);
+    std::vector<uint16_t, allocator<uint16_t> >(shortElements.get_allocator()).swap(shortElements);
+    std::vector<TessDrawRange, allocator<TessDrawRange> >(drawRanges.get_allocator()).swap(drawRanges);
 
     vertexIndexCounter = 0;
 }
 
+/* Releases the mesh and the sweep state, in retainCapacity mode only
+ * the objects are dropped and the pages are kept.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::release()
+{
+    contourPoints.clear();
+    contourRings.clear();
+    contourBounds.clear();
+    convexOrientation = 0;
+    sweepContours = false;
+    inputHash = 0;
+    inputHashed = true;
+    similarFrame = false;
+    frameInput.clear();
+
+    if (retainCapacity) {
+        mesh.clear();
+        sweep.clear();
+        earcut.clear();
+    }
+    else {
+        mesh.dispose();
+        sweep.dispose();
+        earcut.dispose();
+    }
+}
+
 /* AddContour() - Adds a contour to be tesselated.
- * The type of the vertex coordinates is assumed to be Float.
+ * The type of the vertex coordinates is assumed to be Coord: Float, or
+ * int32_t within +-(COORD_LIMIT - 1) with integer coordinates.
  * Parameters:
  *   tess    - pointer to tesselator object.
  *   size    - number of coordinates per vertex. Must be 2 or 3.
@@ -220,7 +604,101 @@ LIBTESS_INLINE void Tesselator::dispose()
  *
  * һ
  */
-LIBTESS_INLINE int Tesselator::add_contour(size_t dimension, const void* pointer, size_t stride, size_t count)
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::add_contour(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    if (cache) {
+        this->HashContour(dimension, pointer, stride, count);
+    }
+    else {
+        inputHashed = false;
+    }
+
+    #ifndef LIBTESS_COMPUTE_NORMAL
+    if (!Config::INTEGER_COORDS && mesh.empty()) {
+        /* The ear clipping engine does not use the mesh. Otherwise the
+         * contours are kept out of it as long as a faster engine is exact
+         * for them, and go to the mesh as soon as one does not qualify.
+         */
+        if (engine == TESS_ENGINE_EARCUT) {
+            convexOrientation = 0;
+            this->StoreContour(dimension, pointer, stride, count);
+            return LIBTESS_OK;
+        }
+        if (!sweepContours && (engine == TESS_ENGINE_AUTO || engine == TESS_ENGINE_CONVEX)
+            && this->KeepContour(dimension, pointer, stride, count)) {
+            this->StoreContour(dimension, pointer, stride, count);
+            return LIBTESS_OK;
+        }
+        if (splitComponents) {
+            sweepContours = true;
+            convexOrientation = 0;
+            this->StoreContour(dimension, pointer, stride, count);
+            return LIBTESS_OK;
+        }
+    }
+    #endif
+
+    if (!contourRings.empty() && this->FlushContours() != LIBTESS_OK) {
+        return LIBTESS_ERROR;
+    }
+
+    return this->AddMeshContour(dimension, pointer, stride, count);
+}
+
+/* Copies a contour to contourPoints.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::StoreContour(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    const unsigned char *src = (const unsigned char*) pointer;
+    size_t begin = contourPoints.size();
+    AABB bounds;
+
+    bounds.amin = bounds.bmin = FLT_MAX;
+    bounds.amax = bounds.bmax = -FLT_MAX;
+
+    contourPoints.resize(begin + count);
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        const Float* coords = (const Float*) src;
+        contourPoints[begin + i] = Vec3(coords[0], coords[1], dimension > 2 ? coords[2] : 0);
+        bounds.amin = std::min(bounds.amin, coords[0]);
+        bounds.amax = std::max(bounds.amax, coords[0]);
+        bounds.bmin = std::min(bounds.bmin, coords[1]);
+        bounds.bmax = std::max(bounds.bmax, coords[1]);
+    }
+    contourRings.push_back(Index(begin));
+    contourRings.push_back(Index(begin + count));
+    contourBounds.push_back(bounds);
+}
+
+/* Moves the contours of contourPoints into the mesh.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::FlushContours()
+{
+    int errCode = LIBTESS_OK;
+
+    for (size_t i = 0; i < contourRings.size() && errCode == LIBTESS_OK; i += 2) {
+        Index begin = contourRings[i];
+        Index end = contourRings[i + 1];
+        if (begin < end) {
+            errCode = this->AddMeshContour(3, &contourPoints[begin].x, sizeof(Vec3), end - begin);
+        }
+    }
+
+    contourPoints.clear();
+    contourRings.clear();
+    contourBounds.clear();
+    convexOrientation = 0;
+    sweepContours = false;
+    return errCode;
+}
+
+/* Adds a contour to the mesh, see add_contour().
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::AddMeshContour(size_t dimension, const void* pointer, size_t stride, size_t count)
 {
     const unsigned char *src = (const unsigned char*) pointer;
     HalfEdge *e = NULL;
@@ -233,9 +711,14 @@ LIBTESS_INLINE int Tesselator::add_contour(size_t dimension, const void* pointer
     /* 
      */
     for (size_t i = 0; i < count; ++i) {
-        const Float* coords = (const Float*) src;
+        const Coord* coords = (const Coord*) src;
         src += stride;
 
+        if (Config::INTEGER_COORDS && (coords[0] <= -COORD_LIMIT || coords[0] >= COORD_LIMIT || coords[1] <= -COORD_LIMIT || coords[1] >= COORD_LIMIT)) {
+            LIBTESS_LOG("Tesselator.AddContour() : coordinate out of range.");
+            return LIBTESS_ERROR;
+        }
+
         if (e == NULL) {
             /* Make a self-loop (one vertex, one edge). */
             e = mesh.MakeEdge();
@@ -258,12 +741,17 @@ LIBTESS_INLINE int Tesselator::add_contour(size_t dimension, const void* pointer
         }
 
         /* The new vertex is now e->Org. */
-        e->vertex->coords.x = coords[0];
-        e->vertex->coords.y = coords[1];
+        e->vertex->coords.x = Float(coords[0]);
+        e->vertex->coords.y = Float(coords[1]);
         if (dimension > 2)
-            e->vertex->coords.z = coords[2];
+            e->vertex->coords.z = Float(coords[2]);
         else
             e->vertex->coords.z = 0;
+        if (Config::INTEGER_COORDS) {
+            /* projected here, the Float copy may have lost bits */
+            e->vertex->s = coords[1];
+            e->vertex->t = coords[0];
+        }
         /* Store the insertion number so that the vertex can be later recognized. */
         e->vertex->idx = this->vertexIndexCounter++;
 
@@ -279,13 +767,25 @@ LIBTESS_INLINE int Tesselator::add_contour(size_t dimension, const void* pointer
     return LIBTESS_OK;
 }
 
-LIBTESS_INLINE int Tesselator::add_contour(const std::vector<Vec2>& points)
+/* The points are Float, not the int32_t of integer coordinates.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::add_contour(const std::vector<Vec2>& points)
 {
+    if (Config::INTEGER_COORDS) {
+        LIBTESS_LOG("Tesselator.AddContour() : integer coordinates are not Vec2.");
+        return LIBTESS_ERROR;
+    }
     return this->add_contour(2, &points[0], sizeof(Vec2), points.size());
 }
 
-LIBTESS_INLINE int Tesselator::add_contour(const std::vector<Vec3>& points)
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::add_contour(const std::vector<Vec3>& points)
 {
+    if (Config::INTEGER_COORDS) {
+        LIBTESS_LOG("Tesselator.AddContour() : integer coordinates are not Vec3.");
+        return LIBTESS_ERROR;
+    }
     return this->add_contour(3, &points[0], sizeof(Vec3), points.size());
 }
 
@@ -294,20 +794,379 @@ LIBTESS_INLINE int Tesselator::add_contour(const std::vector<Vec3>& points)
  *   tess        - pointer to tesselator object.
  *   windingRule - winding rules used for tesselation, must be one of TessWindingRule.
  *   elementType - defines the tesselation result element type, must be one of TessElementType.
- *   polySize    - defines maximum vertices per polygons if output is polygons.
+ *   polySize    - defines maximum vertices per polygons if output is polygons,
+ *                 at least 3.
  * Returns:
  *   LIBTESS_OK if succeed, LIBTESS_ERROR if failed.
  *
  * ִηָ
  */
-LIBTESS_INLINE int Tesselator::tesselate(TessWindingRule windingRule, TessElementType elementType, int polySize)
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::tesselate(TessWindingRule windingRule, TessElementType elementType, int polySize)
 {
-    int errCode;
+    shortElements.clear();
+    drawRanges.clear();
+    acmrBefore = acmrAfter = 0;
+    if ((elementType == TESS_POLYGONS || elementType == TESS_CONNECTED_POLYGONS) && polySize < 3) {
+        LIBTESS_LOG("Tesselator.Tesselate() : polySize must be at least 3.");
+        return LIBTESS_ERROR;
+    }
+
+    /* the triangles are reordered in the vectors, then go to the sink */
+    bool reorder = optimizeVertexCache && elementType == TESS_TRIANGLES;
+    if (this->TesselateCached(windingRule, elementType, polySize, reorder ? NULL : sink) != LIBTESS_OK) {
+        return LIBTESS_ERROR;
+    }
+    if (reorder) {
+        this->OptimizeVertexCache();
+        if (this->Deliver(LIBTESS_OK, sink) != LIBTESS_OK) {
+            return LIBTESS_ERROR;
+        }
+    }
+    if (shortIndices && !sink) {
+        switch (elementType) {
+        case TESS_BOUNDARY_CONTOURS:
+            return this->SplitDrawRanges(2);
+        case TESS_TRIANGLE_STRIPS:
+            return this->SplitDrawRanges(0);
+        case TESS_POLYGONS:
+            return this->SplitDrawRanges(size_t(polySize));
+        case TESS_CONNECTED_POLYGONS:
+            /* the neighbours are polygon numbers, not vertices */
+            LIBTESS_LOG("Tesselator.Tesselate() : shortIndices does not apply to connected polygons.");
+            return LIBTESS_ERROR;
+        default:
+            return this->SplitDrawRanges(3);
+        }
+    }
+    return LIBTESS_OK;
+}
 
+/* tesselate() through the cache, if there is one, with the output to
+ * target or to the vectors.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::TesselateCached(TessWindingRule windingRule, TessElementType elementType, int polySize, TessSink* target)
+{
+    bool similar = cacheSimilar && similarFrame;
+
+    transform[0] = transform[4] = 1;
+    transform[1] = transform[2] = transform[3] = transform[5] = 0;
+
+    if (!cache || !inputHashed) {
+        return this->TesselateContours(windingRule, elementType, polySize, target);
+    }
+
+    uint64_t key = this->CacheKey(windingRule, elementType, polySize);
+    if (similar && instanceOutput) {
+        transform[0] = transform[4] = Float(frameAxis[0]);
+        transform[1] = Float(-frameAxis[1]);
+        transform[3] = Float(frameAxis[1]);
+        transform[2] = Float(frameOrigin[0]);
+        transform[5] = Float(frameOrigin[1]);
+    }
+
+    const Float* shape = similar && !frameInput.empty() ? &frameInput[0] : NULL;
+    size_t shapeSize = similar ? frameInput.size() : 0;
+    Float tolerance = Float(1.0 / double(int64_t(1) << LIBTESS_SIMILAR_BITS));
+    const typename TessCache::Entry* entry = cache->find(key, shape, shapeSize, tolerance);
+    if (entry) {
+        if (similar && !instanceOutput) {
+            this->vertices.resize(entry->vertices.size());
+            this->FromFrame(entry->vertices.empty() ? NULL : &entry->vertices[0], entry->vertices.size(),
+                this->vertices.empty() ? NULL : &this->vertices[0]);
+        }
+        else {
+            this->vertices.assign(entry->vertices.begin(), entry->vertices.end());
+        }
+        this->indices.assign(entry->indices.begin(), entry->indices.end());
+        this->elements.assign(entry->elements.begin(), entry->elements.end());
+        selectedEngine = entry->engine;
+        this->release();
+        return this->Deliver(LIBTESS_OK, target);
+    }
+
+    if (!similar) {
+        if (this->TesselateContours(windingRule, elementType, polySize, NULL) != LIBTESS_OK) {
+            return LIBTESS_ERROR;
+        }
+        cache->insert(key, this->vertices, this->indices, this->elements, selectedEngine);
+        return this->Deliver(LIBTESS_OK, target);
+    }
+
+    /* release() forgets the frame */
+    double origin[2] = { frameOrigin[0], frameOrigin[1] };
+    double axis[2] = { frameAxis[0], frameAxis[1] };
+    std::vector<Float, allocator<Float> > input(frameInput.get_allocator());
+    input.swap(frameInput);
+    if (this->TesselateContours(windingRule, elementType, polySize, NULL) != LIBTESS_OK) {
+        return LIBTESS_ERROR;
+    }
+    frameOrigin[0] = origin[0];
+    frameOrigin[1] = origin[1];
+    frameAxis[0] = axis[0];
+    frameAxis[1] = axis[1];
+
+    frameVertices.resize(this->vertices.size());
+    this->ToFrame(this->vertices.empty() ? NULL : &this->vertices[0], this->vertices.size(),
+        frameVertices.empty() ? NULL : &frameVertices[0]);
+    cache->insert(key, frameVertices, this->indices, this->elements, selectedEngine, input.empty() ? NULL : &input[0], input.size());
+    input.swap(frameInput);
+    if (instanceOutput) {
+        this->vertices.swap(frameVertices);
+    }
+    return this->Deliver(LIBTESS_OK, target);
+}
+
+/* Moves output vertices into the canonical frame of cacheSimilar.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::ToFrame(const vertex_type* src, size_t count, vertex_type* dst)
+{
+    double len2 = frameAxis[0] * frameAxis[0] + frameAxis[1] * frameAxis[1];
+    double ax = frameAxis[0] / len2;
+    double ay = frameAxis[1] / len2;
+
+    for (size_t i = 0; i < count; ++i) {
+        double ex = double(src[i].x) - frameOrigin[0];
+        double ey = double(src[i].y) - frameOrigin[1];
+        dst[i] = src[i];
+        dst[i].x = Float(ex * ax + ey * ay);
+        dst[i].y = Float(ey * ax - ex * ay);
+    }
+}
+
+/* Moves vertices of the canonical frame back to the input plane.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::FromFrame(const vertex_type* src, size_t count, vertex_type* dst)
+{
+    for (size_t i = 0; i < count; ++i) {
+        double cx = src[i].x;
+        double cy = src[i].y;
+        dst[i] = src[i];
+        dst[i].x = Float(frameOrigin[0] + cx * frameAxis[0] - cy * frameAxis[1]);
+        dst[i].y = Float(frameOrigin[1] + cx * frameAxis[1] + cy * frameAxis[0]);
+    }
+}
+
+/* Hashes the points of a contour into inputHash, as add_contour() reads them.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::HashContour(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    const unsigned char *src = (const unsigned char*) pointer;
+    size_t size = std::min<size_t>(std::max<size_t>(dimension, 2), 3) * sizeof(Coord);
+
+    if (cacheSimilar && !Config::INTEGER_COORDS) {
+        this->HashSimilarContour(dimension, pointer, stride, count);
+        return;
+    }
+
+    inputHash = HashStep(inputHash, uint64_t(count) * 4 + size);
+    if (stride == size) {
+        inputHash = HashBytes(inputHash, src, size * count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        inputHash = HashBytes(inputHash, src, size);
+    }
+}
+
+/* Moves a contour into the canonical frame of cacheSimilar, which the first
+ * point and the point farthest from it of the first contour define, and
+ * hashes it rounded to 1/16. The coarse key still tells most shapes apart
+ * and is rarely split by the rounding errors of moved or scaled input.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::HashSimilarContour(size_t dimension, const void* pointer, size_t stride, size_t count)
+{
+    const unsigned char *src = (const unsigned char*) pointer;
+    size_t size = dimension > 2 ? 3 : 2;
+
+    if (!similarFrame) {
+        const Coord* first = (const Coord*) src;
+        double len2 = 0;
+        for (size_t i = 1; i < count; ++i) {
+            const Coord* p = (const Coord*) (src + i * stride);
+            double dx = double(p[0]) - first[0];
+            double dy = double(p[1]) - first[1];
+            if (dx * dx + dy * dy > len2) {
+                len2 = dx * dx + dy * dy;
+                frameAxis[0] = dx;
+                frameAxis[1] = dy;
+            }
+        }
+        if (len2 == 0) {
+            inputHashed = false;
+            return;
+        }
+        frameOrigin[0] = first[0];
+        frameOrigin[1] = first[1];
+        similarFrame = true;
+    }
+
+    double len2 = frameAxis[0] * frameAxis[0] + frameAxis[1] * frameAxis[1];
+    double ax = frameAxis[0] / len2;
+    double ay = frameAxis[1] / len2;
+
+    inputHash = HashStep(inputHash, uint64_t(count) * 4 + size);
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        const Coord* p = (const Coord*) src;
+        double ex = double(p[0]) - frameOrigin[0];
+        double ey = double(p[1]) - frameOrigin[1];
+        double cx = ex * ax + ey * ay;
+        double cy = ey * ax - ex * ay;
+        double q[3] = { floor(cx * 16 + 0.5), floor(cy * 16 + 0.5), size > 2 ? double(p[2]) : 0 };
+        frameInput.push_back(Float(cx));
+        frameInput.push_back(Float(cy));
+        inputHash = HashBytes(inputHash, q, sizeof(double) * size);
+    }
+}
+
+/* The hash of the contours and of every option that changes the output.
+ */
+template<typename Config>
+LIBTESS_INLINE uint64_t BasicTesselator<Config>::CacheKey(TessWindingRule windingRule, TessElementType elementType, int polySize)
+{
+    uint64_t key = inputHash;
+
+    key = HashStep(key, uint64_t(windingRule) | uint64_t(elementType) << 8 | uint64_t(uint32_t(polySize)) << 16);
+    key = HashStep(key, uint64_t(processCDT) | uint64_t(reverseContours) << 1 | uint64_t(splitComponents) << 2 | uint64_t(cacheSimilar) << 3 | uint64_t(engine) << 8);
+    key = HashBytes(key, &normal, sizeof(normal));
+    return key;
+}
+
+/* tesselate() without the cache. The output goes to the direct sink if
+ * it is not NULL, otherwise to the vectors.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::TesselateContours(TessWindingRule windingRule, TessElementType elementType, int polySize, TessSink* direct)
+{
     this->vertices.clear();
     this->indices.clear();
     this->elements.clear();
 
+    if (!contourRings.empty()) {
+        if (!sweepContours && engine != TESS_ENGINE_SWEEP && elementType == TESS_TRIANGLE_STRIPS && !this->processCDT && convexOrientation && contourRings.size() == 2) {
+            selectedEngine = TESS_ENGINE_CONVEX;
+            outputSink = direct;
+            return this->Deliver(this->RenderConvex(windingRule, elementType), direct);
+        }
+        if (!sweepContours && elementType == TESS_TRIANGLES && !this->processCDT) {
+            if (engine == TESS_ENGINE_EARCUT || contourRings.size() > 2) {
+                selectedEngine = TESS_ENGINE_EARCUT;
+                return this->Deliver(this->RenderEarcut(windingRule), direct);
+            }
+            if (engine != TESS_ENGINE_SWEEP && convexOrientation) {
+                selectedEngine = TESS_ENGINE_CONVEX;
+                outputSink = direct;
+                return this->Deliver(this->RenderConvex(windingRule, elementType), direct);
+            }
+        }
+        if (sweepContours && contourRings.size() > 2) {
+            selectedEngine = TESS_ENGINE_SWEEP;
+            return this->Deliver(this->TesselateComponents(windingRule, elementType, polySize), direct);
+        }
+        if (this->FlushContours() != LIBTESS_OK) {
+            return LIBTESS_ERROR;
+        }
+    }
+
+    selectedEngine = TESS_ENGINE_SWEEP;
+
+    outputSink = direct;
+    if (this->SweepMesh(windingRule, elementType, polySize) != LIBTESS_OK) {
+        return this->Deliver(LIBTESS_ERROR, direct);
+    }
+
+    this->release();
+
+    return this->Deliver(LIBTESS_OK, direct);
+}
+
+/* Ends the output to target, nothing if it is NULL. If the output was not
+ * written there directly, the vectors are copied to it and cleared.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::Deliver(int errCode, TessSink* target)
+{
+    if (outputSink) {
+        outputSink = NULL;
+        if (errCode == LIBTESS_OK) {
+            target->end();
+        }
+        return errCode;
+    }
+    if (errCode != LIBTESS_OK || target == NULL) {
+        return errCode;
+    }
+
+    size_t vertexBase, elementBase;
+    outputSink = target;
+    if (!this->OutputBegin(this->vertices.size(), this->elements.size(), vertexBase, elementBase)) {
+        outputSink = NULL;
+        return LIBTESS_ERROR;
+    }
+    for (size_t i = 0; i < this->vertices.size(); ++i) {
+        const vertex_type& v = this->vertices[i];
+        this->WriteVertex(i, v.x, v.y, OutputZ(v));
+    }
+    for (size_t i = 0; i < this->elements.size(); ++i) {
+        this->WriteElement(i, this->elements[i]);
+    }
+    outputSink = NULL;
+    target->end();
+
+    this->vertices.clear();
+    this->indices.clear();
+    this->elements.clear();
+    return LIBTESS_OK;
+}
+
+/* Reorders the triangles for the vertex cache and renumbers the vertices
+ * to match, see optimizeVertexCache.
+ */
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::OptimizeVertexCache()
+{
+    size_t triangleCount = this->elements.size() / 3;
+
+    if (triangleCount == 0) {
+        return;
+    }
+
+    acmrBefore = tipsify.acmr(&this->elements[0], triangleCount, this->vertices.size(), LIBTESS_VERTEX_CACHE_SIZE);
+    tipsify.optimize(&this->elements[0], triangleCount, this->vertices.size(), LIBTESS_VERTEX_CACHE_SIZE);
+    acmrAfter = tipsify.acmr(tipsify.result(), triangleCount, this->vertices.size(), LIBTESS_VERTEX_CACHE_SIZE);
+
+    /* keep the order if it is as good already */
+    if (acmrAfter < acmrBefore) {
+        tipsify.renumber(&this->elements[0], this->vertices.size());
+        tipsify.permute(&this->vertices[0]);
+        if (this->indices.size() == this->vertices.size()) {
+            tipsify.permute(&this->indices[0]);
+        }
+    }
+    else {
+        acmrAfter = acmrBefore;
+    }
+
+    if (retainCapacity) {
+        tipsify.clear();
+    }
+    else {
+        tipsify.dispose();
+    }
+}
+
+/* Runs the sweep on the mesh and appends the result to the outputs.
+ */
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::SweepMesh(TessWindingRule windingRule, TessElementType elementType, int polySize)
+{
+    int errCode;
+
     if (mesh.empty()) {
         LIBTESS_LOG("Tesselator.Tesselate() : mesh is empty.");
         return LIBTESS_ERROR;
@@ -346,7 +1205,7 @@ LIBTESS_INLINE int Tesselator::tesselate(TessWindingRule windingRule, TessElemen
         LIBTESS_UNIT_TEST(errCode = SetWindingNumber(&this->mesh, 1, TRUE));
     }
     else {
-        LIBTESS_UNIT_TEST(errCode = TessellateInterior(&this->mesh));
+        LIBTESS_UNIT_TEST(errCode = this->TessellateRegions());
         // This process is very time consuming !!!
         if (errCode == LIBTESS_OK && this->processCDT) {
             LIBTESS_UNIT_TEST(MeshRefineDelaunay(&this->mesh));
@@ -367,9 +1226,15 @@ LIBTESS_INLINE int Tesselator::tesselate(TessWindingRule windingRule, TessElemen
     case TESS_BOUNDARY_CONTOURS: /* output contours */
         LIBTESS_UNIT_TEST(errCode = RenderBoundary());
         break;
+    case TESS_TRIANGLE_STRIPS:   /* output triangle strips */
+        LIBTESS_UNIT_TEST(errCode = RenderStrips());
+        break;
+    case TESS_POLYGONS:          /* output polygons */
+    case TESS_CONNECTED_POLYGONS:
+        LIBTESS_UNIT_TEST(errCode = OutputPolymesh(elementType, polySize));
+        break;
     default:
         errCode = LIBTESS_ERROR;
-        // OutputPolymesh( elementType, polySize ) );
         break;
     }
 
@@ -378,28 +1243,28 @@ LIBTESS_INLINE int Tesselator::tesselate(TessWindingRule windingRule, TessElemen
         return LIBTESS_ERROR;
     }
 
-    mesh.dispose();
-    sweep.dispose();
-
     return LIBTESS_OK;
 }
 
 // element == GL_TRIANGLES
-LIBTESS_INLINE int Tesselator::RenderTriangles()
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::RenderTriangles()
 {
     Vertex *v;
     Face *f;
     HalfEdge *edge;
     int faceVerts;
     int maxFaceCount = 0;
-    int maxVertexCount = 0;
+    size_t vertexCount = 0;
+    size_t elementCount = 0;
+    size_t vertexBase, elementBase;
 
     // Mark unused
     for (v = mesh.m_vtxHead.next; v != &mesh.m_vtxHead; v = v->next) {
         v->n = INVALID_INDEX;
     }
 
-    // Create unique IDs for all vertices and faces.
+    // Create unique IDs for all vertices and faces, and count the output.
     for (f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
         f->n = INVALID_INDEX;
         if (!f->inside) continue;
@@ -409,42 +1274,70 @@ LIBTESS_INLINE int Tesselator::RenderTriangles()
         do {
             v = edge->vertex;
             if (v->n == INVALID_INDEX) {
-                v->n = maxVertexCount;
-
-                #ifdef LIBTESS_USE_VEC3
-                this->vertices.push_back(Vec3(v->coords.x, v->coords.y, v->coords.z));
-                #else
-                this->vertices.push_back(Vec2(v->coords.x, v->coords.y));
-                #endif
-
-                // Store vertex index.
-                this->indices.push_back(maxVertexCount);
-
-                maxVertexCount++;
+                v->n = Index(vertexCount++);
             }
-            this->elements.push_back(v->n);
             faceVerts++;
             edge = edge->Lnext;
         } while (edge != f->edge);
 
         assert(faceVerts <= 3);
 
+        elementCount += faceVerts;
         f->n = maxFaceCount;
         ++maxFaceCount;
     }
 
+    if (!this->OutputBegin(vertexCount, elementCount, vertexBase, elementBase)) {
+        return LIBTESS_ERROR;
+    }
+
+    /* after the previous components */
+    for (v = mesh.m_vtxHead.next; v != &mesh.m_vtxHead; v = v->next) {
+        if (v->n != INVALID_INDEX) {
+            v->n += Index(vertexBase);
+            this->WriteVertex(v->n, v->coords.x, v->coords.y, v->coords.z);
+        }
+    }
+
+    for (f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
+        if (!f->inside) continue;
+
+        edge = f->edge;
+        do {
+            this->WriteElement(elementBase++, edge->vertex->n);
+            edge = edge->Lnext;
+        } while (edge != f->edge);
+    }
+
     return LIBTESS_OK;
 }
 
 // element == GL_LINES
-LIBTESS_INLINE int Tesselator::RenderBoundary()
+template<typename Config>
+LIBTESS_INLINE int BasicTesselator<Config>::RenderBoundary()
 {
     HalfEdge *edge;
     Vec3 *v;
-    int first;
-    int last = 0;
+    size_t first, last;
+    size_t vertexCount = 0;
+    size_t e;
     //int face_vertex_count;
 
+    for (Face *f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
+        if (!f->inside) {
+            continue;
+        }
+        edge = f->edge;
+        do {
+            ++vertexCount;
+            edge = edge->Lnext;
+        } while (edge != f->edge);
+    }
+
+    if (!this->OutputBegin(vertexCount, vertexCount * 2, last, e)) {
+        return LIBTESS_ERROR;
+    }
+
     for (Face *f = mesh.m_faceHead.next; f != &mesh.m_faceHead; f = f->next) {
         if (!f->inside) {
             continue;
@@ -453,21 +1346,16 @@ LIBTESS_INLINE int Tesselator::RenderBoundary()
         first = last;
         do {
             v = &edge->vertex->coords;
-            #ifdef LIBTESS_USE_VEC3
-            this->vertices.push_back(Vec3(v->x, v->y, v->z));
-            #else
-            this->vertices.push_back(Vec2(v->x, v->y));
-            #endif
-            indices.push_back(last);
-            elements.push_back(last);
+            this->WriteVertex(last, v->x, v->y, v->z);
+            this->WriteElement(e++, Index(last));
             ++last;
-            elements.push_back(last);
+            this->WriteElement(e++, Index(last));
             //++face_vertex_count;
             edge = edge->Lnext;
         } while (edge != f->edge);
 
         if (first < last) {
-            elements.back() = first;
+            this->WriteElement(e - 1, Index(first));
         }
 
         //LIBTESS_LOG("face vertices : %i\n", face_vertex_count);
@@ -476,9 +1364,77 @@ LIBTESS_INLINE int Tesselator::RenderBoundary()
     return LIBTESS_OK;
 }
 
+/* Makes room for vertexCount vertices and elementCount elements after the
+ * output of the previous components, in the vectors or, with outputSink,
+ * in the memory it gives. Returns the first vertex and element to write.
+ */
+template<typename Config>
+LIBTESS_INLINE bool BasicTesselator<Config>::OutputBegin(size_t vertexCount, size_t elementCount, size_t& vertexBase, size_t& elementBase)
+{
+    if (outputSink) {
+        vertexBase = elementBase = 0;
+        if (outputSink->indexSize == 2 && vertexCount > LIBTESS_SHORT_RANGE_VERTICES) {
+            LIBTESS_LOG("Tesselator.Tesselate() : too many vertices for 16-bit indices.");
+            return false;
+        }
+        if (!outputSink->begin(vertexCount, elementCount)) {
+            return false;
+        }
+        if (outputSink->indexSize != 2 && outputSink->indexSize != 4) {
+            LIBTESS_LOG("Tesselator.Tesselate() : index size must be 2 or 4.");
+            return false;
+        }
+        return (outputSink->vertexData || !vertexCount) && (outputSink->elementData || !elementCount);
+    }
+
+    vertexBase = this->vertices.size();
+    elementBase = this->elements.size();
+    this->vertices.resize(vertexBase + vertexCount);
+    this->indices.resize(vertexBase + vertexCount);
+    this->elements.resize(elementBase + elementCount);
+    for (size_t i = vertexBase; i < vertexBase + vertexCount; ++i) {
+        this->indices[i] = Index(i);
+    }
+    return true;
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::WriteVertex(size_t i, Float x, Float y, Float z)
+{
+    if (outputSink) {
+        Float coords[3] = { x, y, z };
+        memcpy((unsigned char*) outputSink->vertexData + i * outputSink->vertexStride, coords, sizeof(Float) * Config::VERTEX_SIZE);
+    }
+    else {
+        this->vertices[i] = OutputVertex(Vec3(x, y, z), (vertex_type*) NULL);
+    }
+}
+
+template<typename Config>
+LIBTESS_INLINE void BasicTesselator<Config>::WriteElement(size_t i, Index n)
+{
+    if (outputSink == NULL) {
+        this->elements[i] = n;
+    }
+    else if (outputSink->indexSize == 2) {
+        uint16_t value = uint16_t(n);
+        memcpy((unsigned char*) outputSink->elementData + i * 2, &value, 2);
+    }
+    else {
+        uint32_t value = uint32_t(n);
+        memcpy((unsigned char*) outputSink->elementData + i * 4, &value, 4);
+    }
+}
+
 }// end namespace libtess
 
 #include "detail/cdt.inl"
+#include "detail/components.inl"
+#include "detail/convex.inl"
+#include "detail/earcut.inl"
+#include "detail/mono.inl"
 #include "detail/normal.inl"
+#include "detail/ranges.inl"
+#include "detail/strips.inl"
 
 #endif// LIBTESS_TESSELATOR_HPP
@@ -0,0 +1,95 @@
+/*
+
+ Allocator: every allocation of a Tesselator goes through its Allocator,
+ with and without the pools, and none is left after dispose().
+
+*/
+#include "check.hpp"
+
+#include <cstdlib>
+#include <new>
+
+static long globalAllocations = 0;
+
+void* operator new(size_t size)
+{
+    ++globalAllocations;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) throw()
+{
+    free(p);
+}
+
+using namespace test;
+
+class CountingAllocator : public Allocator
+{
+public:
+    long calls;
+    long live;
+
+    CountingAllocator() : calls(0), live(0) {}
+
+    void* allocate(size_t size)
+    {
+        ++calls;
+        live += long(size);
+        return malloc(size);
+    }
+
+    void deallocate(void* p, size_t size)
+    {
+        live -= long(size);
+        free(p);
+    }
+};
+
+template<typename Config>
+static void TestFrames(bool retainCapacity)
+{
+    std::vector<Shape> shapes = TestShapes(3, 12);
+    CountingAllocator heap;
+    BasicTesselator<Config> tess(&heap);
+    long steady = 0;
+
+    tess.retainCapacity = retainCapacity;
+    tess.engine = TESS_ENGINE_SWEEP;
+    tess.processCDT = true;
+    for (int frame = 0; frame < 4; ++frame) {
+        long global = globalAllocations;
+        long calls = heap.calls;
+        tess.init();
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            for (size_t c = 0; c < shapes[i].size(); ++c) {
+                tess.add_contour(2, &shapes[i][c][0], sizeof(Float) * 2, shapes[i][c].size() / 2);
+            }
+        }
+        CHECK(tess.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES) == LIBTESS_OK);
+        CHECK(globalAllocations == global);
+        CHECK(heap.calls > calls || frame > 0);
+        steady = heap.calls - calls;
+    }
+
+    /* the pools keep their pages, one object per allocation does not */
+    if (retainCapacity && Config::USE_POOL) {
+        CHECK(steady == 0);
+    }
+
+    tess.dispose();
+    CHECK(heap.live == 0);
+}
+
+int main()
+{
+    TestFrames<TessConfig<Float, 2> >(false);
+    TestFrames<TessConfig<Float, 2> >(true);
+    TestFrames<TessConfig<Float, 2, 256, false> >(false);
+    TestFrames<TessConfig<Float, 2, 256, false> >(true);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+/*
+
+ TessBatch: every range holds the output of a Tesselator run on its own,
+ moved to the range, and the whole buffers are a valid output too. The
+ buffers do not depend on the number of threads or on earlier batches.
+ The memory of the batch and of its workers comes from its Allocator.
+
+*/
+#include "check.hpp"
+#include "../tesselator/batch.hpp"
+
+#include <atomic>
+#include <cstdlib>
+
+using namespace test;
+
+static const TessWindingRule rules[] = {
+    TESS_WINDING_ODD, TESS_WINDING_NONZERO, TESS_WINDING_POSITIVE, TESS_WINDING_NEGATIVE, TESS_WINDING_ABS_GEQ_TWO
+};
+
+/* Every shape is a job of the element type, with the winding rules in turn.
+ */
+static void TestJobs(TessElementType elementType, int polySize, size_t threadCount)
+{
+    std::vector<Shape> shapes = TestShapes(7, 40);
+    std::vector<TessContour> contours;
+    std::vector<TessJob> jobs;
+    double area2 = 0;
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (size_t c = 0; c < shapes[i].size(); ++c) {
+            TessContour contour = { 2, &shapes[i][c][0], sizeof(Float) * 2, shapes[i][c].size() / 2 };
+            contours.push_back(contour);
+        }
+    }
+    for (size_t i = 0, first = 0; i < shapes.size(); ++i) {
+        TessJob job = { &contours[first], shapes[i].size(), rules[i % 5], elementType, polySize };
+        jobs.push_back(job);
+        first += shapes[i].size();
+        area2 += ShapeArea2(shapes[i], job.windingRule);
+    }
+
+    TessBatch batch(threadCount);
+    CHECK(batch.tesselate(&jobs[0], jobs.size()) == LIBTESS_OK);
+
+    Tesselator tess;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const TessRange& range = batch.ranges[i];
+        tess.init();
+        AddShape(tess, shapes[i]);
+        CHECK(tess.tesselate(jobs[i].windingRule, elementType, polySize) == LIBTESS_OK);
+        CHECK(range.vertexCount == tess.vertices.size());
+
+        size_t skip = elementType == TESS_TRIANGLE_STRIPS && !tess.elements.empty() ? 1 : 0;
+        CHECK(range.elementCount == tess.elements.size() + skip);
+        if (range.elementCount != tess.elements.size() + skip) {
+            continue;
+        }
+        if (skip) {
+            CHECK(batch.elements[range.elementOffset] == INVALID_INDEX);
+        }
+
+        /* the neighbours of connected polygons are polygon numbers */
+        size_t stride = elementType == TESS_CONNECTED_POLYGONS ? size_t(polySize) * 2 : 0;
+        size_t wrong = 0;
+        for (size_t k = 0; k < tess.elements.size(); ++k) {
+            Index n = batch.elements[range.elementOffset + skip + k];
+            Index expected = tess.elements[k];
+            if (expected != INVALID_INDEX) {
+                expected += Index(stride && k % stride >= size_t(polySize) ? range.polygonOffset : range.vertexOffset);
+            }
+            wrong += n != expected;
+        }
+        CHECK(wrong == 0);
+    }
+
+    CHECK(ValidOutput(batch.vertices, batch.elements.empty() ? NULL : &batch.elements[0],
+        batch.elements.size(), elementType, polySize, area2));
+}
+
+/* The same jobs on one worker, on three, and again on the three after a
+ * batch of other jobs, give the same buffers.
+ */
+static void TestDeterminism(TessElementType elementType, int polySize)
+{
+    std::vector<Shape> shapes = TestShapes(17, 60);
+    std::vector<TessContour> contours;
+    std::vector<TessJob> jobs;
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (size_t c = 0; c < shapes[i].size(); ++c) {
+            TessContour contour = { 2, &shapes[i][c][0], sizeof(Float) * 2, shapes[i][c].size() / 2 };
+            contours.push_back(contour);
+        }
+    }
+    for (size_t i = 0, first = 0; i < shapes.size(); ++i) {
+        TessJob job = { &contours[first], shapes[i].size(), rules[i % 5], elementType, polySize };
+        jobs.push_back(job);
+        first += shapes[i].size();
+    }
+
+    TessBatch one(1);
+    TessBatch three(3);
+    CHECK(one.tesselate(&jobs[0], jobs.size()) == LIBTESS_OK);
+    for (int pass = 0; pass < 2; ++pass) {
+        CHECK(three.tesselate(&jobs[0], jobs.size()) == LIBTESS_OK);
+        CHECK(three.elements == one.elements);
+        CHECK(three.vertices.size() == one.vertices.size());
+        size_t differ = 0;
+        for (size_t i = 0; i < one.vertices.size() && i < three.vertices.size(); ++i) {
+            differ += one.vertices[i].x != three.vertices[i].x || one.vertices[i].y != three.vertices[i].y;
+        }
+        CHECK(differ == 0);
+        CHECK(three.tesselate(&jobs[1], jobs.size() / 2) == LIBTESS_OK);
+    }
+}
+
+/* Thread safe, the workers share it.
+ */
+class CountingAllocator : public Allocator
+{
+public:
+    std::atomic<long> calls;
+    std::atomic<long> live;
+
+    CountingAllocator() : calls(0), live(0) {}
+
+    void* allocate(size_t size)
+    {
+        ++calls;
+        live += long(size);
+        return malloc(size);
+    }
+
+    void deallocate(void* p, size_t size)
+    {
+        live -= long(size);
+        free(p);
+    }
+};
+
+static void TestAllocator()
+{
+    std::vector<Shape> shapes = TestShapes(5, 30);
+    std::vector<TessContour> contours;
+    std::vector<TessJob> jobs;
+    CountingAllocator heap;
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (size_t c = 0; c < shapes[i].size(); ++c) {
+            TessContour contour = { 2, &shapes[i][c][0], sizeof(Float) * 2, shapes[i][c].size() / 2 };
+            contours.push_back(contour);
+        }
+    }
+    for (size_t i = 0, first = 0; i < shapes.size(); ++i) {
+        TessJob job = { &contours[first], shapes[i].size(), rules[i % 5], TESS_TRIANGLES, 3 };
+        jobs.push_back(job);
+        first += shapes[i].size();
+    }
+
+    TessBatch plain(3);
+    CHECK(plain.tesselate(&jobs[0], jobs.size()) == LIBTESS_OK);
+    {
+        TessBatch batch(3, &heap);
+        CHECK(batch.tesselate(&jobs[0], jobs.size()) == LIBTESS_OK);
+        CHECK(heap.calls > 0);
+        CHECK(batch.elements.size() == plain.elements.size()
+            && std::equal(batch.elements.begin(), batch.elements.end(), plain.elements.begin()));
+        CHECK(batch.vertices.size() == plain.vertices.size());
+    }
+    CHECK(heap.live == 0);
+}
+
+int main()
+{
+    TestAllocator();
+
+    TestDeterminism(TESS_TRIANGLES, 3);
+    TestDeterminism(TESS_TRIANGLE_STRIPS, 3);
+    TestDeterminism(TESS_CONNECTED_POLYGONS, 4);
+
+    for (size_t threads = 1; threads <= 3; threads += 2) {
+        TestJobs(TESS_TRIANGLES, 3, threads);
+        TestJobs(TESS_TRIANGLE_STRIPS, 3, threads);
+        TestJobs(TESS_POLYGONS, 3, threads);
+        TestJobs(TESS_POLYGONS, 6, threads);
+        TestJobs(TESS_CONNECTED_POLYGONS, 3, threads);
+        TestJobs(TESS_CONNECTED_POLYGONS, 5, threads);
+    }
+    return failures ? 1 : 0;
+}
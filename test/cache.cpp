@@ -0,0 +1,226 @@
+/*
+
+ TessCache: a result taken from the cache is the output tesselate() gives
+ without it, for every element type, and the least recently used results
+ go first when the budget is full. With cacheSimilar a moved, rotated and
+ scaled copy of a shape takes the result of the shape, mapped onto it.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+template<typename V, typename W>
+static bool SameVertices(const V& a, const W& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool SameOutput(const Tesselator& a, const Tesselator& b)
+{
+    return SameVertices(a.vertices, b.vertices) && a.indices == b.indices && a.elements == b.elements &&
+        a.selectedEngine == b.selectedEngine;
+}
+
+static void Run(Tesselator& tess, const Shape& shape, TessWindingRule windingRule, TessElementType elementType, int polySize)
+{
+    tess.init();
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(windingRule, elementType, polySize) == LIBTESS_OK);
+}
+
+/* Every shape twice through the cache, the second time is a hit with
+ * the output of a tesselator without a cache.
+ */
+static void TestHits(TessElementType elementType, int polySize)
+{
+    std::vector<Shape> shapes = TestShapes(31, 24);
+    TessCache cache;
+    Tesselator cached;
+    Tesselator fresh;
+
+    cached.cache = &cache;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            TessWindingRule rule = i & 1 ? TESS_WINDING_NONZERO : TESS_WINDING_ODD;
+            Run(cached, shapes[i], rule, elementType, polySize);
+            Run(fresh, shapes[i], rule, elementType, polySize);
+            CHECK(SameOutput(cached, fresh));
+            CHECK(ValidOutput(cached.vertices, cached.elements.empty() ? NULL : &cached.elements[0],
+                cached.elements.size(), elementType, polySize, ShapeArea2(shapes[i], rule)));
+        }
+        CHECK(cache.hits == pass * shapes.size());
+        CHECK(cache.misses == shapes.size());
+    }
+
+    /* another rule, polySize or option is another result */
+    Run(cached, shapes[0], TESS_WINDING_POSITIVE, elementType, polySize);
+    Run(cached, shapes[0], TESS_WINDING_ODD, elementType, polySize + 1);
+    cached.processCDT = true;
+    Run(cached, shapes[0], TESS_WINDING_ODD, elementType, polySize);
+    CHECK(cache.misses == shapes.size() + 3);
+}
+
+static void TestEviction()
+{
+    Shape shapes[4];
+    TessCache cache;
+    Tesselator tess;
+
+    for (int i = 0; i < 4; ++i) {
+        shapes[i].push_back(StarRing(40 * i, 0, 10, 0.5, 20));
+    }
+
+    /* room for two results of the same size */
+    tess.cache = &cache;
+    Run(tess, shapes[0], TESS_WINDING_ODD, TESS_TRIANGLES, 3);
+    cache.set_budget(cache.bytes() * 5 / 2);
+    CHECK(cache.size() == 1);
+
+    Run(tess, shapes[1], TESS_WINDING_ODD, TESS_TRIANGLES, 3);
+    Run(tess, shapes[0], TESS_WINDING_ODD, TESS_TRIANGLES, 3);    // 0 is the most recent
+    Run(tess, shapes[2], TESS_WINDING_ODD, TESS_TRIANGLES, 3);    // drops 1
+    CHECK(cache.size() == 2);
+    CHECK(cache.bytes() <= cache.budget());
+
+    size_t hits = cache.hits;
+    Run(tess, shapes[0], TESS_WINDING_ODD, TESS_TRIANGLES, 3);
+    Run(tess, shapes[2], TESS_WINDING_ODD, TESS_TRIANGLES, 3);
+    CHECK(cache.hits == hits + 2);
+    Run(tess, shapes[1], TESS_WINDING_ODD, TESS_TRIANGLES, 3);
+    CHECK(cache.hits == hits + 2);
+
+    /* a result bigger than the budget is not kept */
+    cache.set_budget(64);
+    CHECK(cache.size() == 0);
+    Run(tess, shapes[3], TESS_WINDING_ODD, TESS_TRIANGLES, 3);
+    CHECK(cache.size() == 0 && cache.bytes() == 0);
+}
+
+struct Similarity
+{
+    double c, s, tx, ty;   /* x' = c * x - s * y + tx, y' = s * x + c * y + ty */
+
+    Float x(double px, double py)const { return Float(c * px - s * py + tx); }
+    Float y(double px, double py)const { return Float(s * px + c * py + ty); }
+};
+
+static Shape Transformed(const Shape& shape, const Similarity& m)
+{
+    Shape out = shape;
+    for (size_t i = 0; i < out.size(); ++i) {
+        for (size_t k = 0; k < out[i].size(); k += 2) {
+            out[i][k] = m.x(shape[i][k], shape[i][k + 1]);
+            out[i][k + 1] = m.y(shape[i][k], shape[i][k + 1]);
+        }
+    }
+    return out;
+}
+
+/* Every shape, then copies of it under similarities the points take
+ * exactly (quarter turns and powers of two about the origin), which must
+ * be hits, and under others with translations, which usually are. Only
+ * the shape is in the cache, similar shapes of TestShapes() would hit
+ * each other. A hit has the elements of the shape and its vertices mapped
+ * by the similarity, as the output or through transform with
+ * instanceOutput.
+ */
+static void TestSimilar(TessElementType elementType, int polySize, bool instanceOutput)
+{
+    static const Similarity exact[] = { { 0, 1, 0, 0 }, { -2, 0, 0, 0 }, { 0, -0.25, 0, 0 } };
+    static const Similarity other[] = { { 0.8, 0.6, 3.3, 1.7 }, { 1.1, -0.7, -5, 20 } };
+    std::vector<Shape> shapes = TestShapes(37, 12);
+    TessCache cache;
+    Tesselator tess;
+    std::vector<Vertex> vertices;
+    std::vector<Vertex> frame;
+    std::vector<Index> elements;
+    size_t otherHits = 0;
+
+    tess.cache = &cache;
+    tess.cacheSimilar = true;
+    tess.instanceOutput = instanceOutput;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        Run(tess, shapes[i], TESS_WINDING_ODD, elementType, polySize);
+        vertices.assign(tess.vertices.begin(), tess.vertices.end());
+        frame = vertices;
+        elements.assign(tess.elements.begin(), tess.elements.end());
+        double area2 = ShapeArea2(shapes[i], TESS_WINDING_ODD);
+
+        /* the output in the input plane */
+        double size = 0;
+        for (size_t k = 0; k < vertices.size(); ++k) {
+            if (instanceOutput) {
+                Vertex v = vertices[k];
+                vertices[k].x = tess.transform[0] * v.x + tess.transform[1] * v.y + tess.transform[2];
+                vertices[k].y = tess.transform[3] * v.x + tess.transform[4] * v.y + tess.transform[5];
+            }
+            size = std::max(size, std::max(fabs(double(vertices[k].x)), fabs(double(vertices[k].y))));
+        }
+
+        for (int j = 0; j < 5; ++j) {
+            const Similarity& m = j < 3 ? exact[j] : other[j - 3];
+            double scale2 = m.c * m.c + m.s * m.s;
+            cache.clear();
+            Run(tess, shapes[i], TESS_WINDING_ODD, elementType, polySize);
+            size_t hits = cache.hits;
+            Run(tess, Transformed(shapes[i], m), TESS_WINDING_ODD, elementType, polySize);
+            if (j < 3) {
+                CHECK(cache.hits == hits + 1);
+            }
+            if (cache.hits == hits) {
+                continue;
+            }
+            otherHits += j >= 3;
+            CHECK(std::equal(elements.begin(), elements.end(), tess.elements.begin()) && tess.elements.size() == elements.size());
+            CHECK(tess.vertices.size() == vertices.size());
+            if (tess.vertices.size() != vertices.size()) {
+                continue;
+            }
+
+            size_t far = 0;
+            double tolerance = 1e-3 * sqrt(scale2) * (size + 1);
+            for (size_t k = 0; k < vertices.size(); ++k) {
+                Float x = tess.vertices[k].x, y = tess.vertices[k].y;
+                if (instanceOutput) {
+                    x = tess.transform[0] * tess.vertices[k].x + tess.transform[1] * tess.vertices[k].y + tess.transform[2];
+                    y = tess.transform[3] * tess.vertices[k].x + tess.transform[4] * tess.vertices[k].y + tess.transform[5];
+                }
+                far += fabs(x - m.x(vertices[k].x, vertices[k].y)) > tolerance || fabs(y - m.y(vertices[k].x, vertices[k].y)) > tolerance;
+            }
+            CHECK(far == 0);
+            if (instanceOutput) {
+                CHECK(SameVertices(tess.vertices, frame));
+            }
+            else {
+                CHECK(ValidOutput(tess.vertices, tess.elements.empty() ? NULL : &tess.elements[0],
+                    tess.elements.size(), elementType, polySize, area2 * scale2));
+            }
+        }
+    }
+    CHECK(otherHits >= shapes.size());
+}
+
+int main()
+{
+    TestHits(TESS_TRIANGLES, 3);
+    TestHits(TESS_TRIANGLE_STRIPS, 3);
+    TestHits(TESS_POLYGONS, 4);
+    TestHits(TESS_CONNECTED_POLYGONS, 3);
+    TestHits(TESS_CONNECTED_POLYGONS, 6);
+    TestEviction();
+    for (int instance = 0; instance < 2; ++instance) {
+        TestSimilar(TESS_TRIANGLES, 3, instance != 0);
+        TestSimilar(TESS_TRIANGLE_STRIPS, 3, instance != 0);
+        TestSimilar(TESS_CONNECTED_POLYGONS, 5, instance != 0);
+    }
+    return failures ? 1 : 0;
+}
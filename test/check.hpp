@@ -0,0 +1,367 @@
+/*
+
+ Shared helpers of the tests. A test is one program that returns 0 if all
+ of its CHECKs hold, see run.sh.
+
+*/
+#ifndef LIBTESS_TEST_CHECK_HPP
+#define LIBTESS_TEST_CHECK_HPP
+
+#include "../tesselator/tesselator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(x) \
+    do { \
+        if (!(x)) { \
+            ++failures; \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #x); \
+        } \
+    } while (0)
+
+namespace test {
+
+using namespace libtess;
+
+typedef Tesselator::vertex_type Vertex;
+typedef std::vector<Float> Ring;    /* x, y of each point */
+typedef std::vector<Ring> Shape;
+
+struct Triangle
+{
+    Index a, b, c;
+};
+
+/* A small deterministic generator, the same sequence on every platform.
+ */
+struct Random
+{
+    uint32_t state;
+
+    explicit Random(uint32_t seed) : state(seed * 2654435761u + 1) {}
+
+    uint32_t next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    /* in [lo, hi) */
+    double uniform(double lo, double hi)
+    {
+        return lo + (hi - lo) * double(next() & 0xFFFF) / 65536.0;
+    }
+};
+
+/* A star around (cx, cy) with n points, CCW, with the radius alternating
+ * between r and r * inner.
+ */
+inline Ring StarRing(double cx, double cy, double r, double inner, int n)
+{
+    Ring ring;
+    for (int i = 0; i < n; ++i) {
+        double a = 6.283185307179586 * i / n;
+        double s = (i & 1) ? r * inner : r;
+        ring.push_back(Float(cx + s * cos(a)));
+        ring.push_back(Float(cy + s * sin(a)));
+    }
+    return ring;
+}
+
+/* A polygon of n random points in the box, which usually intersects itself.
+ */
+inline Ring RandomRing(Random& random, double x, double y, double size, int n)
+{
+    Ring ring;
+    for (int i = 0; i < n; ++i) {
+        ring.push_back(Float(x + random.uniform(0, size)));
+        ring.push_back(Float(y + random.uniform(0, size)));
+    }
+    return ring;
+}
+
+/* A few shapes of every kind: convex, star with a hole, self-intersecting.
+ */
+inline std::vector<Shape> TestShapes(uint32_t seed, size_t count)
+{
+    Random random(seed);
+    std::vector<Shape> shapes;
+
+    for (size_t i = 0; i < count; ++i) {
+        Shape shape;
+        double x = random.uniform(-100, 100);
+        double y = random.uniform(-100, 100);
+        switch (i % 3) {
+        case 0:
+            shape.push_back(StarRing(x, y, 10, 1, 5 + int(random.next() % 20)));
+            break;
+        case 1:
+            shape.push_back(StarRing(x, y, 20, 0.5, 10 + 2 * int(random.next() % 20)));
+            shape.push_back(StarRing(x, y, 4, 1, 7));
+            break;
+        default:
+            shape.push_back(RandomRing(random, x, y, 30, 4 + int(random.next() % 30)));
+            break;
+        }
+        shapes.push_back(shape);
+    }
+    return shapes;
+}
+
+inline void AddShape(Tesselator& tess, const Shape& shape)
+{
+    for (size_t i = 0; i < shape.size(); ++i) {
+        tess.add_contour(2, &shape[i][0], sizeof(Float) * 2, shape[i].size() / 2);
+    }
+}
+
+/* Twice the signed area of a triangle.
+ */
+template<typename V>
+double Area2(const V* v, const Triangle& t)
+{
+    return (double(v[t.b].x) - v[t.a].x) * (double(v[t.c].y) - v[t.a].y) -
+        (double(v[t.b].y) - v[t.a].y) * (double(v[t.c].x) - v[t.a].x);
+}
+
+inline bool IsVertex(Index n, size_t vertexCount)
+{
+    return n >= 0 && size_t(n) < vertexCount;
+}
+
+/* Decodes the triangles of an output of TESS_TRIANGLES, TESS_TRIANGLE_STRIPS,
+ * TESS_POLYGONS or TESS_CONNECTED_POLYGONS, polygons as fans. Returns false
+ * if an element is not a vertex where one must be, or the layout is wrong.
+ * The neighbours of TESS_CONNECTED_POLYGONS are checked by Neighbours().
+ */
+inline bool Triangles(const Index* elements, size_t count, size_t vertexCount, TessElementType type, int polySize, std::vector<Triangle>& out)
+{
+    out.clear();
+
+    if (type == TESS_TRIANGLES) {
+        if (count % 3) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i += 3) {
+            Triangle t = { elements[i], elements[i + 1], elements[i + 2] };
+            if (!IsVertex(t.a, vertexCount) || !IsVertex(t.b, vertexCount) || !IsVertex(t.c, vertexCount)) {
+                return false;
+            }
+            out.push_back(t);
+        }
+        return true;
+    }
+
+    if (type == TESS_TRIANGLE_STRIPS) {
+        size_t begin = 0;
+        for (size_t i = 0; i <= count; ++i) {
+            if (i < count && elements[i] != INVALID_INDEX) {
+                if (!IsVertex(elements[i], vertexCount)) {
+                    return false;
+                }
+                continue;
+            }
+            /* a strip of one or two vertices is not a restart gone wrong */
+            if (i - begin == 1 || i - begin == 2) {
+                return false;
+            }
+            for (size_t k = begin; k + 2 < i; ++k) {
+                Triangle t = { elements[k], elements[k + 1], elements[k + 2] };
+                if ((k - begin) & 1) {
+                    std::swap(t.a, t.b);
+                }
+                out.push_back(t);
+            }
+            begin = i + 1;
+        }
+        return true;
+    }
+
+    size_t stride = type == TESS_CONNECTED_POLYGONS ? size_t(polySize) * 2 : size_t(polySize);
+    if (polySize < 3 || count % stride) {
+        return false;
+    }
+    for (size_t p = 0; p < count; p += stride) {
+        const Index* poly = elements + p;
+        int n = 0;
+        while (n < polySize && poly[n] != INVALID_INDEX) {
+            if (!IsVertex(poly[n], vertexCount)) {
+                return false;
+            }
+            ++n;
+        }
+        if (n < 3) {
+            return false;
+        }
+        for (int i = n; i < polySize; ++i) {
+            if (poly[i] != INVALID_INDEX) {
+                return false;
+            }
+        }
+        for (int i = 1; i + 1 < n; ++i) {
+            Triangle t = { poly[0], poly[i], poly[i + 1] };
+            out.push_back(t);
+        }
+    }
+    return true;
+}
+
+/* Checks the neighbours of TESS_CONNECTED_POLYGONS: neighbour i of a
+ * polygon is across its edge from vertex i to vertex i + 1, and that
+ * polygon has the same edge the other way with the first one as its
+ * neighbour. The polygons are numbered from elements.
+ */
+inline bool Neighbours(const Index* elements, size_t count, int polySize)
+{
+    size_t stride = size_t(polySize) * 2;
+    Index polygonCount = Index(count / stride);
+
+    for (Index p = 0; p < polygonCount; ++p) {
+        const Index* poly = elements + p * stride;
+        int n = 0;
+        while (n < polySize && poly[n] != INVALID_INDEX) {
+            ++n;
+        }
+        for (int i = 0; i < polySize; ++i) {
+            Index q = poly[polySize + i];
+            if (i >= n || q == INVALID_INDEX) {
+                if (q != INVALID_INDEX) {
+                    return false;
+                }
+                continue;
+            }
+            if (q < 0 || q >= polygonCount || q == p) {
+                return false;
+            }
+            Index a = poly[i];
+            Index b = poly[(i + 1) % n];
+            const Index* other = elements + q * stride;
+            bool found = false;
+            for (int j = 0; j < polySize && other[j] != INVALID_INDEX; ++j) {
+                int k = (j + 1 < polySize && other[j + 1] != INVALID_INDEX) ? j + 1 : 0;
+                if (other[j] == b && other[k] == a) {
+                    found = other[polySize + j] == p;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Twice the area of the triangles, and the number of them that are
+ * oriented against the others beyond rounding.
+ */
+template<typename Vertices>
+double Coverage(const Vertices& vertices, const std::vector<Triangle>& triangles, size_t& flipped)
+{
+    double sum = 0, abs = 0;
+
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        double a = Area2(&vertices[0], triangles[i]);
+        sum += a;
+        abs += fabs(a);
+    }
+    flipped = 0;
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        double a = Area2(&vertices[0], triangles[i]);
+        if ((sum < 0 ? -a : a) < -1e-6 * abs) {
+            ++flipped;
+        }
+    }
+    return fabs(sum);
+}
+
+struct TriangleKey
+{
+    Float v[6];
+
+    bool operator<(const TriangleKey& other)const { return std::lexicographical_compare(v, v + 6, other.v, other.v + 6); }
+    bool operator==(const TriangleKey& other)const { return std::equal(v, v + 6, other.v); }
+};
+
+/* The triangles by the coordinates of their vertices, sorted, each one
+ * rotated to start at its smallest vertex, which keeps the orientation.
+ * Outputs with the same triangles in any order and numbering are equal.
+ */
+template<typename Vertices>
+std::vector<TriangleKey> TriangleKeys(const Vertices& vertices, const std::vector<Triangle>& triangles)
+{
+    std::vector<TriangleKey> keys;
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        Index n[3] = { triangles[i].a, triangles[i].b, triangles[i].c };
+        int first = 0;
+        for (int k = 1; k < 3; ++k) {
+            const Vertex& a = vertices[n[k]];
+            const Vertex& b = vertices[n[first]];
+            if (a.x < b.x || (a.x == b.x && a.y < b.y)) {
+                first = k;
+            }
+        }
+        TriangleKey key;
+        for (int k = 0; k < 3; ++k) {
+            const Vertex& v = vertices[n[(first + k) % 3]];
+            key.v[k * 2] = v.x;
+            key.v[k * 2 + 1] = v.y;
+        }
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+inline bool Near(double a, double b)
+{
+    return fabs(a - b) <= 1e-4 * std::max(1.0, std::max(fabs(a), fabs(b)));
+}
+
+/* Checks an output of one of the triangle types: the layout and indices
+ * are valid, the triangles do not flip, and they cover area2 (twice the
+ * area covered by TESS_TRIANGLES), if it is not negative.
+ */
+template<typename Vertices>
+bool ValidOutput(const Vertices& vertices, const Index* elements, size_t count, TessElementType type, int polySize, double area2)
+{
+    std::vector<Triangle> triangles;
+    size_t flipped;
+
+    if (!Triangles(elements, count, vertices.size(), type, polySize, triangles)) {
+        return false;
+    }
+    if (type == TESS_CONNECTED_POLYGONS && !Neighbours(elements, count, polySize)) {
+        return false;
+    }
+    if (triangles.empty()) {
+        return area2 <= 0;
+    }
+    double covered = Coverage(vertices, triangles, flipped);
+    return flipped == 0 && (area2 < 0 || Near(covered, area2));
+}
+
+/* Twice the area the shape covers under the rule, from TESS_TRIANGLES.
+ */
+inline double ShapeArea2(const Shape& shape, TessWindingRule windingRule)
+{
+    Tesselator tess;
+    std::vector<Triangle> triangles;
+    size_t flipped;
+
+    tess.engine = TESS_ENGINE_SWEEP;
+    AddShape(tess, shape);
+    if (tess.tesselate(windingRule, TESS_TRIANGLES) != LIBTESS_OK || tess.elements.empty()) {
+        return 0;
+    }
+    Triangles(&tess.elements[0], tess.elements.size(), tess.vertices.size(), TESS_TRIANGLES, 3, triangles);
+    return Coverage(tess.vertices, triangles, flipped);
+}
+
+}// end namespace test
+
+#endif// LIBTESS_TEST_CHECK_HPP
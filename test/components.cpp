@@ -0,0 +1,61 @@
+/*
+
+ splitComponents: the groups of contours are swept on their own and merged
+ into one output, which is valid for every element type and covers the
+ same area as one sweep of all the contours.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+static const TessWindingRule rules[] = {
+    TESS_WINDING_ODD, TESS_WINDING_NONZERO, TESS_WINDING_POSITIVE, TESS_WINDING_NEGATIVE, TESS_WINDING_ABS_GEQ_TWO
+};
+
+static void TestSplit(TessElementType elementType, int polySize, bool processCDT)
+{
+    /* scattered shapes, some of them overlapping in x-y bounds */
+    std::vector<Shape> shapes = TestShapes(29, 40);
+    Shape all;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all.insert(all.end(), shapes[i].begin(), shapes[i].end());
+    }
+
+    Tesselator whole;
+    Tesselator split;
+    whole.engine = split.engine = TESS_ENGINE_SWEEP;
+    whole.processCDT = split.processCDT = processCDT;
+    split.splitComponents = true;
+
+    for (int r = 0; r < 5; ++r) {
+        double area2 = ShapeArea2(all, rules[r]);
+
+        whole.init();
+        split.init();
+        AddShape(whole, all);
+        AddShape(split, all);
+        CHECK(whole.tesselate(rules[r], elementType, polySize) == LIBTESS_OK);
+        CHECK(split.tesselate(rules[r], elementType, polySize) == LIBTESS_OK);
+
+        CHECK(ValidOutput(whole.vertices, whole.elements.empty() ? NULL : &whole.elements[0],
+            whole.elements.size(), elementType, polySize, area2));
+        CHECK(ValidOutput(split.vertices, split.elements.empty() ? NULL : &split.elements[0],
+            split.elements.size(), elementType, polySize, area2));
+        CHECK(split.vertices.size() == whole.vertices.size());
+        CHECK(split.indices.size() == split.vertices.size());
+    }
+}
+
+int main()
+{
+    for (int cdt = 0; cdt < 2; ++cdt) {
+        TestSplit(TESS_TRIANGLES, 3, cdt != 0);
+        TestSplit(TESS_TRIANGLE_STRIPS, 3, cdt != 0);
+        TestSplit(TESS_POLYGONS, 3, cdt != 0);
+        TestSplit(TESS_POLYGONS, 7, cdt != 0);
+        TestSplit(TESS_CONNECTED_POLYGONS, 3, cdt != 0);
+        TestSplit(TESS_CONNECTED_POLYGONS, 6, cdt != 0);
+    }
+    return failures ? 1 : 0;
+}
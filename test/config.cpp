@@ -0,0 +1,58 @@
+/*
+
+ TessConfig: tesselators of different coordinate types, dictionaries and
+ predicates live in one program, and each gives a valid output.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+typedef TessConfig<Float, 2> FloatConfig;
+typedef TessConfig<Float, 2, LIBTESS_PAGE_SIZE, true, int32_t> GridConfig;
+typedef TessConfig<double, 2, LIBTESS_PAGE_SIZE, false, double, false, false> ListConfig;
+
+/* Tesselates the shapes, scaled and rounded to the grid, with Config. The
+ * points are Coord, so an integer configuration takes them as int32_t. Its
+ * intersections are rounded to the grid too, which the scale keeps within
+ * the tolerance of the area.
+ */
+template<typename Config>
+static void TestConfig(TessElementType elementType, int polySize)
+{
+    typedef typename Config::Coord Coord;
+
+    std::vector<Shape> shapes = TestShapes(13, 30);
+    BasicTesselator<Config> tess;
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        Shape& shape = shapes[i];
+        tess.init();
+        for (size_t c = 0; c < shape.size(); ++c) {
+            std::vector<Coord> points(shape[c].size());
+            for (size_t k = 0; k < points.size(); ++k) {
+                shape[c][k] = Float(floor(shape[c][k] * 10000 + 0.5));
+                points[k] = Coord(shape[c][k]);
+            }
+            CHECK(tess.add_contour(2, &points[0], sizeof(Coord) * 2, points.size() / 2) == LIBTESS_OK);
+        }
+        CHECK(tess.tesselate(TESS_WINDING_ODD, elementType, polySize) == LIBTESS_OK);
+        CHECK(ValidOutput(tess.vertices, tess.elements.empty() ? NULL : &tess.elements[0],
+            tess.elements.size(), elementType, polySize, ShapeArea2(shape, TESS_WINDING_ODD)));
+    }
+}
+
+int main()
+{
+    TestConfig<FloatConfig>(TESS_TRIANGLES, 3);
+    TestConfig<GridConfig>(TESS_TRIANGLES, 3);
+    TestConfig<ListConfig>(TESS_TRIANGLES, 3);
+    TestConfig<GridConfig>(TESS_CONNECTED_POLYGONS, 4);
+    TestConfig<ListConfig>(TESS_CONNECTED_POLYGONS, 4);
+
+    /* a grid tesselator takes no Float points */
+    BasicTesselator<GridConfig> grid;
+    std::vector<GridConfig::Vec2> points(3);
+    CHECK(grid.add_contour(points) == LIBTESS_ERROR);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+/*
+
+ Tesselator::shortIndices: every draw range stays within its vertex limit
+ and its 16-bit elements, moved by the base vertex, rebuild a valid output
+ of the same area as the 32-bit one. The limit is lowered here so that
+ small inputs split into many ranges.
+
+*/
+#define LIBTESS_SHORT_RANGE_VERTICES 120
+
+#include "check.hpp"
+
+using namespace test;
+
+static void TestRanges(const Shape& shape, TessElementType elementType, int polySize, bool single)
+{
+    Tesselator wide;
+    Tesselator narrow;
+    std::vector<Index> elements;
+
+    narrow.shortIndices = true;
+    AddShape(wide, shape);
+    AddShape(narrow, shape);
+    CHECK(wide.tesselate(TESS_WINDING_NONZERO, elementType, polySize) == LIBTESS_OK);
+    CHECK(narrow.tesselate(TESS_WINDING_NONZERO, elementType, polySize) == LIBTESS_OK);
+    CHECK(narrow.elements.empty());
+    CHECK(narrow.indices.size() == narrow.vertices.size());
+    CHECK(single ? narrow.drawRanges.size() == 1 : narrow.drawRanges.size() > 1);
+
+    Index baseVertex = 0, firstElement = 0;
+    for (size_t r = 0; r < narrow.drawRanges.size(); ++r) {
+        const TessDrawRange& range = narrow.drawRanges[r];
+        CHECK(range.baseVertex == baseVertex && range.firstElement == firstElement);
+        CHECK(range.vertexCount <= LIBTESS_SHORT_RANGE_VERTICES);
+        for (Index i = range.firstElement; i < range.firstElement + range.elementCount; ++i) {
+            uint16_t n = narrow.shortElements[i];
+            CHECK(n == 0xFFFF || n < range.vertexCount);
+            elements.push_back(n == 0xFFFF ? INVALID_INDEX : range.baseVertex + n);
+        }
+        baseVertex += range.vertexCount;
+        firstElement += range.elementCount;
+    }
+    CHECK(size_t(baseVertex) == narrow.vertices.size());
+    CHECK(size_t(firstElement) == narrow.shortElements.size());
+    CHECK(elements.size() == wide.elements.size());
+
+    std::vector<Triangle> triangles;
+    size_t flipped;
+    double area2 = 0;
+    if (!wide.elements.empty() && Triangles(&wide.elements[0], wide.elements.size(), wide.vertices.size(), elementType, polySize, triangles)) {
+        area2 = Coverage(wide.vertices, triangles, flipped);
+    }
+    CHECK(ValidOutput(narrow.vertices, elements.empty() ? NULL : &elements[0], elements.size(), elementType, polySize, area2));
+}
+
+int main()
+{
+    std::vector<Shape> shapes = TestShapes(43, 30);
+    Shape all;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all.insert(all.end(), shapes[i].begin(), shapes[i].end());
+    }
+    Shape small(1, StarRing(0, 0, 10, 0.5, 40));
+
+    TestRanges(small, TESS_TRIANGLES, 3, true);
+    TestRanges(small, TESS_TRIANGLE_STRIPS, 3, true);
+    TestRanges(small, TESS_POLYGONS, 6, true);
+    TestRanges(all, TESS_TRIANGLES, 3, false);
+    TestRanges(all, TESS_TRIANGLE_STRIPS, 3, false);
+    TestRanges(all, TESS_POLYGONS, 3, false);
+    TestRanges(all, TESS_POLYGONS, 8, false);
+
+    /* connected polygons refer to each other across ranges */
+    Tesselator tess;
+    tess.shortIndices = true;
+    AddShape(tess, small);
+    CHECK(tess.tesselate(TESS_WINDING_NONZERO, TESS_CONNECTED_POLYGONS, 3) == LIBTESS_ERROR);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/*
+
+ Ear clipping: for simple polygons with holes the output covers the same
+ area as the sweep under every winding rule, with holes of both
+ orientations and reverseContours, and no triangle flips.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+static const TessWindingRule rules[] = {
+    TESS_WINDING_ODD, TESS_WINDING_NONZERO, TESS_WINDING_POSITIVE, TESS_WINDING_NEGATIVE, TESS_WINDING_ABS_GEQ_TWO
+};
+
+static Ring Reversed(const Ring& ring)
+{
+    Ring out;
+    for (size_t i = ring.size(); i >= 2; i -= 2) {
+        out.push_back(ring[i - 2]);
+        out.push_back(ring[i - 1]);
+    }
+    return out;
+}
+
+/* A star outline with holeCount small convex holes inside it, apart from
+ * each other. Every other hole runs CW if mixed, otherwise all of them do.
+ */
+static Shape HoledStar(Random& random, int holeCount, bool mixed)
+{
+    Shape shape;
+    double x = random.uniform(-100, 100);
+    double y = random.uniform(-100, 100);
+
+    shape.push_back(StarRing(x, y, 20, 0.5, 10 + 2 * int(random.next() % 20)));
+    for (int i = 0; i < holeCount; ++i) {
+        double a = 6.283185307179586 * i / holeCount;
+        Ring hole = i == 0 ? StarRing(x, y, 2, 1, 6) : StarRing(x + 5 * cos(a), y + 5 * sin(a), 1.2, 1, 3 + i % 4);
+        shape.push_back(mixed && (i & 1) ? hole : Reversed(hole));
+    }
+    return shape;
+}
+
+static double Run(Tesselator& tess, const Shape& shape, TessEngine engine, TessWindingRule rule, bool reverse)
+{
+    std::vector<Triangle> triangles;
+    size_t flipped;
+
+    tess.engine = engine;
+    tess.reverseContours = reverse;
+    tess.init();
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(rule, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(Triangles(tess.elements.empty() ? NULL : &tess.elements[0], tess.elements.size(), tess.vertices.size(), TESS_TRIANGLES, 3, triangles));
+    if (triangles.empty()) {
+        return 0;
+    }
+    double area2 = Coverage(tess.vertices, triangles, flipped);
+    CHECK(flipped == 0);
+    return area2;
+}
+
+int main()
+{
+    Random random(3);
+    Tesselator tess;
+
+    for (int shapeIndex = 0; shapeIndex < 40; ++shapeIndex) {
+        Shape shape = HoledStar(random, shapeIndex % 9, shapeIndex % 2 == 1);
+        for (int r = 0; r < 5; ++r) {
+            for (int reverse = 0; reverse < 2; ++reverse) {
+                double sweep = Run(tess, shape, TESS_ENGINE_SWEEP, rules[r], reverse != 0);
+                double earcut = Run(tess, shape, TESS_ENGINE_EARCUT, rules[r], reverse != 0);
+                CHECK(tess.selectedEngine == TESS_ENGINE_EARCUT);
+                CHECK(Near(earcut, sweep));
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
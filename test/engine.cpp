@@ -0,0 +1,88 @@
+/*
+
+ TESS_ENGINE_AUTO: the engine picked for the contours, and an output of
+ the same area as the sweep for every element type. TESS_ENGINE_SWEEP
+ always runs the sweep.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+/* A regular polygon with holeCount small convex holes on a circle inside it.
+ */
+static Shape HoledPolygon(int holeCount)
+{
+    Shape shape;
+    shape.push_back(StarRing(0, 0, 100, 1, 64));
+    for (int i = 0; i < holeCount; ++i) {
+        double a = 6.283185307179586 * i / holeCount;
+        Ring hole = StarRing(60 * cos(a), 60 * sin(a), 1, 1, 5);
+        Ring cw;
+        for (size_t k = hole.size(); k >= 2; k -= 2) {
+            cw.push_back(hole[k - 2]);
+            cw.push_back(hole[k - 1]);
+        }
+        shape.push_back(cw);
+    }
+    return shape;
+}
+
+static void TestPick(const Shape& shape, TessEngine engine, TessEngine expected)
+{
+    Tesselator tess;
+    tess.engine = engine;
+    tess.init();
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(tess.selectedEngine == expected);
+    CHECK(ValidOutput(tess.vertices, tess.elements.empty() ? NULL : &tess.elements[0],
+        tess.elements.size(), TESS_TRIANGLES, 3, ShapeArea2(shape, TESS_WINDING_ODD)));
+}
+
+/* Whatever AUTO picks for the element type, the output is valid.
+ */
+static void TestTypes(const Shape& shape)
+{
+    static const TessElementType types[] = { TESS_TRIANGLES, TESS_TRIANGLE_STRIPS, TESS_POLYGONS, TESS_CONNECTED_POLYGONS };
+    double area2 = ShapeArea2(shape, TESS_WINDING_NONZERO);
+    Tesselator tess;
+    tess.engine = TESS_ENGINE_AUTO;
+
+    for (int i = 0; i < 4; ++i) {
+        tess.init();
+        AddShape(tess, shape);
+        CHECK(tess.tesselate(TESS_WINDING_NONZERO, types[i], 5) == LIBTESS_OK);
+        CHECK(ValidOutput(tess.vertices, tess.elements.empty() ? NULL : &tess.elements[0],
+            tess.elements.size(), types[i], 5, area2));
+    }
+}
+
+int main()
+{
+    Random random(9);
+
+    TestPick(HoledPolygon(0), TESS_ENGINE_AUTO, TESS_ENGINE_CONVEX);
+    TestPick(HoledPolygon(1), TESS_ENGINE_AUTO, TESS_ENGINE_EARCUT);
+    TestPick(HoledPolygon(LIBTESS_AUTO_EARCUT_HOLES), TESS_ENGINE_AUTO, TESS_ENGINE_EARCUT);
+    TestPick(HoledPolygon(LIBTESS_AUTO_EARCUT_HOLES + 1), TESS_ENGINE_AUTO, TESS_ENGINE_SWEEP);
+
+    /* the sweep is not replaced by a faster engine when asked for */
+    TestPick(HoledPolygon(0), TESS_ENGINE_SWEEP, TESS_ENGINE_SWEEP);
+    TestPick(HoledPolygon(1), TESS_ENGINE_SWEEP, TESS_ENGINE_SWEEP);
+    TestPick(HoledPolygon(0), TESS_ENGINE_CONVEX, TESS_ENGINE_CONVEX);
+
+    /* a concave outline, and one crossing itself */
+    Shape star(1, StarRing(0, 0, 10, 0.5, 12));
+    Shape crossing(1, RandomRing(random, 0, 0, 30, 20));
+    TestPick(star, TESS_ENGINE_AUTO, TESS_ENGINE_SWEEP);
+    TestPick(crossing, TESS_ENGINE_AUTO, TESS_ENGINE_SWEEP);
+
+    std::vector<Shape> shapes = TestShapes(13, 30);
+    shapes.push_back(HoledPolygon(0));
+    shapes.push_back(HoledPolygon(3));
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        TestTypes(shapes[i]);
+    }
+    return failures ? 1 : 0;
+}
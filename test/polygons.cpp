@@ -0,0 +1,104 @@
+/*
+
+ TESS_POLYGONS and TESS_CONNECTED_POLYGONS: for polySize 3 to 8 the
+ polygons are convex, padded with INVALID_INDEX, cover the area of the
+ triangles, and their neighbours are consistent. Larger polygons never
+ take more of them.
+
+*/
+#include "check.hpp"
+
+#include <limits>
+
+using namespace test;
+
+template<typename V>
+static double Length(const V& a, const V& b)
+{
+    return sqrt((double(b.x) - a.x) * (double(b.x) - a.x) + (double(b.y) - a.y) * (double(b.y) - a.y));
+}
+
+/* No polygon turns the other way at one of its vertices by more than the
+ * rounding of the computed intersections, a few units in the last place
+ * of the coordinates. Collinear vertices are allowed, the sweep keeps them.
+ */
+template<typename Vertices>
+static bool Convex(const Vertices& vertices, const Index* elements, size_t count, size_t stride, int polySize, double sign)
+{
+    double ulp = 0;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        ulp = std::max(ulp, std::max(fabs(double(vertices[i].x)), fabs(double(vertices[i].y))));
+    }
+    ulp *= std::numeric_limits<Float>::epsilon();
+
+    for (size_t p = 0; p < count; p += stride) {
+        const Index* poly = elements + p;
+        int n = 0;
+        while (n < polySize && poly[n] != INVALID_INDEX) {
+            ++n;
+        }
+        for (int i = 0; i < n; ++i) {
+            Triangle t = { poly[i], poly[(i + 1) % n], poly[(i + 2) % n] };
+            double base = std::max(Length(vertices[t.a], vertices[t.b]), Length(vertices[t.b], vertices[t.c]));
+            if (sign * Area2(&vertices[0], t) < -4 * ulp * base) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void TestPolygons(const Shape& shape, TessWindingRule windingRule, bool processCDT, bool splitComponents)
+{
+    double area2 = ShapeArea2(shape, windingRule);
+    size_t last[2] = { size_t(-1), size_t(-1) };
+    Tesselator tess;
+
+    tess.processCDT = processCDT;
+    tess.splitComponents = splitComponents;
+    for (int polySize = 3; polySize <= 8; ++polySize) {
+        for (int connected = 0; connected < 2; ++connected) {
+            TessElementType elementType = connected ? TESS_CONNECTED_POLYGONS : TESS_POLYGONS;
+            size_t stride = size_t(polySize) * (connected ? 2 : 1);
+
+            tess.init();
+            AddShape(tess, shape);
+            CHECK(tess.tesselate(windingRule, elementType, polySize) == LIBTESS_OK);
+            CHECK(ValidOutput(tess.vertices, tess.elements.empty() ? NULL : &tess.elements[0],
+                tess.elements.size(), elementType, polySize, area2));
+            if (tess.elements.empty()) {
+                continue;
+            }
+
+            /* the orientation of the first triangle is the one of all */
+            Triangle t = { tess.elements[0], tess.elements[1], tess.elements[2] };
+            double sign = Area2(&tess.vertices[0], t) < 0 ? -1 : 1;
+            CHECK(Convex(tess.vertices, &tess.elements[0], tess.elements.size(), stride, polySize, sign));
+
+            size_t polygons = tess.elements.size() / stride;
+            CHECK(polygons <= last[connected]);
+            last[connected] = polygons;
+        }
+    }
+}
+
+int main()
+{
+    static const TessWindingRule rules[] = { TESS_WINDING_ODD, TESS_WINDING_POSITIVE, TESS_WINDING_ABS_GEQ_TWO };
+    std::vector<Shape> shapes = TestShapes(53, 30);
+    Shape all;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all.insert(all.end(), shapes[i].begin(), shapes[i].end());
+    }
+    shapes.push_back(all);
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (int r = 0; r < 3; ++r) {
+            TestPolygons(shapes[i], rules[r], false, false);
+            TestPolygons(shapes[i], rules[r], true, false);
+        }
+    }
+    TestPolygons(all, TESS_WINDING_ODD, false, true);
+    TestPolygons(all, TESS_WINDING_NONZERO, true, true);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+/*
+
+ Orient2d(): the sign agrees with the exact determinant, computed on
+ 128-bit integers, on near-collinear points where the plain double
+ determinant is wrong. The sweep with exact predicates keeps every
+ triangle of a near-degenerate polygon oriented like the polygon.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+typedef TessConfig<double, 2> ExactConfig;
+
+/* The coordinates are multiples of 2^-53 below 32, so they are exact
+ * integers after scaling, and the determinant fits in 128 bits.
+ */
+static int ExactSign(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    const double scale = ldexp(1.0, 53);
+    __int128 x[3] = { int64_t(ax * scale), int64_t(bx * scale), int64_t(cx * scale) };
+    __int128 y[3] = { int64_t(ay * scale), int64_t(by * scale), int64_t(cy * scale) };
+    __int128 det = (x[0] - x[2]) * (y[1] - y[2]) - (y[0] - y[2]) * (x[1] - x[2]);
+    return det > 0 ? 1 : det < 0 ? -1 : 0;
+}
+
+static int Sign(double value)
+{
+    return value > 0 ? 1 : value < 0 ? -1 : 0;
+}
+
+/* a on a 256 x 256 grid of ulps around (0.5, 0.5), b and c on the
+ * diagonal, in every order.
+ */
+static void TestOrient2d(double bx, double by, double cx, double cy)
+{
+    const double u = ldexp(1.0, -53);
+    size_t naiveWrong = 0;
+
+    for (int i = 0; i < 256; ++i) {
+        for (int j = 0; j < 256; ++j) {
+            double p[3][2] = { { 0.5 + i * u, 0.5 + j * u }, { bx, by }, { cx, cy } };
+            for (int k = 0; k < 3; ++k) {
+                const double* a = p[k];
+                const double* b = p[(k + 1) % 3];
+                const double* c = p[(k + 2) % 3];
+                int exact = ExactSign(a[0], a[1], b[0], b[1], c[0], c[1]);
+                CHECK(Sign(Orient2d(a[0], a[1], b[0], b[1], c[0], c[1])) == exact);
+                CHECK(Sign(Orient2d(a[0], a[1], c[0], c[1], b[0], b[1])) == -exact);
+                naiveWrong += Sign((a[0] - c[0]) * (b[1] - c[1]) - (a[1] - c[1]) * (b[0] - c[0])) != exact;
+            }
+        }
+    }
+
+    /* the inputs are hard for plain doubles */
+    CHECK(naiveWrong > 0);
+}
+
+/* A triangle below the diagonal, its top side a chain of points a few
+ * ulps off the diagonal. With the plain double tests the sweep gave a
+ * triangle of the opposite orientation, overlapping the others.
+ */
+static void TestSweep(TessWindingRule windingRule, bool reverse)
+{
+    double points[] = { 0.5, 0.5, 24, 0, 24, 24,
+        ldexp(double(0x12200000000002LL), -48), ldexp(double(0x12200000000004LL), -48),
+        ldexp(double(0x187ffffffffff9LL), -49), ldexp(double(0x187ffffffffff8LL), -49),
+        ldexp(double(0x1980000000000eLL), -50), ldexp(double(0x1980000000000cLL), -50) };
+    const size_t count = 6;
+    BasicTesselator<ExactConfig> tess;
+    double expected = 0, area = 0;
+
+    if (reverse) {
+        for (size_t i = 0; i < count / 2; ++i) {
+            std::swap(points[i * 2], points[(count - 1 - i) * 2]);
+            std::swap(points[i * 2 + 1], points[(count - 1 - i) * 2 + 1]);
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        size_t j = (i + 1) % count;
+        expected += points[i * 2] * points[j * 2 + 1] - points[j * 2] * points[i * 2 + 1];
+    }
+
+    tess.add_contour(2, points, sizeof(double) * 2, count);
+    CHECK(tess.tesselate(windingRule, TESS_TRIANGLES) == LIBTESS_OK);
+    if (tess.elements.empty()) {
+        return;
+    }
+
+    const BasicTesselator<ExactConfig>::vertex_type* v = &tess.vertices[0];
+    for (size_t i = 0; i < tess.elements.size(); i += 3) {
+        const Index* n = &tess.elements[i];
+        area += (v[n[1]].x - v[n[0]].x) * (v[n[2]].y - v[n[0]].y) - (v[n[1]].y - v[n[0]].y) * (v[n[2]].x - v[n[0]].x);
+    }
+    for (size_t i = 0; i < tess.elements.size(); i += 3) {
+        const Index* n = &tess.elements[i];
+        CHECK(Sign(Orient2d(v[n[0]].x, v[n[0]].y, v[n[1]].x, v[n[1]].y, v[n[2]].x, v[n[2]].y)) != -Sign(area));
+    }
+    CHECK(Near(fabs(area), fabs(expected)));
+}
+
+int main()
+{
+    static const TessWindingRule rules[] = {
+        TESS_WINDING_ODD, TESS_WINDING_NONZERO, TESS_WINDING_POSITIVE, TESS_WINDING_NEGATIVE, TESS_WINDING_ABS_GEQ_TWO
+    };
+
+    TestOrient2d(12, 12, 24, 24);
+    TestOrient2d(24, 24, 12, 12);
+    TestOrient2d(0.5, 0.5, 12, 12);
+
+    for (int r = 0; r < 5; ++r) {
+        TestSweep(rules[r], false);
+        TestSweep(rules[r], true);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Builds and runs every test of this directory, with $CXX (g++ by default)
+# and the extra flags in $CXXFLAGS. Returns 1 if one of them fails.
+
+cd "$(dirname "$0")" || exit 1
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}
+status=0
+
+for src in *.cpp; do
+    name=${src%.cpp}
+    if $CXX -std=c++11 -O2 -pthread $CXXFLAGS -o "$OUT/libtess_test_$name" "$src" && "$OUT/libtess_test_$name"; then
+        echo "ok      $name"
+    else
+        echo "FAILED  $name"
+        status=1
+    fi
+done
+
+exit $status
@@ -0,0 +1,125 @@
+/*
+
+ TessScene: after every edit the outputs are a valid tessellation of all
+ the contours, when contours are added after tesselate(), nested in one
+ group, and moved so that groups merge and split again.
+
+*/
+#include "check.hpp"
+#include "../tesselator/scene.hpp"
+
+using namespace test;
+
+static bool ValidScene(const TessScene& scene, const std::vector<Ring>& rings, TessElementType elementType, int polySize)
+{
+    Shape all;
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (!rings[i].empty()) {
+            all.push_back(rings[i]);
+        }
+    }
+    return ValidOutput(scene.vertices, scene.elements.empty() ? NULL : &scene.elements[0],
+        scene.elements.size(), elementType, polySize, ShapeArea2(all, TESS_WINDING_ODD));
+}
+
+/* Moves single points and whole contours, and removes some.
+ */
+static void TestEdits(TessElementType elementType, int polySize)
+{
+    std::vector<Shape> shapes = TestShapes(11, 30);
+    std::vector<Ring> rings;
+    TessScene scene;
+    Random random(5);
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        rings.insert(rings.end(), shapes[i].begin(), shapes[i].end());
+    }
+    for (size_t i = 0; i < rings.size(); ++i) {
+        CHECK(scene.add_contour(2, &rings[i][0], sizeof(Float) * 2, rings[i].size() / 2) == Index(i));
+    }
+    CHECK(scene.tesselate(TESS_WINDING_ODD, elementType, polySize) == LIBTESS_OK);
+    CHECK(ValidScene(scene, rings, elementType, polySize));
+
+    for (int edit = 0; edit < 60; ++edit) {
+        size_t id = random.next() % rings.size();
+        Ring& ring = rings[id];
+        if (ring.empty()) {
+            continue;
+        }
+        if (edit % 10 == 9) {
+            ring.clear();
+        }
+        else if (edit % 3 == 0) {
+            double dx = random.uniform(-20, 20);
+            double dy = random.uniform(-20, 20);
+            for (size_t k = 0; k < ring.size(); k += 2) {
+                ring[k] += Float(dx);
+                ring[k + 1] += Float(dy);
+            }
+        }
+        else {
+            size_t k = random.next() % (ring.size() / 2) * 2;
+            ring[k] += Float(random.uniform(-5, 5));
+            ring[k + 1] += Float(random.uniform(-5, 5));
+        }
+        CHECK(scene.update_contour(Index(id), 2, ring.empty() ? NULL : &ring[0], sizeof(Float) * 2, ring.size() / 2) == LIBTESS_OK);
+        CHECK(ValidScene(scene, rings, elementType, polySize));
+    }
+}
+
+/* Nested rings make one group, contours added after tesselate() join it
+ * or start groups of their own, and one contour is moved across the
+ * others, merging groups on the way and splitting them behind it.
+ */
+static void TestGroups(TessElementType elementType, int polySize)
+{
+    std::vector<Ring> rings;
+    TessScene scene;
+
+    for (int i = 0; i < 6; ++i) {
+        rings.push_back(StarRing(0, 0, 10 + 8 * i, i & 1 ? 0.8 : 1, 12 + 2 * i));
+        CHECK(scene.add_contour(2, &rings.back()[0], sizeof(Float) * 2, rings.back().size() / 2) == Index(i));
+    }
+    CHECK(scene.tesselate(TESS_WINDING_ODD, elementType, polySize) == LIBTESS_OK);
+    CHECK(ValidScene(scene, rings, elementType, polySize));
+
+    /* one inside the nest, three apart from it in a row */
+    rings.push_back(StarRing(3, 2, 4, 0.5, 10));
+    CHECK(scene.add_contour(2, &rings.back()[0], sizeof(Float) * 2, rings.back().size() / 2) == Index(rings.size() - 1));
+    CHECK(scene.sweptContours == 7);
+    CHECK(ValidScene(scene, rings, elementType, polySize));
+    for (int i = 0; i < 3; ++i) {
+        rings.push_back(StarRing(100 + 30 * i, 0, 10, 1, 8));
+        CHECK(scene.add_contour(2, &rings.back()[0], sizeof(Float) * 2, rings.back().size() / 2) == Index(rings.size() - 1));
+        CHECK(scene.sweptContours == 1);
+        CHECK(ValidScene(scene, rings, elementType, polySize));
+    }
+
+    /* a bar that slides over the row */
+    Ring bar;
+    rings.push_back(bar);
+    Index id = Index(rings.size() - 1);
+    CHECK(scene.add_contour(2, NULL, sizeof(Float) * 2, 0) == id);
+    for (int step = 0; step <= 16; ++step) {
+        Float x = Float(80 + 10 * step);
+        Float points[] = { x, -20, x + 12, -20, x + 12, 20, x, 20 };
+        rings[id].assign(points, points + 8);
+        CHECK(scene.update_contour(id, 2, points, sizeof(Float) * 2, 4) == LIBTESS_OK);
+        CHECK(ValidScene(scene, rings, elementType, polySize));
+    }
+}
+
+int main()
+{
+    TestGroups(TESS_TRIANGLES, 3);
+    TestGroups(TESS_TRIANGLE_STRIPS, 3);
+    TestGroups(TESS_POLYGONS, 5);
+    TestGroups(TESS_CONNECTED_POLYGONS, 4);
+
+    TestEdits(TESS_TRIANGLES, 3);
+    TestEdits(TESS_TRIANGLE_STRIPS, 3);
+    TestEdits(TESS_POLYGONS, 4);
+    TestEdits(TESS_CONNECTED_POLYGONS, 3);
+    TestEdits(TESS_CONNECTED_POLYGONS, 6);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/*
+
+ TessSink: the output written to caller memory, with 16 or 32-bit indices
+ and a padded vertex stride, is the output tesselate() puts in its vectors
+ otherwise, on every path: the sweep, the convex fan, ear clipping, split
+ components, the cache and the vertex cache reordering. An output left
+ empty by the winding rule is delivered too.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+class BufferSink : public TessSink
+{
+public:
+    std::vector<unsigned char> vertexBuffer;
+    std::vector<unsigned char> elementBuffer;
+    size_t vertexCount;
+    size_t elementCount;
+    int begins;
+    int ends;
+    bool fail;
+
+    BufferSink(size_t stride, size_t size) : vertexCount(0), elementCount(0), begins(0), ends(0), fail(false)
+    {
+        vertexStride = stride;
+        indexSize = size;
+    }
+
+    bool begin(size_t vertexCount, size_t elementCount)
+    {
+        ++begins;
+        this->vertexCount = vertexCount;
+        this->elementCount = elementCount;
+        vertexBuffer.assign(vertexCount * vertexStride + 1, 0xCD);
+        elementBuffer.assign(elementCount * indexSize + 1, 0xCD);
+        vertexData = &vertexBuffer[0];
+        elementData = &elementBuffer[0];
+        return !fail;
+    }
+
+    void end()
+    {
+        ++ends;
+    }
+
+    Vertex vertex(size_t i)const
+    {
+        Float coords[3] = { 0, 0, 0 };
+        memcpy(coords, &vertexBuffer[i * vertexStride], sizeof(Float) * (sizeof(Vertex) / sizeof(Float)));
+        Vertex v;
+        v.x = coords[0];
+        v.y = coords[1];
+        return v;
+    }
+
+    Index element(size_t i)const
+    {
+        if (indexSize == 2) {
+            uint16_t n;
+            memcpy(&n, &elementBuffer[i * 2], 2);
+            return n == 0xFFFF ? INVALID_INDEX : Index(n);
+        }
+        uint32_t n;
+        memcpy(&n, &elementBuffer[i * 4], 4);
+        return Index(n);
+    }
+};
+
+struct Options
+{
+    TessEngine engine;
+    bool splitComponents;
+    bool cache;
+    bool optimizeVertexCache;
+};
+
+static void TestSink(const Shape& shape, const Options& options, TessElementType elementType, int polySize, size_t indexSize)
+{
+    TessCache cache;
+    Tesselator vectors;
+    Tesselator sunk;
+    Tesselator* both[2] = { &vectors, &sunk };
+    BufferSink sink(sizeof(Vertex) + 12, indexSize);
+
+    for (int i = 0; i < 2; ++i) {
+        both[i]->engine = options.engine;
+        both[i]->splitComponents = options.splitComponents;
+        both[i]->optimizeVertexCache = options.optimizeVertexCache;
+    }
+    sunk.sink = &sink;
+    if (options.cache) {
+        sunk.cache = &cache;
+    }
+
+    AddShape(vectors, shape);
+    CHECK(vectors.tesselate(TESS_WINDING_ODD, elementType, polySize) == LIBTESS_OK);
+
+    /* twice with the cache, to deliver a miss and a hit */
+    for (int pass = 0; pass < (options.cache ? 2 : 1); ++pass) {
+        sunk.init();
+        AddShape(sunk, shape);
+        CHECK(sunk.tesselate(TESS_WINDING_ODD, elementType, polySize) == LIBTESS_OK);
+        CHECK(sunk.selectedEngine == vectors.selectedEngine);
+        CHECK(sunk.vertices.empty() && sunk.elements.empty());
+        CHECK(sink.begins == pass + 1 && sink.ends == pass + 1);
+        CHECK(sink.vertexCount == vectors.vertices.size());
+        CHECK(sink.elementCount == vectors.elements.size());
+        if (sink.vertexCount != vectors.vertices.size() || sink.elementCount != vectors.elements.size()) {
+            return;
+        }
+
+        size_t differ = 0;
+        for (size_t k = 0; k < sink.vertexCount; ++k) {
+            Vertex v = sink.vertex(k);
+            differ += v.x != vectors.vertices[k].x || v.y != vectors.vertices[k].y;
+        }
+        for (size_t k = 0; k < sink.elementCount; ++k) {
+            differ += sink.element(k) != vectors.elements[k];
+        }
+        CHECK(differ == 0);
+        CHECK(sink.vertexBuffer.back() == 0xCD && sink.elementBuffer.back() == 0xCD);
+    }
+}
+
+/* A sink that refuses the output fails tesselate() without end().
+ */
+static void TestRefused(const Shape& shape, TessEngine engine)
+{
+    Tesselator tess;
+    BufferSink sink(sizeof(Vertex), 4);
+
+    sink.fail = true;
+    tess.sink = &sink;
+    tess.engine = engine;
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(TESS_WINDING_ODD, TESS_TRIANGLES) == LIBTESS_ERROR);
+    CHECK(sink.begins == 1 && sink.ends == 0);
+}
+
+/* A contour the winding rule leaves outside still gives one begin() and
+ * one end(), of an empty output.
+ */
+static void TestOutside(TessEngine engine, TessElementType elementType)
+{
+    static const Float square[] = { 0, 0, 10, 0, 10, 10, 0, 10 };
+    Tesselator tess;
+    BufferSink sink(sizeof(Vertex), 4);
+
+    tess.sink = &sink;
+    tess.engine = engine;
+    tess.add_contour(2, square, sizeof(Float) * 2, 4);
+    CHECK(tess.tesselate(TESS_WINDING_POSITIVE, elementType) == LIBTESS_OK);
+    CHECK(sink.begins == 1 && sink.ends == 1);
+    CHECK(sink.vertexCount == 0 && sink.elementCount == 0);
+    if (engine != TESS_ENGINE_SWEEP) {
+        CHECK(tess.selectedEngine == TESS_ENGINE_CONVEX);
+    }
+}
+
+int main()
+{
+    static const Options options[] = {
+        { TESS_ENGINE_SWEEP, false, false, false },
+        { TESS_ENGINE_AUTO, false, false, false },
+        { TESS_ENGINE_SWEEP, true, false, false },
+        { TESS_ENGINE_SWEEP, false, true, false },
+        { TESS_ENGINE_AUTO, false, false, true },
+    };
+    std::vector<Shape> shapes = TestShapes(41, 9);
+    Shape scattered;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        scattered.insert(scattered.end(), shapes[i].begin(), shapes[i].end());
+    }
+    shapes.push_back(scattered);
+
+    for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o) {
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            for (size_t indexSize = 2; indexSize <= 4; indexSize += 2) {
+                TestSink(shapes[i], options[o], TESS_TRIANGLES, 3, indexSize);
+                TestSink(shapes[i], options[o], TESS_TRIANGLE_STRIPS, 3, indexSize);
+                TestSink(shapes[i], options[o], TESS_POLYGONS, 5, indexSize);
+                TestSink(shapes[i], options[o], TESS_CONNECTED_POLYGONS, 4, indexSize);
+            }
+        }
+    }
+
+    Shape earcut(1, StarRing(0, 0, 10, 1, 12));
+    earcut.push_back(StarRing(0, 0, 2, 1, 4));
+    TestRefused(shapes[0], TESS_ENGINE_SWEEP);
+    TestRefused(shapes[0], TESS_ENGINE_AUTO);
+    TestRefused(earcut, TESS_ENGINE_EARCUT);
+
+    TestOutside(TESS_ENGINE_SWEEP, TESS_TRIANGLES);
+    TestOutside(TESS_ENGINE_AUTO, TESS_TRIANGLES);
+    TestOutside(TESS_ENGINE_AUTO, TESS_TRIANGLE_STRIPS);
+    TestOutside(TESS_ENGINE_CONVEX, TESS_TRIANGLES);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/*
+
+ TessBatch::tesselate_slabs(): the slabs together cover the area of a
+ single sweep, and are stitched without cracks or T-junctions: every edge
+ is shared by at most two triangles, and the edges of one triangle only
+ make the same outline as the single sweep.
+
+*/
+#include "check.hpp"
+#include "../tesselator/batch.hpp"
+
+#include <map>
+
+using namespace test;
+
+/* The length of the edges that belong to one triangle only. A crack or a
+ * T-junction on a cut adds its edges there.
+ */
+template<typename Vertices>
+static double OutlineLength(const Vertices& vertices, const std::vector<Triangle>& triangles, bool& manifold)
+{
+    std::map<std::pair<Index, Index>, int> uses;
+    double length = 0;
+
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        Index v[3] = { triangles[i].a, triangles[i].b, triangles[i].c };
+        for (int k = 0; k < 3; ++k) {
+            Index a = v[k], b = v[(k + 1) % 3];
+            ++uses[std::make_pair(std::min(a, b), std::max(a, b))];
+        }
+    }
+    manifold = true;
+    for (std::map<std::pair<Index, Index>, int>::const_iterator it = uses.begin(); it != uses.end(); ++it) {
+        manifold = manifold && it->second <= 2;
+        if (it->second == 1) {
+            double dx = double(vertices[it->first.first].x) - vertices[it->first.second].x;
+            double dy = double(vertices[it->first.first].y) - vertices[it->first.second].y;
+            length += sqrt(dx * dx + dy * dy);
+        }
+    }
+    return length;
+}
+
+static void TestSlabs(const Shape& shape, TessWindingRule windingRule)
+{
+    std::vector<TessContour> contours;
+    std::vector<Triangle> triangles;
+    size_t flipped;
+    bool manifold;
+
+    for (size_t c = 0; c < shape.size(); ++c) {
+        TessContour contour = { 2, &shape[c][0], sizeof(Float) * 2, shape[c].size() / 2 };
+        contours.push_back(contour);
+    }
+
+    Tesselator tess;
+    tess.engine = TESS_ENGINE_SWEEP;
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(windingRule, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(Triangles(&tess.elements[0], tess.elements.size(), tess.vertices.size(), TESS_TRIANGLES, 3, triangles));
+    double area2 = Coverage(tess.vertices, triangles, flipped);
+    double outline = OutlineLength(tess.vertices, triangles, manifold);
+
+    TessBatch batch(3);
+    for (size_t slabCount = 1; slabCount <= 4; ++slabCount) {
+        CHECK(batch.tesselate_slabs(&contours[0], contours.size(), windingRule, slabCount) == LIBTESS_OK);
+        CHECK(batch.ranges.size() == slabCount);
+        CHECK(ValidOutput(batch.vertices, &batch.elements[0], batch.elements.size(), TESS_TRIANGLES, 3, area2));
+
+        Triangles(&batch.elements[0], batch.elements.size(), batch.vertices.size(), TESS_TRIANGLES, 3, triangles);
+        CHECK(Near(OutlineLength(batch.vertices, triangles, manifold), outline));
+        CHECK(manifold);
+    }
+}
+
+int main()
+{
+    Random random(21);
+    Shape star(1, StarRing(0, 0, 100, 0.4, 200));
+    Shape holed = star;
+    holed.push_back(StarRing(0, 0, 20, 0.5, 30));
+    holed.push_back(StarRing(10, 5, 8, 1, 9));
+
+    TestSlabs(star, TESS_WINDING_ODD);
+    TestSlabs(holed, TESS_WINDING_ODD);
+    TestSlabs(holed, TESS_WINDING_NONZERO);
+    TestSlabs(holed, TESS_WINDING_ABS_GEQ_TWO);
+    TestSlabs(Shape(1, RandomRing(random, 0, 0, 100, 60)), TESS_WINDING_ODD);
+    TestSlabs(Shape(1, RandomRing(random, 0, 0, 100, 60)), TESS_WINDING_POSITIVE);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+/*
+
+ TESS_TRIANGLE_STRIPS: the strips, restarts included, decode to the
+ triangles of TESS_TRIANGLES with the same orientation when the sweep is
+ asked for, and to the same area under TESS_ENGINE_AUTO. They take at most four elements per triangle, and fewer
+ elements than TESS_TRIANGLES for large outputs.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+static void TestStrips(const Shape& shape, TessWindingRule windingRule, TessEngine engine, bool processCDT)
+{
+    Tesselator tess;
+    std::vector<Triangle> triangles;
+
+    tess.engine = engine;
+    tess.processCDT = processCDT;
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(windingRule, TESS_TRIANGLES) == LIBTESS_OK);
+    TessEngine triangleEngine = tess.selectedEngine;
+    Triangles(tess.elements.empty() ? NULL : &tess.elements[0], tess.elements.size(), tess.vertices.size(), TESS_TRIANGLES, 3, triangles);
+    std::vector<TriangleKey> expected = TriangleKeys(tess.vertices, triangles);
+    double area2 = ShapeArea2(shape, windingRule);
+    size_t triangleElements = tess.elements.size();
+
+    tess.init();
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(windingRule, TESS_TRIANGLE_STRIPS) == LIBTESS_OK);
+    CHECK(ValidOutput(tess.vertices, tess.elements.empty() ? NULL : &tess.elements[0],
+        tess.elements.size(), TESS_TRIANGLE_STRIPS, 3, area2));
+
+    /* a lone triangle takes a restart too, long strips pay that back */
+    CHECK(tess.elements.size() <= triangleElements / 3 * 4);
+    if (triangleElements > 300) {
+        CHECK(tess.elements.size() < triangleElements);
+    }
+
+    if (engine == TESS_ENGINE_SWEEP) {
+        CHECK(triangleEngine == TESS_ENGINE_SWEEP);
+        CHECK(tess.selectedEngine == TESS_ENGINE_SWEEP);
+        Triangles(tess.elements.empty() ? NULL : &tess.elements[0], tess.elements.size(), tess.vertices.size(), TESS_TRIANGLE_STRIPS, 3, triangles);
+        CHECK(TriangleKeys(tess.vertices, triangles) == expected);
+    }
+}
+
+int main()
+{
+    static const TessWindingRule rules[] = { TESS_WINDING_ODD, TESS_WINDING_NONZERO, TESS_WINDING_ABS_GEQ_TWO };
+    std::vector<Shape> shapes = TestShapes(47, 36);
+    Shape all;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all.insert(all.end(), shapes[i].begin(), shapes[i].end());
+    }
+    shapes.push_back(all);
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (int r = 0; r < 3; ++r) {
+            TestStrips(shapes[i], rules[r], TESS_ENGINE_SWEEP, false);
+            TestStrips(shapes[i], rules[r], TESS_ENGINE_SWEEP, true);
+            TestStrips(shapes[i], rules[r], TESS_ENGINE_AUTO, false);
+        }
+    }
+    return failures ? 1 : 0;
+}
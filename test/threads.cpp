@@ -0,0 +1,54 @@
+/*
+
+ Tesselator::threadCount: the monotone regions triangulated on several
+ threads give the same vertices and elements, bit for bit, as on one
+ thread. The parallel path is taken for every mesh here.
+
+*/
+#define LIBTESS_USE_THREADS
+#define LIBTESS_PARALLEL_FACES_MIN 1
+
+#include "check.hpp"
+
+using namespace test;
+
+static void TestThreads(const Shape& shape, TessWindingRule windingRule, TessElementType elementType, int polySize, bool processCDT)
+{
+    Tesselator serial;
+    Tesselator parallel;
+
+    serial.threadCount = 1;
+    parallel.threadCount = 4;
+    serial.processCDT = parallel.processCDT = processCDT;
+    AddShape(serial, shape);
+    AddShape(parallel, shape);
+    CHECK(serial.tesselate(windingRule, elementType, polySize) == LIBTESS_OK);
+    CHECK(parallel.tesselate(windingRule, elementType, polySize) == LIBTESS_OK);
+
+    CHECK(parallel.elements.size() == serial.elements.size()
+        && std::equal(serial.elements.begin(), serial.elements.end(), parallel.elements.begin()));
+    CHECK(parallel.vertices.size() == serial.vertices.size()
+        && (serial.vertices.empty() || memcmp(&serial.vertices[0], &parallel.vertices[0],
+            serial.vertices.size() * sizeof(serial.vertices[0])) == 0));
+}
+
+int main()
+{
+    static const TessWindingRule rules[] = { TESS_WINDING_ODD, TESS_WINDING_NONZERO, TESS_WINDING_ABS_GEQ_TWO };
+    std::vector<Shape> shapes = TestShapes(29, 30);
+    Shape all;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all.insert(all.end(), shapes[i].begin(), shapes[i].end());
+    }
+    shapes.push_back(all);
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (int r = 0; r < 3; ++r) {
+            TestThreads(shapes[i], rules[r], TESS_TRIANGLES, 3, false);
+            TestThreads(shapes[i], rules[r], TESS_TRIANGLES, 3, true);
+            TestThreads(shapes[i], rules[r], TESS_TRIANGLE_STRIPS, 3, false);
+            TestThreads(shapes[i], rules[r], TESS_POLYGONS, 5, false);
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+/*
+
+ Tesselator::optimizeVertexCache: the reordered output has the triangles
+ of the plain one with their orientation, numbers the vertices in the
+ order of first use, and does not raise the cache miss ratio, on its own,
+ through a sink and with 16-bit draw ranges.
+
+*/
+#include "check.hpp"
+
+using namespace test;
+
+static void TestOrder(const Shape& shape, bool processCDT)
+{
+    Tesselator plain;
+    Tesselator tipsy;
+    std::vector<Triangle> triangles;
+
+    plain.processCDT = tipsy.processCDT = processCDT;
+    tipsy.optimizeVertexCache = true;
+    AddShape(plain, shape);
+    AddShape(tipsy, shape);
+    CHECK(plain.tesselate(TESS_WINDING_NONZERO, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(tipsy.tesselate(TESS_WINDING_NONZERO, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(plain.acmrBefore == 0 && plain.acmrAfter == 0);
+
+    Triangles(&plain.elements[0], plain.elements.size(), plain.vertices.size(), TESS_TRIANGLES, 3, triangles);
+    std::vector<TriangleKey> expected = TriangleKeys(plain.vertices, triangles);
+    CHECK(Triangles(&tipsy.elements[0], tipsy.elements.size(), tipsy.vertices.size(), TESS_TRIANGLES, 3, triangles));
+    CHECK(TriangleKeys(tipsy.vertices, triangles) == expected);
+    CHECK(tipsy.vertices.size() == plain.vertices.size());
+    CHECK(tipsy.indices.size() == tipsy.vertices.size());
+
+    /* every vertex keeps its input index */
+    std::vector<Index> used(plain.indices.begin(), plain.indices.end());
+    std::vector<Index> moved(tipsy.indices.begin(), tipsy.indices.end());
+    std::sort(used.begin(), used.end());
+    std::sort(moved.begin(), moved.end());
+    CHECK(used == moved);
+
+    Index next = 0;
+    size_t late = 0;
+    for (size_t i = 0; i < tipsy.elements.size(); ++i) {
+        if (tipsy.elements[i] == next) {
+            ++next;
+        }
+        late += tipsy.elements[i] > next;
+    }
+    CHECK(late == 0 && size_t(next) == tipsy.vertices.size());
+
+    CHECK(tipsy.acmrBefore > 0 && tipsy.acmrAfter > 0);
+    CHECK(tipsy.acmrAfter <= tipsy.acmrBefore);
+}
+
+/* With shortIndices and a sink the reordered output is still valid.
+ */
+class VectorSink : public TessSink
+{
+public:
+    std::vector<Vertex> vertices;
+    std::vector<Index> elements;
+
+    bool begin(size_t vertexCount, size_t elementCount)
+    {
+        vertices.resize(vertexCount);
+        elements.resize(elementCount);
+        vertexData = vertices.empty() ? NULL : &vertices[0];
+        vertexStride = sizeof(Vertex);
+        elementData = elements.empty() ? NULL : &elements[0];
+        indexSize = sizeof(Index);
+        return true;
+    }
+};
+
+static void TestOutputs(const Shape& shape)
+{
+    double area2 = ShapeArea2(shape, TESS_WINDING_NONZERO);
+    Tesselator tess;
+    VectorSink sink;
+
+    tess.optimizeVertexCache = true;
+    tess.sink = &sink;
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(TESS_WINDING_NONZERO, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(ValidOutput(sink.vertices, sink.elements.empty() ? NULL : &sink.elements[0], sink.elements.size(), TESS_TRIANGLES, 3, area2));
+
+    tess.sink = NULL;
+    tess.shortIndices = true;
+    tess.init();
+    AddShape(tess, shape);
+    CHECK(tess.tesselate(TESS_WINDING_NONZERO, TESS_TRIANGLES) == LIBTESS_OK);
+    CHECK(tess.drawRanges.size() == 1);
+    std::vector<Index> elements(tess.shortElements.begin(), tess.shortElements.end());
+    CHECK(ValidOutput(tess.vertices, elements.empty() ? NULL : &elements[0], elements.size(), TESS_TRIANGLES, 3, area2));
+}
+
+int main()
+{
+    std::vector<Shape> shapes = TestShapes(59, 24);
+    Shape all;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all.insert(all.end(), shapes[i].begin(), shapes[i].end());
+    }
+    Shape big(1, StarRing(0, 0, 100, 0.7, 2000));
+    big.push_back(StarRing(0, 0, 30, 0.5, 500));
+
+    TestOrder(all, false);
+    TestOrder(all, true);
+    TestOrder(big, false);
+    TestOrder(big, true);
+    TestOutputs(all);
+    TestOutputs(big);
+    return failures ? 1 : 0;
+}